@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Terrain.hpp"
+#include "ValidationTest.hpp"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+namespace bench
+{
+/**
+ * @brief Côtés de grille balayés par défaut
+ */
+const std::vector<int64_t> &gridSizes();
+
+/**
+ * @brief Nombres de threads balayés : puissances de 2 jusqu'au nombre de coeurs
+ */
+const std::vector<int64_t> &threadCounts();
+
+/**
+ * @brief Terrain Perlin de côté size, généré une seule fois par taille
+ *
+ * La graine est fixe : deux commits mesurent la même grille.
+ */
+Terrain &perlinTerrain(int size);
+
+/**
+ * @brief Fixe le nombre de threads OpenMP du benchmark courant
+ */
+void setThreads(int threads);
+
+/**
+ * @brief Trafic mémoire nominal d'un pas, en octets par cellule
+ *
+ * Lectures et écritures de grilles complètes (copies, noyau, tampons par
+ * thread et réduction), hors réutilisation en cache. Sert à convertir le
+ * débit en Go/s : seuls les écarts entre variantes et entre commits ont
+ * un sens.
+ */
+double bytesPerCell(ValidationTest::ThermalVariant variant, int threads);
+
+/**
+ * @brief Publie cells/s et Go/s pour cells cellules traitées par itération
+ */
+void reportThroughput(benchmark::State &state, double cells, double bytesPerCell);
+} // namespace bench
@@ -0,0 +1,159 @@
+#include "bench-common.hpp"
+#include "ThermalErosion.hpp"
+
+#include <algorithm>
+
+namespace
+{
+using Variant = ValidationTest::ThermalVariant;
+
+void thermalArgs(benchmark::internal::Benchmark *b, bool fourNeighborsOnly, bool parallel)
+{
+    b->ArgNames({"size", "threads", "neighbors"});
+
+    // Les variantes séquentielles ne sont mesurées qu'avec un thread
+    const std::vector<int64_t> threadCounts = parallel ? bench::threadCounts() : std::vector<int64_t>{1};
+
+    for (int64_t size : bench::gridSizes())
+        for (int64_t threads : threadCounts)
+        {
+            b->Args({size, threads, 4});
+            if (!fourNeighborsOnly)
+                b->Args({size, threads, 8});
+        }
+
+    b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+void serialArgs(benchmark::internal::Benchmark *b)
+{
+    thermalArgs(b, false, false);
+}
+
+void parallelArgs(benchmark::internal::Benchmark *b)
+{
+    thermalArgs(b, false, true);
+}
+
+// Les damiers ne sont valides qu'en 4 voisins
+void serialCheckerboardArgs(benchmark::internal::Benchmark *b)
+{
+    thermalArgs(b, true, false);
+}
+
+void parallelCheckerboardArgs(benchmark::internal::Benchmark *b)
+{
+    thermalArgs(b, true, true);
+}
+
+void configure(ThermalErosion &erosion, std::vector<float> &data, int size, int neighbors)
+{
+    erosion.loadGrid(&data, size, size);
+    erosion.setTalusAngle(25.f);
+    erosion.setTransferRate(0.1f);
+
+    if (neighbors == 4)
+        erosion.useFourNeighbors();
+    else
+        erosion.useEightNeighbors();
+}
+
+/**
+ * Un pas complet d'une variante, toujours depuis le terrain d'origine :
+ * la grille est restaurée hors chronométrage avant chaque pas.
+ */
+void BM_ThermalStep(benchmark::State &state, Variant variant)
+{
+    const int size = static_cast<int>(state.range(0));
+    const int threads = static_cast<int>(state.range(1));
+    const int neighbors = static_cast<int>(state.range(2));
+
+    const std::vector<float> &reference = *bench::perlinTerrain(size).getData();
+    std::vector<float> data = reference;
+
+    bench::setThreads(threads);
+
+    ThermalErosion erosion;
+    configure(erosion, data, size, neighbors);
+
+    int changes = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::copy(reference.begin(), reference.end(), data.begin());
+        state.ResumeTiming();
+
+        changes = ValidationTest::run_one_step(erosion, variant);
+        benchmark::DoNotOptimize(changes);
+    }
+
+    const double innerCells = static_cast<double>(size - 2) * (size - 2);
+    bench::reportThroughput(state, innerCells, bench::bytesPerCell(variant, threads));
+    state.counters["cells_modified"] = changes;
+}
+
+/**
+ * Débit de erodeCell seul : une itération complète par blocs de 8000
+ * cellules (stepChunk), comme la boucle interactive de TerrainApp.
+ */
+void BM_ErodeCell(benchmark::State &state)
+{
+    const int size = static_cast<int>(state.range(0));
+    const int neighbors = static_cast<int>(state.range(1));
+
+    const std::vector<float> &reference = *bench::perlinTerrain(size).getData();
+    std::vector<float> data = reference;
+
+    // stepChunk est séquentiel ; fixé ici pour ne pas hériter du nombre de
+    // threads laissé par le benchmark précédent
+    bench::setThreads(1);
+
+    ThermalErosion erosion;
+    configure(erosion, data, size, neighbors);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::copy(reference.begin(), reference.end(), data.begin());
+        erosion.resetProgress();
+        state.ResumeTiming();
+
+        int changes = 0;
+        while (!erosion.isIterationFinished())
+            changes += erosion.stepChunk(8000);
+        benchmark::DoNotOptimize(changes);
+    }
+
+    // Copie vers la grille de travail, noyau, recopie en fin d'itération
+    const double innerCells = static_cast<double>(size - 2) * (size - 2);
+    bench::reportThroughput(state, innerCells, 4.0 * (2 + 1 + 2 + 2));
+}
+
+void erodeCellArgs(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"size", "neighbors"});
+
+    for (int64_t size : bench::gridSizes())
+    {
+        b->Args({size, 4});
+        b->Args({size, 8});
+    }
+
+    b->Unit(benchmark::kMillisecond);
+}
+} // namespace
+
+BENCHMARK(BM_ErodeCell)->Apply(erodeCellArgs);
+
+BENCHMARK_CAPTURE(BM_ThermalStep, pureTwoPhase, Variant::PureTwoPhase)->Apply(serialArgs);
+BENCHMARK_CAPTURE(BM_ThermalStep, blockedPureTwoPhase, Variant::BlockedPureTwoPhase)->Apply(serialArgs);
+BENCHMARK_CAPTURE(BM_ThermalStep, blockedParallelPureTwoPhase, Variant::BlockedParallelPureTwoPhase)
+    ->Apply(parallelArgs);
+BENCHMARK_CAPTURE(BM_ThermalStep, checkerboardPureTwoPhase, Variant::CheckerboardPureTwoPhase)
+    ->Apply(serialCheckerboardArgs);
+BENCHMARK_CAPTURE(BM_ThermalStep, blockedCheckerboardPureTwoPhase, Variant::BlockedCheckerboardPureTwoPhase)
+    ->Apply(serialCheckerboardArgs);
+BENCHMARK_CAPTURE(BM_ThermalStep, checkerboardInPlace, Variant::CheckerboardInPlace)
+    ->Apply(serialCheckerboardArgs);
+BENCHMARK_CAPTURE(BM_ThermalStep, checkerboardInPlaceParallel, Variant::CheckerboardInPlaceParallel)
+    ->Apply(parallelCheckerboardArgs);
@@ -0,0 +1,107 @@
+#include "bench-common.hpp"
+#include "NumaPlacement.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <unistd.h>
+
+namespace
+{
+enum Placement
+{
+    MainThread, // pages écrites par le thread principal, laissées en place
+    FirstTouch,
+    Interleave
+};
+
+void placementArgs(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"size", "placement"});
+
+    // Toujours avec tous les coeurs : c'est le cas où un seul socket sature
+    for (int64_t size : bench::gridSizes())
+        for (int64_t placement : {MainThread, FirstTouch, Interleave})
+            b->Args({size, placement});
+
+    b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+/**
+ * Grille alignée sur la page : place() déplace toutes ses pages, sans
+ * toucher aux allocations voisines.
+ */
+struct PageAlignedGrid
+{
+    std::unique_ptr<float, decltype(&std::free)> cells{nullptr, &std::free};
+    std::size_t count = 0;
+
+    explicit PageAlignedGrid(const std::vector<float> &values)
+    {
+        const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const std::size_t bytes = (values.size() * sizeof(float) + pageSize - 1) / pageSize * pageSize;
+
+        cells.reset(static_cast<float *>(std::aligned_alloc(pageSize, bytes)));
+        count = values.size();
+        std::copy(values.begin(), values.end(), cells.get());
+    }
+
+    float *data() const { return cells.get(); }
+};
+
+void placeGrid(PageAlignedGrid &grid, Placement placement)
+{
+    if (placement == MainThread)
+        return;
+
+    const NumaPlacement::Policy previous = NumaPlacement::getPolicy();
+    NumaPlacement::setPolicy(placement == Interleave ? NumaPlacement::Policy::Interleave
+                                                     : NumaPlacement::Policy::FirstTouch);
+    NumaPlacement::place(grid.data(), grid.count * sizeof(float));
+    NumaPlacement::setPolicy(previous);
+}
+
+/**
+ * Balayage d'une grille en bandes de lignes (schedule(static)), comme les
+ * noyaux d'érosion : lecture d'un voisinage à 4 voisins, écriture dans une
+ * seconde grille.
+ */
+void BM_GridSweepPlacement(benchmark::State &state)
+{
+    const int size = static_cast<int>(state.range(0));
+    const Placement placement = static_cast<Placement>(state.range(1));
+
+    bench::setThreads(static_cast<int>(bench::threadCounts().back()));
+
+    const std::vector<float> &reference = *bench::perlinTerrain(size).getData();
+
+    // Les deux grilles sont écrites par le thread principal, comme mData
+    PageAlignedGrid src(reference);
+    PageAlignedGrid dst(std::vector<float>(reference.size(), 0.0f));
+    placeGrid(src, placement);
+    placeGrid(dst, placement);
+
+    for (auto _ : state)
+    {
+        #pragma omp parallel for schedule(static)
+        for (int i = 1; i < size - 1; ++i)
+        {
+            const float *row = src.data() + static_cast<std::size_t>(i) * size;
+            float *out = dst.data() + static_cast<std::size_t>(i) * size;
+
+            for (int j = 1; j < size - 1; ++j)
+                out[j] = 0.2f * (row[j] + row[j - 1] + row[j + 1] + row[j - size] + row[j + size]);
+        }
+
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+
+    const double innerCells = static_cast<double>(size - 2) * (size - 2);
+
+    bench::reportThroughput(state, innerCells, 2 * sizeof(float));
+    state.counters["numa_nodes"] = NumaPlacement::nodeCount();
+}
+} // namespace
+
+BENCHMARK(BM_GridSweepPlacement)->Apply(placementArgs);
@@ -0,0 +1,121 @@
+#define STB_IMAGE_IMPLEMENTATION
+
+#include "bench-common.hpp"
+#include "bench-git-commit.hpp"
+#include "PerlinNoiseTerrain.hpp"
+
+#include <map>
+#include <string>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace bench
+{
+const std::vector<int64_t> &gridSizes()
+{
+    static const std::vector<int64_t> sizes = {257, 1025, 2049};
+    return sizes;
+}
+
+const std::vector<int64_t> &threadCounts()
+{
+    static const std::vector<int64_t> counts = [] {
+#ifdef _OPENMP
+        const int procs = omp_get_num_procs();
+#else
+        const int procs = 1;
+#endif
+        std::vector<int64_t> values;
+        for (int t = 1; t < procs; t *= 2)
+            values.push_back(t);
+        values.push_back(procs);
+        return values;
+    }();
+    return counts;
+}
+
+Terrain &perlinTerrain(int size)
+{
+    static std::map<int, std::unique_ptr<PerlinNoiseTerrain>> cache;
+
+    std::unique_ptr<PerlinNoiseTerrain> &terrain = cache[size];
+    if (!terrain) {
+        terrain = std::make_unique<PerlinNoiseTerrain>();
+        terrain->setSeed(1);
+        terrain->CreatePerlinNoise(size, size, 0, 255, 1, 0.005f);
+    }
+
+    return *terrain;
+}
+
+void setThreads(int threads)
+{
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#else
+    (void)threads;
+#endif
+}
+
+double bytesPerCell(ValidationTest::ThermalVariant variant, int threads)
+{
+    using Variant = ValidationTest::ThermalVariant;
+
+    // Copie de la grille vers src et dst (lecture + écriture de chaque),
+    // puis lecture de src et lecture/écriture de dst par le noyau
+    const double twoPhase = 4.0 * (2 + 2 + 1 + 2);
+
+    switch (variant) {
+        case Variant::PureTwoPhase:
+        case Variant::BlockedPureTwoPhase:
+        case Variant::CheckerboardPureTwoPhase:
+        case Variant::BlockedCheckerboardPureTwoPhase:
+            return twoPhase;
+
+        case Variant::BlockedParallelPureTwoPhase:
+            // + un tampon de deltas par thread : mise à zéro, écriture, relecture
+            return twoPhase + 4.0 * 3 * threads;
+
+        case Variant::CheckerboardInPlace:
+            // Deux couleurs : lecture/écriture sur place
+            return 4.0 * 2 * 2;
+
+        case Variant::CheckerboardInPlaceParallel:
+            // Par couleur : grille lue/écrite et tampons par thread
+            return 2 * (4.0 * 2 + 4.0 * 3 * threads);
+    }
+
+    return twoPhase;
+}
+
+void reportThroughput(benchmark::State &state, double cells, double bytesPerCell)
+{
+    const double iterations = static_cast<double>(state.iterations());
+
+    state.counters["cells/s"] = benchmark::Counter(cells * iterations, benchmark::Counter::kIsRate);
+    state.SetBytesProcessed(static_cast<int64_t>(cells * bytesPerCell * iterations));
+}
+} // namespace bench
+
+/**
+ * @brief Point d'entrée : options de Google Benchmark, plus le contexte de
+ *        la machine et du commit ajouté à la sortie JSON
+ *
+ * ./erosion_bench --benchmark_format=json --benchmark_out=bench.json
+ */
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::AddCustomContext("git_commit", EROSION_BENCH_GIT_COMMIT);
+#ifdef _OPENMP
+    benchmark::AddCustomContext("omp_max_threads", std::to_string(omp_get_max_threads()));
+#endif
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,297 @@
+#include "bench-common.hpp"
+#include "FaultFormationTerrain.hpp"
+#include "HeightPyramid.hpp"
+#include "MidpointDisplacement.hpp"
+#include "Patch.hpp"
+#include "PerlinNoiseTerrain.hpp"
+#include "ThermalErosion.hpp"
+#include "test-heightfields.hpp"
+
+#include <cmath>
+#include <random>
+
+namespace
+{
+void generatorArgs(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"size", "threads"});
+
+    for (int64_t size : bench::gridSizes())
+        for (int64_t threads : bench::threadCounts())
+            b->Args({size, threads});
+
+    b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+void sizeArgs(benchmark::internal::Benchmark *b)
+{
+    b->ArgName("size");
+
+    for (int64_t size : bench::gridSizes())
+        b->Arg(size);
+}
+
+// Paramètres des générateurs de BatchRunner::createTerrain, à graine fixe
+
+void BM_PerlinNoise(benchmark::State &state)
+{
+    const int size = static_cast<int>(state.range(0));
+    bench::setThreads(static_cast<int>(state.range(1)));
+
+    for (auto _ : state)
+    {
+        PerlinNoiseTerrain terrain;
+        terrain.setSeed(1);
+        terrain.CreatePerlinNoise(size, size, 0, 255, 1, 0.005f);
+        benchmark::DoNotOptimize(terrain.getData()->data());
+    }
+
+    bench::reportThroughput(state, static_cast<double>(size) * size, sizeof(float));
+}
+
+void BM_FaultFormation(benchmark::State &state)
+{
+    const int size = static_cast<int>(state.range(0));
+    bench::setThreads(static_cast<int>(state.range(1)));
+
+    for (auto _ : state)
+    {
+        FaultFormationTerrain terrain;
+        terrain.setSeed(1);
+        terrain.CreateFaultFormation(size, size, 1000, 0, 255, 1);
+        benchmark::DoNotOptimize(terrain.getData()->data());
+    }
+
+    bench::reportThroughput(state, static_cast<double>(size) * size, sizeof(float));
+}
+
+void BM_MidpointDisplacement(benchmark::State &state)
+{
+    // Les tailles balayées sont déjà de la forme 2^n + 1
+    const int size = static_cast<int>(state.range(0));
+    bench::setThreads(static_cast<int>(state.range(1)));
+
+    for (auto _ : state)
+    {
+        MidpointDisplacement terrain;
+        terrain.setSeed(1);
+        terrain.CreateMidpointDisplacement(size, 0, 255, 1, 0.5);
+        benchmark::DoNotOptimize(terrain.getData()->data());
+    }
+
+    bench::reportThroughput(state, static_cast<double>(size) * size, sizeof(float));
+}
+
+/**
+ * Sommets et indices des 5 LOD de tous les patches, comme au chargement
+ * d'un terrain.
+ */
+void BM_PatchMeshing(benchmark::State &state)
+{
+    const int size = static_cast<int>(state.range(0));
+    bench::setThreads(static_cast<int>(state.range(1)));
+
+    Terrain &terrain = bench::perlinTerrain(size);
+    std::vector<float> &heights = *terrain.getData();
+    std::vector<std::unique_ptr<Patch>> &patches = terrain.getPatches();
+    const int count = static_cast<int>(patches.size());
+
+    // Même découpage que Terrain::setupTerrainLod, sans les buffers OpenGL
+    for (auto _ : state)
+    {
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < count; ++i)
+        {
+            patches[i]->generateLodVertices(heights, size, size);
+            patches[i]->generateLodIndices();
+        }
+    }
+
+    // Chaque cellule est lue une fois par LOD qui l'échantillonne ; le
+    // débit est rapporté aux cellules couvertes et aux sommets écrits (LOD 0)
+    const double cells = static_cast<double>(patches.size()) * PATCH_SIZE * PATCH_SIZE;
+    bench::reportThroughput(state, cells, sizeof(float) + sizeof(Vertex));
+    state.counters["patches/s"] = benchmark::Counter(static_cast<double>(patches.size()) * state.iterations(),
+                                                     benchmark::Counter::kIsRate);
+}
+
+/**
+ * Culling et choix du LOD de tous les patches pour une caméra au-dessus du
+ * coin du terrain, regardant vers son centre.
+ */
+void BM_FrustumCulling(benchmark::State &state)
+{
+    const int size = static_cast<int>(state.range(0));
+
+    Terrain &terrain = bench::perlinTerrain(size);
+    std::vector<std::unique_ptr<Patch>> &patches = terrain.getPatches();
+
+    const glm::vec3 cameraPos(0.f, 200.f, 0.f);
+    glm::mat4 projection = glm::perspective(glm::radians(45.f), 16.f / 9.f, 0.1f, 10000.f);
+    glm::mat4 view = glm::lookAt(cameraPos, glm::vec3(size * 0.5f, 0.f, size * 0.5f), glm::vec3(0.f, 1.f, 0.f));
+
+    Frustrum frustrum;
+    int visible = 0;
+
+    for (auto _ : state)
+    {
+        frustrum.updateFrustum(projection, view);
+
+        visible = 0;
+        for (std::unique_ptr<Patch> &patch : patches)
+        {
+            if (patch->chooseLod(cameraPos, &frustrum) >= 0)
+                ++visible;
+        }
+        benchmark::DoNotOptimize(visible);
+    }
+
+    state.counters["patches/s"] = benchmark::Counter(static_cast<double>(patches.size()) * state.iterations(),
+                                                     benchmark::Counter::kIsRate);
+    state.counters["visible"] = visible;
+}
+
+/**
+ * Un coup de pinceau comme dans TerrainApp : édition des hauteurs, détente
+ * thermique du disque et d'une marge de 8 cellules (8 passes au plus), puis
+ * sommets des patches concernés (sans l'envoi au GPU). Les coups alternent
+ * Elever et Abaisser au centre du terrain.
+ */
+void BM_BrushStroke(benchmark::State &state)
+{
+    const int size = static_cast<int>(state.range(0));
+    const float radius = static_cast<float>(state.range(1));
+    const int halo = 8;
+
+    // Grille propre au benchmark : le terrain partagé n'est pas modifié
+    PerlinNoiseTerrain terrain;
+    terrain.setSeed(1);
+    terrain.CreatePerlinNoise(size, size, 0, 255, 1, 0.005f);
+
+    ThermalErosion erosion;
+    erosion.loadGrid(terrain.getData(), size, size);
+    erosion.setTalusAngle(30.f);
+    erosion.setTransferRate(0.5f);
+
+    BrushStroke stroke;
+    stroke.centerX = size * 0.5f;
+    stroke.centerZ = size * 0.5f;
+    stroke.radius = radius;
+    stroke.strength = 4.f;
+
+    std::vector<std::unique_ptr<Patch>> &patches = terrain.getPatches();
+    std::size_t remeshed = 0;
+
+    for (auto _ : state)
+    {
+        stroke.mode = (stroke.mode == BrushMode::Raise) ? BrushMode::Lower : BrushMode::Raise;
+
+        const CellRect relaxed = terrain.applyBrush(stroke).expanded(halo, size, size);
+        erosion.relaxRegion(relaxed.zMin, relaxed.zMax, relaxed.xMin, relaxed.xMax, 8);
+
+        const std::vector<int> dirty = terrain.patchesInRect(relaxed.expanded(1, size, size));
+        for (int idx : dirty)
+            patches[idx]->generateLodVertices(*terrain.getData(), size, size);
+
+        remeshed = dirty.size();
+    }
+
+    state.counters["patches"] = static_cast<double>(remeshed);
+}
+
+void brushArgs(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"size", "radius"});
+
+    for (int64_t size : bench::gridSizes())
+        for (int64_t radius : {8, 64})
+            b->Args({size, radius});
+
+    b->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
+
+/**
+ * Grille brute de collines (sans patches ni textures) : la cible de 8193²
+ * cellules dépasse les tailles du Terrain partagé.
+ */
+std::vector<float> makePickGrid(int size)
+{
+    return testdata::makeWaves(size, size, {100.0f, 60.0f, 0.013f, 0.011f, 8.0f, 0.21f, 0.17f});
+}
+
+/**
+ * Picking depuis une caméra au-dessus d'un coin du terrain, vers des points
+ * tirés sur toute la grille : rayons rasants sur les cibles lointaines.
+ */
+void BM_TerrainPick(benchmark::State &state)
+{
+    const int size = static_cast<int>(state.range(0));
+    const std::vector<float> data = makePickGrid(size);
+
+    HeightPyramid pyramid;
+    pyramid.build(data.data(), size, size);
+
+    const int rayCount = 256;
+    std::vector<float> directions(rayCount * 3);
+    const float origin[3] = {-8.0f, 400.0f, -8.0f};
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> cell(0.0f, static_cast<float>(size - 1));
+    for (int r = 0; r < rayCount; ++r)
+    {
+        const float x = cell(rng);
+        const float z = cell(rng);
+        directions[r * 3 + 0] = x - origin[0];
+        directions[r * 3 + 1] = data[static_cast<std::size_t>(z) * size + static_cast<int>(x)] - origin[1];
+        directions[r * 3 + 2] = z - origin[2];
+    }
+
+    int hits = 0;
+    int r = 0;
+    for (auto _ : state)
+    {
+        float t = 0.0f;
+        hits += pyramid.raycast(data.data(), origin, &directions[r * 3], t);
+        benchmark::DoNotOptimize(t);
+        r = (r + 1) % rayCount;
+    }
+
+    state.counters["levels"] = pyramid.levelCount();
+    state.counters["hit%"] = 100.0 * hits / std::max<int64_t>(1, state.iterations());
+}
+
+/**
+ * Mise à jour de la pyramide après un pas d'érosion qui salit n patches
+ * (bande de patches au centre de la grille).
+ */
+void BM_PyramidTileUpdate(benchmark::State &state)
+{
+    const int size = static_cast<int>(state.range(0));
+    const int dirtyCount = static_cast<int>(state.range(1));
+    std::vector<float> data = makePickGrid(size);
+
+    HeightPyramid pyramid;
+    pyramid.build(data.data(), size, size);
+
+    const int tilesZ = size / PATCH_SIZE;
+    std::vector<int> dirty;
+    for (int k = 0; k < dirtyCount; ++k)
+        dirty.push_back((tilesZ / 2) * tilesZ + (tilesZ / 2 + k) % tilesZ);
+
+    for (auto _ : state)
+        pyramid.updateTiles(data.data(), dirty, PATCH_SIZE, tilesZ);
+
+    state.counters["patches/s"] = benchmark::Counter(static_cast<double>(dirtyCount) * state.iterations(),
+                                                     benchmark::Counter::kIsRate);
+}
+} // namespace
+
+BENCHMARK(BM_PerlinNoise)->Apply(generatorArgs);
+BENCHMARK(BM_FaultFormation)->Apply(generatorArgs);
+BENCHMARK(BM_MidpointDisplacement)->Apply(generatorArgs);
+BENCHMARK(BM_PatchMeshing)->Apply(generatorArgs);
+BENCHMARK(BM_FrustumCulling)->Apply(sizeArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BrushStroke)->Apply(brushArgs);
+BENCHMARK(BM_TerrainPick)->ArgName("size")->Arg(1025)->Arg(8193)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PyramidTileUpdate)->ArgNames({"size", "patches"})->Args({8193, 1})->Args({8193, 64})
+    ->Unit(benchmark::kMicrosecond);
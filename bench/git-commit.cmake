@@ -0,0 +1,16 @@
+# Écrit le commit courant dans OUTPUT (cmake -P, à chaque build).
+# configure_file ne réécrit le fichier que si le commit a changé : bench-runner.cpp
+# n'est recompilé qu'après un nouveau commit ou un checkout.
+execute_process(
+    COMMAND git rev-parse --short HEAD
+    WORKING_DIRECTORY ${SOURCE_DIR}
+    OUTPUT_VARIABLE EROSION_GIT_COMMIT
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+    ERROR_QUIET
+)
+
+if(NOT EROSION_GIT_COMMIT)
+    set(EROSION_GIT_COMMIT "unknown")
+endif()
+
+configure_file(${INPUT} ${OUTPUT} @ONLY)
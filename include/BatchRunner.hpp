@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Terrain.hpp"
+#include "ValidationTest.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Paramètres d'une simulation d'érosion sans interface graphique.
+ */
+struct BatchConfig
+{
+    std::string generator = "perlinNoise";           /**< Générateur (voir BatchRunner::createTerrain) */
+    std::string heightmap = "../src/heightmap/iceland_heightmap.png"; /**< Image pour loadHeightmap */
+    int size = 0;                                    /**< Côté du terrain, 0 pour la taille par défaut */
+    unsigned int seed = 1;                           /**< Graine du générateur */
+    int steps = 0;                                   /**< Nombre total de pas d'érosion */
+    ValidationTest::ThermalVariant variant = ValidationTest::ThermalVariant::BlockedParallelPureTwoPhase;
+    int neighborCount = 8;                           /**< Voisinage : 4 ou 8 */
+    float talusAngle = 25.f;                         /**< Angle de talus (degrés) */
+    float transferRate = 0.1f;                       /**< Taux de transfert */
+    int threads = 0;                                 /**< Threads OpenMP du job, 0 pour la valeur par défaut */
+    std::string outputDir;                           /**< Dossier de sortie du job, vide pour ne rien écrire */
+    std::string checkpointDir;                       /**< Dossier des checkpoints, vide pour désactiver */
+    int checkpointInterval = 100;                    /**< Pas entre deux checkpoints */
+    std::string label = "run";                       /**< Nom du job dans les journaux */
+    SnapshotMetadata metadata;                       /**< Générateur et graine, recopiés dans les checkpoints */
+};
+
+/**
+ * @brief Résultat d'une simulation.
+ */
+struct BatchResult
+{
+    bool ok = false;
+    uint64_t stepsRun = 0;
+    double generationMs = 0.0;
+    double totalMs = 0.0;
+    double massError = 0.0;
+    int lastChanges = 0;
+};
+
+/**
+ * @class BatchRunner
+ * @brief Boucle d'érosion pour les longues simulations en ligne de commande
+ *
+ * Les checkpoints sont écrits en arrière-plan par un ErosionCheckpointer ;
+ * si le dossier contient déjà un checkpoint compatible, la simulation
+ * reprend à son pas avec les paramètres d'érosion qu'il contient.
+ *
+ * Un balayage de paramètres est décrit par des listes de valeurs séparées
+ * par des virgules ; chaque combinaison devient un job. Les jobs tournent
+ * en parallèle (niveau externe OpenMP) et chacun dispose de sa propre
+ * équipe de threads pour les noyaux d'érosion (niveau imbriqué).
+ */
+class BatchRunner
+{
+  public:
+    /**
+     * @brief Lit les options de la commande run
+     *
+     * Les options sont de la forme --clé valeur ; --config fichier charge
+     * des lignes clé = valeur, que les options suivantes peuvent surcharger.
+     *
+     * @param args Arguments après le mot-clé run
+     * @param jobs Configurations, une par combinaison du balayage
+     * @param concurrentJobs Nombre de jobs simultanés
+     * @return false si une option est invalide
+     */
+    static bool parseArguments(const std::vector<std::string> &args, std::vector<BatchConfig> &jobs,
+                               int &concurrentJobs);
+
+    /**
+     * @brief Affiche les options reconnues par parseArguments
+     */
+    static void printUsage(const char *program);
+
+    /**
+     * @brief Crée un terrain avec un générateur
+     * @param generator loadHeightmap | faultFormation | midpointDisplacement | perlinNoise
+     * @param size Côté du terrain, 0 pour la taille par défaut du générateur
+     * @param seed Graine du générateur (CounterRng)
+     * @param heightmap Image lue par loadHeightmap
+     * @return nullptr si le générateur est inconnu
+     */
+    static std::unique_ptr<Terrain> createTerrain(const std::string &generator, int size = 0, uint32_t seed = 1,
+                                                  const std::string &heightmap = "../src/heightmap/iceland_heightmap.png");
+
+    /**
+     * @brief Exécute la simulation sur le terrain donné
+     */
+    static BatchResult run(std::unique_ptr<Terrain> &terrain, BatchConfig config);
+
+    /**
+     * @brief Génère le terrain puis exécute la simulation d'un job
+     */
+    static BatchResult runJob(const BatchConfig &config);
+
+    /**
+     * @brief Exécute tous les jobs en partageant les cœurs
+     * @param jobs Configurations à exécuter
+     * @param concurrentJobs Nombre de jobs simultanés
+     * @return true si tous les jobs ont réussi
+     *
+     * Si un dossier de sortie est donné, summary.csv y récapitule les jobs.
+     */
+    static bool runAll(const std::vector<BatchConfig> &jobs, int concurrentJobs);
+};
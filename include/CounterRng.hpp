@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @class CounterRng
+ * @brief Générateur pseudo-aléatoire sans état, indexé par compteur
+ *
+ * Chaque tirage est une fonction pure de (graine, flux, compteur) : on
+ * applique le mélangeur de SplitMix64 à la position « compteur » du flux.
+ * Aucun état n'est partagé entre threads, le résultat ne dépend donc ni
+ * de l'ordre des appels ni du nombre de threads. Le flux sépare les usages
+ * (générateur, itération, niveau) et le compteur identifie la cellule ou
+ * le tirage dans ce flux.
+ */
+class CounterRng
+{
+  public:
+    /**
+     * @brief Flux réservés par les générateurs
+     *
+     * Le flux effectif d'un tirage est stream(usage, sous-flux), par
+     * exemple stream(FaultLines, itération).
+     */
+    enum Usage : uint32_t
+    {
+        FaultLines = 1,        /**< Extrémités des failles, par itération */
+        MidpointOffsets = 2,   /**< Déplacements du midpoint, par niveau */
+        PerlinPermutation = 3, /**< Mélange de la table de permutation */
+        HydraulicDrops = 4     /**< Positions de départ des gouttes */
+    };
+
+    /**
+     * @brief Finaliseur de SplitMix64 (bijection 64 bits)
+     */
+    static inline uint64_t mix(uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * @brief Identifiant de flux pour un usage et un sous-flux
+     */
+    static inline uint64_t stream(Usage usage, uint64_t subStream)
+    {
+        return (static_cast<uint64_t>(usage) << 48) ^ subStream;
+    }
+
+    /**
+     * @brief Tirage brut de 64 bits
+     * @param seed Graine de la simulation
+     * @param streamId Flux (voir stream())
+     * @param counter Position dans le flux (cellule, numéro de tirage...)
+     */
+    static inline uint64_t next(uint64_t seed, uint64_t streamId, uint64_t counter)
+    {
+        const uint64_t key = mix(seed + kGamma * (streamId + 1));
+        return mix(key + kGamma * (counter + 1));
+    }
+
+    /**
+     * @brief Flottant uniforme dans [0, 1)
+     */
+    static inline float uniform(uint64_t seed, uint64_t streamId, uint64_t counter)
+    {
+        return static_cast<float>(next(seed, streamId, counter) >> 40) * (1.0f / 16777216.0f);
+    }
+
+    /**
+     * @brief Flottant uniforme dans [a, b)
+     */
+    static inline float uniform(uint64_t seed, uint64_t streamId, uint64_t counter, float a, float b)
+    {
+        return a + (b - a) * uniform(seed, streamId, counter);
+    }
+
+    /**
+     * @brief Entier uniforme dans [0, n)
+     */
+    static inline uint32_t below(uint64_t seed, uint64_t streamId, uint64_t counter, uint32_t n)
+    {
+        return static_cast<uint32_t>(((next(seed, streamId, counter) >> 32) * n) >> 32);
+    }
+
+  private:
+    static constexpr uint64_t kGamma = 0x9E3779B97F4A7C15ull; /**< Incrément de SplitMix64 */
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @class DirtyTileSet
+ * @brief Ensemble de tuiles modifiées, marquable sans verrou depuis plusieurs threads
+ *
+ * La grille est découpée en tuiles carrées (les patches du terrain), numérotées
+ * tuileX * tuilesZ + tuileZ comme Terrain::mPatches : width / tileSize tuiles
+ * par ligne, les cellules au-delà de la dernière tuile complète comptant dans
+ * la dernière (le patch p lit les cellules [p * tileSize, (p + 1) * tileSize]).
+ * Chaque tuile est un bit
+ * d'un mot atomique de 64 bits : marquer une tuile est un fetch_or relâché,
+ * précédé d'une simple lecture pour ne pas écrire sur une ligne de cache
+ * partagée quand le bit est déjà posé.
+ *
+ * Les noyaux d'érosion accumulent les cellules modifiées d'un bloc (ou d'une
+ * ligne) dans un CellBounds et marquent ses tuiles une seule fois, à la fin
+ * du bloc. collect(), appelé hors région parallèle, parcourt les mots non nuls
+ * et ajoute à la liste les tuiles marquées depuis l'appel précédent.
+ */
+class DirtyTileSet
+{
+  public:
+    /**
+     * @brief Rectangle englobant des cellules modifiées, bornes incluses
+     */
+    struct CellBounds
+    {
+        int iMin = INT_MAX;
+        int iMax = INT_MIN;
+        int jMin = INT_MAX;
+        int jMax = INT_MIN;
+
+        void add(int i, int j)
+        {
+            iMin = std::min(iMin, i);
+            iMax = std::max(iMax, i);
+            jMin = std::min(jMin, j);
+            jMax = std::max(jMax, j);
+        }
+
+        bool empty() const { return iMin > iMax; }
+    };
+
+    /**
+     * @brief Dimensionne l'ensemble pour une grille width x height (toutes les tuiles propres)
+     */
+    void resize(int width, int height, int tileSize);
+
+    int tileCount() const { return mTilesX * mTilesZ; }
+
+    void markTile(int tile)
+    {
+        std::atomic<uint64_t> &word = mWords[static_cast<std::size_t>(tile) >> 6];
+        const uint64_t bit = uint64_t(1) << (tile & 63);
+
+        if (!(word.load(std::memory_order_relaxed) & bit))
+            word.fetch_or(bit, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Marque les tuiles qui lisent le rectangle [iMin, iMax] x [jMin, jMax], borné à la grille
+     *
+     * Une ligne (ou colonne) multiple de tileSize appartient aux deux tuiles
+     * qu'elle sépare.
+     */
+    void markCells(int iMin, int iMax, int jMin, int jMax);
+
+    /**
+     * @brief Marque les tuiles des cellules modifiées et de leurs voisins (une cellule de halo)
+     */
+    void markAround(const CellBounds &bounds)
+    {
+        if (!bounds.empty())
+            markCells(bounds.iMin - 1, bounds.iMax + 1, bounds.jMin - 1, bounds.jMax + 1);
+    }
+
+    bool isMarked(int tile) const
+    {
+        return (mWords[static_cast<std::size_t>(tile) >> 6].load(std::memory_order_relaxed) >> (tile & 63)) & 1;
+    }
+
+    /**
+     * @brief Ajoute à out, par indice croissant, les tuiles marquées depuis le dernier collect()
+     */
+    void collect(std::vector<int> &out);
+
+    /**
+     * @brief Remet toutes les tuiles à l'état propre
+     */
+    void clear();
+
+  private:
+    int mWidth = 0;
+    int mHeight = 0;
+    int mTileSize = 1;
+    int mTilesX = 0;
+    int mTilesZ = 0;
+
+    std::size_t mWordCount = 0;
+    std::unique_ptr<std::atomic<uint64_t>[]> mWords;
+    std::vector<uint64_t> mCollected; /**< Bits déjà rendus par collect() */
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "TerrainSnapshot.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ErosionCheckpointer
+ * @brief Sauvegarde périodique et asynchrone d'une simulation d'érosion
+ *
+ * Tous les N pas, le champ de hauteurs est recopié dans l'un de deux
+ * buffers de capture ; un thread d'écriture dédié le sérialise ensuite en
+ * snapshot pendant que la simulation continue. Le thread de calcul ne paie
+ * que la copie mémoire. Si l'écriture précédente n'a pas encore démarré,
+ * la capture est ignorée plutôt que de bloquer la simulation.
+ *
+ * Les fichiers sont nommés checkpoint_<pas>.ersnap et écrits par
+ * renommage atomique : un fichier présent est toujours complet.
+ */
+class ErosionCheckpointer
+{
+  public:
+    static constexpr double MAX_OVERHEAD = 0.02; /**< Surcoût visé : 2 % du temps de calcul */
+
+    /**
+     * @param directory Dossier des checkpoints (créé si besoin)
+     * @param interval Nombre de pas entre deux checkpoints
+     * @param keep Nombre de checkpoints conservés sur disque
+     */
+    ErosionCheckpointer(const std::string &directory, int interval, int keep = 2);
+    ~ErosionCheckpointer();
+
+    ErosionCheckpointer(const ErosionCheckpointer &) = delete;
+    ErosionCheckpointer &operator=(const ErosionCheckpointer &) = delete;
+
+    /**
+     * @brief Cherche le checkpoint valide le plus récent d'un dossier
+     * @param directory Dossier des checkpoints
+     * @param path Chemin du checkpoint trouvé
+     * @return false si aucun checkpoint lisible n'existe
+     */
+    static bool findLatest(const std::string &directory, std::string &path);
+
+    /**
+     * @brief Recharge le dernier checkpoint du dossier
+     * @param data Hauteurs restaurées
+     * @param width Largeur attendue (vérifiée)
+     * @param height Hauteur attendue (vérifiée)
+     * @param metadata Métadonnées restaurées (pas d'érosion, paramètres)
+     * @return true si une simulation a été reprise
+     */
+    bool resume(std::vector<float> &data, int width, int height, SnapshotMetadata &metadata);
+
+    /**
+     * @brief Indique si un checkpoint est dû après le pas donné
+     */
+    bool isDue(uint64_t step) const { return mInterval > 0 && step >= mNextStep; }
+
+    /**
+     * @brief Capture le champ de hauteurs et confie l'écriture au thread d'E/S
+     * @param data Hauteurs (width * height)
+     * @param width Largeur du terrain
+     * @param height Hauteur du terrain
+     * @param metadata Métadonnées, erosionSteps compris
+     * @return false si la capture a été ignorée (écriture en retard)
+     */
+    bool checkpoint(const float *data, int width, int height, const SnapshotMetadata &metadata);
+
+    /**
+     * @brief Cumule le temps de calcul d'un pas, pour mesurer le surcoût
+     */
+    void addStepTime(double ms) { mStepMs += ms; mStepMsSinceCapture += ms; }
+
+    /**
+     * @brief Attend la fin des écritures en cours
+     */
+    void finish();
+
+    int getInterval() const { return mInterval; }
+    int getWritten() const;
+    int getSkipped() const { return mSkipped; }
+    int getFailed() const;
+    double getCaptureMs() const { return mCaptureMs; }
+
+    /**
+     * @brief Surcoût sur le thread de calcul : temps de capture / temps de calcul
+     */
+    double getOverhead() const { return mStepMs > 0.0 ? mCaptureMs / mStepMs : 0.0; }
+
+  private:
+    struct Job
+    {
+        int buffer = -1;
+        int width = 0;
+        int height = 0;
+        SnapshotMetadata metadata;
+    };
+
+    void writerLoop();
+    void prune();
+    std::string checkpointPath(uint64_t step) const;
+
+    std::string mDirectory;
+    int mInterval = 0;
+    int mKeep = 2;
+    uint64_t mNextStep = 0;
+    uint64_t mLastCaptureStep = 0; /**< Pas de la dernière capture effectuée (ou de la reprise) */
+
+    std::vector<float> mBuffers[2];
+    std::thread mWriter;
+    mutable std::mutex mMutex;
+    std::condition_variable mCondition;
+    Job mPending;
+    bool mHasPending = false;
+    int mWritingBuffer = -1;
+    bool mStop = false;
+
+    int mWritten = 0;
+    int mFailed = 0;
+    int mSkipped = 0;
+    double mCaptureMs = 0.0;
+    double mStepMs = 0.0;
+    double mStepMsSinceCapture = 0.0;
+};
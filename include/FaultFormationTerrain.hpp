@@ -2,6 +2,7 @@
 
 #include "Terrain.hpp"
 #include "RendererManager.hpp"
+#include <vector>
 
 /**
  * @class FaultFormationTerrain
@@ -16,6 +17,15 @@
 class FaultFormationTerrain : public Terrain
 {
 public: 
+    /**
+     * @brief Strategy used to apply the faults to the grid.
+     */
+    enum class FaultMode
+    {
+        FullSweep, ///< One pass over the whole grid per fault, O(W x H x F).
+        RowEvents  ///< Per-row crossings accumulated then prefix-scanned, O(H x (W + F)).
+    };
+
     /**
      * @brief Default constructor.
      *
@@ -40,6 +50,17 @@ public:
      */
     void CreateFaultFormation(int width, int height, int iterations, float minHeight, float maxHeight, float scale = 1.0f, bool applyFilter = false, float filter = 0.5f);
 
+    /**
+     * @brief Selects how faults are applied (default = FaultMode::RowEvents).
+     *
+     * Both modes displace the same cells. RowEvents accumulates the
+     * displacements in double precision, so heights may differ from
+     * FullSweep in the last bits of the float.
+     *
+     * @param mode Fault application strategy.
+     */
+    void SetFaultMode(FaultMode mode);
+
 private:
     /**
      * @struct TerrainPoint
@@ -58,6 +79,25 @@ private:
         bool IsEqual(TerrainPoint& p) const;
     };
 
+    /**
+     * @struct FaultLine
+     * @brief A fault oriented from p1 towards p2 and its displacement.
+     *
+     * Cells where dirX * (z - p1z) - dirZ * (x - p1x) > 0 are raised by h.
+     */
+    struct FaultLine
+    {
+        int p1x = 0;    ///< X coordinate of the first point
+        int p1z = 0;    ///< Z coordinate of the first point
+        int dirX = 0;   ///< X component of p2 - p1
+        int dirZ = 0;   ///< Z component of p2 - p1
+        float h = 0.0f; ///< Height added on the raised side
+    };
+
+    FaultMode mFaultMode = FaultMode::RowEvents;
+
+    static constexpr int FIR_STRIP_WIDTH = 256; ///< Columns filtered together in the vertical passes
+
     /**
      * @brief Internal function implementing the fault formation algorithm.
      *
@@ -69,48 +109,64 @@ private:
      * @param maxHeight Maximum allowed height value.
      * @param applyFilter Whether to apply FIR smoothing after generation.
      * @param filter FIR filter coefficient (interval [0.0 ; 1.0]).
+     * @param rawMin Receives the minimum raw height of the result.
+     * @param rawMax Receives the maximum raw height of the result.
      */
-    void CreateFaultFormationInternal(int iterations, float minHeight, float maxHeight, bool applyFilter, float filter);
+    void CreateFaultFormationInternal(int iterations, float minHeight, float maxHeight, bool applyFilter, float filter,
+                                      float& rawMin, float& rawMax);
 
     /**
      * @brief Generates two random points defining a fault line.
      *
-     * Ensures that the two points are distinct.
+     * Ensures that the two points are distinct. The points only depend on
+     * the terrain seed and the iteration index (see CounterRng).
      *
+     * @param iteration Index of the fault being generated.
      * @param p1 Output parameter for the first random point.
      * @param p2 Output parameter for the second random point.
      */
-    void GenRandomTerrainPoints(TerrainPoint& p1, TerrainPoint& p2);
+    void GenRandomTerrainPoints(int iteration, TerrainPoint& p1, TerrainPoint& p2);
 
     /**
-     * @brief Normalizes terrain heights to fit within minHeight and maxHeight.
+     * @brief Applies the faults with one full grid pass per fault.
+     *
+     * The min/max of the last sweep is reduced per thread while each row
+     * is still in cache.
      *
-     * Adjusts all values in the terrain grid proportionally to match the
-     * defined minimum and maximum height interval.
+     * @param faults Faults in generation order.
+     * @param rawMin Receives the minimum height.
+     * @param rawMax Receives the maximum height.
      */
-    void Normalize();
+    void ApplyFaultsFullSweep(const std::vector<FaultLine>& faults, float& rawMin, float& rawMax);
 
     /**
-     * @brief Applies a FIR filter to smooth the terrain.
+     * @brief Applies the faults row by row with a difference buffer.
      *
-     * This method applies the filter in all four directions: left-to-right,
-     * right-to-left, top-to-bottom, and bottom-to-top.
+     * For each row, the raised side of every fault is an interval of x
+     * computed analytically from the line equation; its bounds are
+     * recorded as +h / -h events and a single prefix scan produces the
+     * row heights.
      *
-     * @param filter FIR filter coefficient (interval [0.0 ; 1.0]).
+     * @param faults Faults in generation order.
+     * @param rawMin Receives the minimum height (reduced during the scan).
+     * @param rawMax Receives the maximum height (reduced during the scan).
      */
-    void ApplyFIRFilter(float filter);
+    void ApplyFaultsRowEvents(const std::vector<FaultLine>& faults, float& rawMin, float& rawMax);
 
     /**
-     * @brief Applies the FIR filter to a single terrain point.
+     * @brief Applies a FIR filter to smooth the terrain.
+     *
+     * This method applies the filter in all four directions: left-to-right,
+     * right-to-left, top-to-bottom, and bottom-to-top. Rows are filtered in
+     * parallel; columns are filtered by strips of FIR_STRIP_WIDTH adjacent
+     * columns so that every access is contiguous.
      *
-     * Updates the height of the point using the previous filtered value
-     * and the given filter coefficient.
+     * The last pass (bottom-to-top) writes the final heights, so their
+     * min/max is reduced there.
      *
-     * @param x X coordinate of the terrain point.
-     * @param z Z coordinate of the terrain point.
-     * @param PrevFractalVal Height value from the previous iteration.
      * @param filter FIR filter coefficient (interval [0.0 ; 1.0]).
-     * @return The new filtered height value at the specified point.
+     * @param rawMin Receives the minimum filtered height.
+     * @param rawMax Receives the maximum filtered height.
      */
-    float FIRFilterSinglePoint(int x, int z, float PrevFractalVal, float filter);
+    void ApplyFIRFilter(float filter, float& rawMin, float& rawMax);
 };
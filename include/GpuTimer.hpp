@@ -0,0 +1,50 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+/**
+ * @class GpuTimer
+ * @brief Temps GPU des phases de rendu par requêtes GL_TIME_ELAPSED
+ *
+ * begin()/end() encadrent une phase (les requêtes ne s'imbriquent pas).
+ * Le résultat n'est lu qu'une fois disponible, quelques images plus tard,
+ * par collect() : le thread principal n'attend jamais le GPU. Les temps sont
+ * transmis à Profiler::recordGpu sous le nom de la phase.
+ */
+class GpuTimer
+{
+  public:
+    GpuTimer() = default;
+    ~GpuTimer() = default;
+
+    GpuTimer(const GpuTimer &) = delete;
+    GpuTimer &operator=(const GpuTimer &) = delete;
+
+    /**
+     * @brief Démarre la mesure d'une phase (nom littéral)
+     */
+    void begin(const char *name);
+    void end();
+
+    /**
+     * @brief Lit les requêtes terminées, à appeler une fois par image
+     */
+    void collect();
+
+    /**
+     * @brief Détruit les requêtes, contexte GL encore courant
+     */
+    void release();
+
+  private:
+    struct Query
+    {
+        GLuint id = 0;
+        const char *name = nullptr;
+        bool pending = false;
+    };
+
+    std::vector<Query> mQueries; /**< Réutilisées une fois leur résultat lu */
+    int mActive = -1;
+};
@@ -38,6 +38,9 @@ public:
    
     int selectedMethod = GEN_HEIGHTMAP; 
     int selectedImage = 0; 
+    bool tiledStreaming = false;
+    char tiledFile[128] = "terrain.tiles";
+    int seed = 1;
 
     int faultWidth = 1024;
     int faultHeight = 1024;
@@ -46,11 +49,13 @@ public:
     float faultMaxHeight = 255.0f;
     bool faultUseFilter = true;
     float faultFilter = 0.5f;
+    bool faultRowEvents = true;
 
     int midpointSize = 1025; 
     float midpointRoughness = 1.0f;
     float midpointMinHeight = 0.0f;
     float midpointMaxHeight = 255.0f;
+    bool midpointStreaming = false;
 
     int perlinWidth = 1024;
     int perlinHeight = 1024;
@@ -60,6 +65,15 @@ public:
     int perlinOctaves = 4;      
     float perlinPersistence = 0.5f;
     float perlinLacunarity = 2.0f;
+    bool perlinVectorized = true;
+    int perlinType = 0;            // PerlinNoiseTerrain::NoiseType
+    float perlinOffset = 1.0f;
+    float perlinGain = 2.0f;
+    bool perlinWarp = false;
+    float perlinWarpStrength = 1.0f;
+    bool perlinStreaming = false;
+    int streamRadius = 16;
+    int streamErosionSteps = 8;
 
 
     // =========================================================
@@ -84,7 +98,31 @@ public:
     float rainAmount = 1.0f;
     float evaporationRate = 0.5f;
 
+    // Sculpture (clic gauche sur le terrain, menu affiché)
+    bool brushEnabled = false;
+    int brushMode = 0;             // BrushMode
+    float brushRadius = 16.0f;     // en cellules, 64 pour un pinceau de 128 cellules
+    float brushStrength = 1.0f;
+    float brushFalloff = 0.5f;
+    int brushRelaxSteps = 8;       // passes de détente thermique après chaque coup
+    int brushRelaxHalo = 8;        // marge détendue autour du pinceau, en cellules
+    float brushLastMs = 0.0f;
+    int brushLastPatches = 0;
+
+    bool streamingActive = false;
+    int streamResidentTiles = 0;
+    int streamPendingTiles = 0;
+
     glm::vec3 cameraPos = glm::vec3(0.0f); 
+
+    // =========================================================
+    // PROFILEUR
+    // =========================================================
+    bool showProfiler = false;
+    char traceFile[128] = "profile_trace.json";
+
+private:
+    void RenderProfilerOverlay();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * @class HeightPyramid
+ * @brief Pyramide min/max d'un champ de hauteurs, pour le lancer de rayons
+ *
+ * La surface est l'interpolation bilinéaire des cellules : entre quatre
+ * cellules voisines (un quad), elle reste dans le min/max de leurs
+ * hauteurs. Un noeud du niveau 0 couvre LEAF x LEAF quads, un noeud du
+ * niveau k + 1 ses quatre enfants du niveau k ; le dernier niveau est un
+ * noeud unique. Les bornes sont exactes, la traversée est donc
+ * conservative : un noeud n'est sauté que si le rayon passe au-dessus de
+ * son maximum sur tout le segment qui le traverse.
+ *
+ * raycast() descend dans les noeuds que le rayon peut toucher, remonte
+ * d'un niveau après chaque noeud sauté, et résout dans chaque quad
+ * l'intersection exacte avec la surface bilinéaire (équation du second
+ * degré le long du rayon).
+ *
+ * Les coordonnées sont celles des cellules : x colonne, z ligne, y hauteur.
+ * La pyramide ne garde pas de pointeur sur les hauteurs : chaque appel
+ * reçoit la grille (width x height, lignes contiguës) qui a servi à build().
+ */
+class HeightPyramid
+{
+  public:
+    static constexpr int LEAF = 4; /**< Quads par côté d'un noeud du niveau 0 */
+
+    struct Bounds
+    {
+        float lo;
+        float hi;
+    };
+
+    /**
+     * @brief Construit tous les niveaux (parallèle sur les lignes de noeuds)
+     */
+    void build(const float *data, int width, int height);
+
+    /**
+     * @brief Recalcule les noeuds qui couvrent les cellules [xMin, xMax] x [zMin, zMax]
+     */
+    void update(const float *data, int xMin, int xMax, int zMin, int zMax);
+
+    /**
+     * @brief Recalcule les noeuds des tuiles listées (tuileX * tuilesZ + tuileZ)
+     *
+     * Découpage de Terrain et DirtyTileSet : la tuile t couvre les cellules
+     * [t * tileSize, (t + 1) * tileSize], bord commun compris, et la dernière
+     * tuile de chaque axe s'étend jusqu'au bord de la grille. Un axe plus
+     * court que tileSize compte une tuile (tilesZ = 0 est traité comme 1).
+     */
+    void updateTiles(const float *data, const std::vector<int> &tiles, int tileSize, int tilesZ);
+
+    bool matches(int width, int height) const { return !mLevels.empty() && width == mWidth && height == mHeight; }
+
+    int levelCount() const { return static_cast<int>(mLevels.size()); }
+
+    /**
+     * @brief Bornes de toute la grille
+     */
+    Bounds rootBounds() const { return mLevels.back()[0]; }
+
+    /**
+     * @brief Première intersection du rayon origin + t * direction avec la surface (t >= 0)
+     *
+     * Un rayon qui arrive au-dessus de la grille sous la surface (origine
+     * sous le terrain, entrée par un bord) ne la touche pas.
+     *
+     * @param data Grille qui a servi à build()
+     * @param origin Origine (x, y, z) en coordonnées de cellules
+     * @param direction Direction (non nécessairement normée)
+     * @param tHit Paramètre de l'impact
+     * @return true si le rayon touche la surface
+     */
+    bool raycast(const float *data, const float origin[3], const float direction[3], float &tHit) const;
+
+  private:
+    int mWidth = 0;
+    int mHeight = 0;
+
+    std::vector<std::vector<Bounds>> mLevels;
+    std::vector<int> mLevelWidth;
+    std::vector<int> mLevelHeight;
+
+    Bounds leafBounds(const float *data, int nx, int nz) const;
+    float surfaceHeight(const float *data, float x, float z) const;
+    void refreshRange(const float *data, int nxMin, int nxMax, int nzMin, int nzMax);
+
+    bool intersectLeaf(const float *data, int nx, int nz, const float o[3], const float d[3], float tBegin,
+                       float tEnd, float &tHit) const;
+};
@@ -17,12 +17,14 @@ public:
      * @param erosionRate Taux d'érosion par pente et par goutte
      * @param depositRate Taux de dépôt de sédiments
      * @param evaporation Fraction d'eau évaporée par étape
+     * @param seed Graine des positions de départ des gouttes
      */
     HydraulicErosion(int iterations = 20000,
                      float rain = 1.0f,
                      float erosionRate = 0.02f,
                      float depositRate = 0.05f,
-                     float evaporation = 0.1f);
+                     float evaporation = 0.1f,
+                     uint32_t seed = 1);
 
     /**
      * @brief Applique l'érosion hydraulique sur le terrain
@@ -36,4 +38,5 @@ private:
     float erosionRate;   
     float depositRate;   
     float evaporation;   
+    uint32_t seed;
 };
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class LzCompressor
+ * @brief Compresseur LZ77 par blocs au format de séquences de type LZ4
+ *
+ * Chaque séquence est codée par un jeton (4 bits de longueur de littéraux,
+ * 4 bits de longueur de correspondance - 4), des octets d'extension à 255,
+ * les littéraux puis un décalage sur 2 octets. La dernière séquence ne
+ * contient que des littéraux. Le format est autonome et sans dictionnaire,
+ * ce qui permet de (dé)compresser les blocs indépendamment en parallèle.
+ */
+class LzCompressor
+{
+  public:
+    /**
+     * @brief Taille maximale de la sortie pour une entrée de n octets
+     */
+    static std::size_t maxCompressedSize(std::size_t n);
+
+    /**
+     * @brief Compresse un bloc
+     * @param src Données source
+     * @param n Taille de la source
+     * @param dst Buffer de sortie (au moins maxCompressedSize(n) octets)
+     * @return Taille compressée
+     */
+    static std::size_t compress(const uint8_t *src, std::size_t n, uint8_t *dst);
+
+    /**
+     * @brief Décompresse un bloc
+     * @param src Données compressées
+     * @param n Taille des données compressées
+     * @param dst Buffer de sortie
+     * @param rawSize Taille attendue des données décompressées
+     * @return true si le bloc est valide et fait exactement rawSize octets
+     */
+    static bool decompress(const uint8_t *src, std::size_t n, uint8_t *dst, std::size_t rawSize);
+
+    /**
+     * @brief Regroupe les octets de même rang de chaque mot (b0 b0 .. b1 b1 ..)
+     *
+     * Sur un champ de hauteurs les octets de poids fort varient peu, ce qui
+     * rend le flux beaucoup plus compressible.
+     */
+    static void shuffle(const uint8_t *src, std::size_t count, std::size_t wordSize, uint8_t *dst);
+
+    /**
+     * @brief Opération inverse de shuffle()
+     */
+    static void unshuffle(const uint8_t *src, std::size_t count, std::size_t wordSize, uint8_t *dst);
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class MassReduction
+ * @brief Somme précise et parallèle d'une grille de hauteurs
+ *
+ * La grille est découpée en blocs de BLOCK_SIZE valeurs. Chaque bloc est
+ * sommé en double par une réduction vectorisée (une somme partielle par
+ * voie SIMD, soit une somme par paires de faible profondeur), puis les
+ * sommes de blocs sont accumulées par chaque thread avec la compensation
+ * de Neumaier. Les sommes des threads sont enfin combinées dans l'ordre des
+ * threads : pour un nombre de threads donné, le résultat est reproductible.
+ */
+class MassReduction
+{
+  public:
+    static constexpr std::size_t BLOCK_SIZE = 1024;
+
+    /**
+     * @brief Somme des valeurs
+     * @param data Premier élément
+     * @param count Nombre d'éléments
+     */
+    static double sum(const float *data, std::size_t count);
+
+    static double sum(const std::vector<float> &data) { return sum(data.data(), data.size()); }
+
+    /**
+     * @brief Écart relatif |value - reference| / |reference| (0 si la référence est nulle)
+     */
+    static double relativeError(double reference, double value);
+
+    /**
+     * @brief Ajoute value à sum en accumulant l'erreur d'arrondi dans compensation (Neumaier)
+     */
+    static inline void accumulate(double &sum, double &compensation, double value)
+    {
+        const double t = sum + value;
+
+        if (std::abs(sum) >= std::abs(value))
+            compensation += (sum - t) + value;
+        else
+            compensation += (value - t) + sum;
+
+        sum = t;
+    }
+};
@@ -1,6 +1,8 @@
 #pragma once
 #include "Terrain.hpp"
 #include "RendererManager.hpp"
+#include <cstdint>
+#include <vector>
 
 /**
  * @class MidpointDisplacement
@@ -9,6 +11,12 @@
  * This class produces a heightmap by recursively subdividing a grid
  * and displacing midpoints to create realistic fractal terrain. The
  * algorithm consists of alternating "diamond" and "square" steps.
+ *
+ * Each level's diamond and square phases are parallel loops: a phase only
+ * reads points written by earlier phases, and every random offset is drawn
+ * from CounterRng keyed by (seed, level, cell). The output is therefore
+ * independent of the thread count, and any sub-region of a terrain can be
+ * regenerated on its own (see GenerateRegion).
  */
 class MidpointDisplacement : public Terrain
 {
@@ -35,35 +43,83 @@ public:
      */
     void CreateMidpointDisplacement(int size, float minHeight, float maxHeight, float scale = 1.0f, float roughness = 1);
 
-private:
     /**
-     * @brief Internal recursive implementation of the midpoint displacement algorithm.
+     * @brief Generates one tile of a (possibly huge) midpoint terrain.
      *
-     * @param roughness Roughness factor controlling terrain variation.
+     * The tile holds the cells [x0, x0 + width) x [z0, z0 + height) of the
+     * terrain of side size that CreateMidpointDisplacement would produce
+     * with the same seed. Heights are mapped to [minHeight, maxHeight]
+     * with MaxDisplacement instead of the terrain's actual extrema, so that
+     * adjacent tiles match exactly.
+     *
+     * @param size Side of the full terrain (2^n + 1).
+     * @param x0 First column of the tile.
+     * @param z0 First row of the tile.
+     * @param width Number of columns of the tile.
+     * @param height Number of rows of the tile.
+     * @param minHeight Height mapped to -MaxDisplacement.
+     * @param maxHeight Height mapped to +MaxDisplacement.
+     * @param scale Scale factor applied to the XZ plane (default = 1.0f, interval >0).
+     * @param roughness Controls the roughness of the terrain (default = 1, interval >0).
      */
-    void CreateMidpointDisplacementInterne(float roughness);
+    void CreateMidpointDisplacementRegion(int size, int x0, int z0, int width, int height,
+                                          float minHeight, float maxHeight, float scale = 1.0f, float roughness = 1);
 
     /**
-     * @brief Normalizes terrain heights to fit within minHeight and maxHeight.
+     * @brief Computes the raw (non-normalized) heights of a sub-region.
+     *
+     * Only the lattice points the region depends on are evaluated: at a
+     * level of spacing s, the region expanded by about 2s. The cost is
+     * close to the region's area plus a logarithmic number of levels.
      *
-     * Adjusts all values in the terrain grid proportionally to match the
-     * defined minimum and maximum height interval.
+     * @param seed Terrain seed.
+     * @param size Side of the full terrain (2^n + 1).
+     * @param roughness Roughness factor.
+     * @param x0 First column of the region.
+     * @param z0 First row of the region.
+     * @param width Number of columns.
+     * @param height Number of rows.
+     * @param out Heights of the region, row by row (resized).
+     * @return False if the size or the region is invalid.
+     */
+    static bool GenerateRegion(uint32_t seed, int size, float roughness, int x0, int z0,
+                               int width, int height, std::vector<float>& out);
+
+    /**
+     * @brief Upper bound of the absolute raw height for a size and roughness.
+     */
+    static float MaxDisplacement(int size, float roughness);
+
+private:
+    /**
+     * @brief Internal recursive implementation of the midpoint displacement algorithm.
+     *
+     * Every point is written exactly once, so the raw height range is
+     * reduced by the diamond and square steps as they write.
+     *
+     * @param roughness Roughness factor controlling terrain variation.
+     * @param rawMin Receives the minimum raw height.
+     * @param rawMax Receives the maximum raw height.
      */
-    void Normalize();
+    void CreateMidpointDisplacementInterne(float roughness, float& rawMin, float& rawMax);
 
     /**
      * @brief Performs the diamond step of the midpoint displacement.
      *
      * @param rectSize Current size of the sub-square being processed.
      * @param curHeight Current height displacement for this iteration.
+     * @param rawMin Lowered to the minimum of the written heights.
+     * @param rawMax Raised to the maximum of the written heights.
      */
-    void DiamondStep(int rectSize, float curHeight);
+    void DiamondStep(int rectSize, float curHeight, float& rawMin, float& rawMax);
 
     /**
      * @brief Performs the square step of the midpoint displacement.
      *
      * @param rectSize Current size of the sub-square being processed.
      * @param curHeight Current height displacement for this iteration.
+     * @param rawMin Lowered to the minimum of the written heights.
+     * @param rawMax Raised to the maximum of the written heights.
      */
-    void SquareStep(int rectSize, float curHeight);
+    void SquareStep(int rectSize, float curHeight, float& rawMin, float& rawMax);
 };
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "ThermalErosion.hpp"
+#include <vector>
+
+/**
+ * @brief Paramètres du solveur multigrille.
+ */
+struct MultigridSettings
+{
+    int levels = 4;                  /**< Niveaux grossiers sous la grille fine */
+    int minCoarseSize = 16;          /**< Côté minimal d'un niveau grossier */
+    int coarseSteps = 4000;          /**< Pas maximum par niveau grossier */
+    int fineSteps = 1000;            /**< Pas maximum sur la grille fine après la remontée */
+    int stallSteps = 200;            /**< Arrêt d'un niveau grossier quand le nombre de cellules modifiées ne baisse plus pendant stallSteps pas */
+    float coarseTalusFactor = 0.9f;  /**< Marge appliquée au talus des niveaux grossiers */
+};
+
+/**
+ * @class MultigridThermalErosion
+ * @brief Érosion thermique grossier vers fin
+ *
+ * Un pas d'érosion ne déplace la matière que d'une cellule : sur une grande
+ * carte, relaxer les pentes jusqu'à l'angle de talus demande des milliers
+ * de pas. Le solveur construit une pyramide de moyennes 2 x 2 des hauteurs
+ * et relaxe d'abord le niveau le plus grossier, avec un talus multiplié par
+ * la taille de ses cellules. Chaque niveau s'arrête quand plus aucune
+ * cellule ne bouge ou quand le nombre de cellules modifiées stagne ; sa
+ * correction (écart à sa restriction d'origine) est interpolée sur le
+ * niveau inférieur, qui est relaxé à son tour. La grille fine ne reçoit
+ * plus que des pas de finition.
+ *
+ * Les niveaux utilisent le noyau deux phases parallèle de ThermalErosion,
+ * qui conserve la masse. L'interpolation bilinéaire de la correction la
+ * conserve aussi, sauf sur les blocs incomplets des dimensions impaires ;
+ * l'écart est alors retiré des seules cellules corrigées, au prorata de
+ * leur correction. Les hauteurs ne sont pas bornées : un terrain sous 0
+ * est traité comme un autre.
+ */
+class MultigridThermalErosion
+{
+  public:
+    MultigridThermalErosion();
+
+    void setTalusAngle(float angle);
+    void setTransferRate(float c) { mTransferRate = c; }
+
+    void useEightNeighbors() { mEightNeighbors = true; }
+    void useFourNeighbors() { mEightNeighbors = false; }
+
+    /**
+     * @brief Relaxe une grille de hauteurs
+     * @param data Hauteurs (width * height, ligne par ligne), modifiées sur place
+     * @param width Largeur de la grille
+     * @param height Hauteur de la grille
+     * @param settings Profondeur de la pyramide et nombre de pas
+     * @return Cellules modifiées au dernier pas fin
+     */
+    int solve(std::vector<float> &data, int width, int height, const MultigridSettings &settings);
+
+    /**
+     * @brief Pas effectués à chaque niveau lors du dernier solve (0 = grille fine)
+     */
+    const std::vector<int> &getLevelSteps() const { return mLevelSteps; }
+
+  private:
+    struct Level
+    {
+        std::vector<float> data;
+        int width = 0;
+        int height = 0;
+    };
+
+    float mTalusSlope = 0.f;
+    float mTransferRate = 0.f;
+    bool mEightNeighbors = true;
+
+    std::vector<int> mLevelSteps;
+
+    static void restrict(const Level &fine, Level &coarse);
+    static void prolongate(const std::vector<float> &restricted, const Level &coarse, Level &fine);
+
+    int relax(Level &level, float talusSlope, int maxSteps, int stallSteps, int &stepsDone) const;
+};
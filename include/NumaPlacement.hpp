@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class NumaPlacement
+ * @brief Placement NUMA des grilles de hauteurs et des tampons d'érosion
+ *
+ * Une page est placée sur le noeud du premier thread qui l'écrit. Les
+ * std::vector étant remplis par le thread principal, toutes leurs pages
+ * finissent sur son socket. place() les redistribue après coup :
+ *
+ * - FirstTouch : chaque thread OpenMP déplace vers son noeud les pages du
+ *   bloc qu'un parallel for schedule(static) sur les éléments lui attribue,
+ *   soit le découpage en bandes de lignes des noyaux de ThermalErosion.
+ *   Les threads doivent être liés à leurs coeurs (OMP_PROC_BIND,
+ *   OMP_PLACES) ; sinon place() prévient et entrelace ;
+ * - Interleave : les pages sont réparties tour à tour sur tous les noeuds
+ *   (débit moyen, indépendant de l'ordonnancement).
+ *
+ * Seules les pages entièrement couvertes par le tampon sont déplacées : un
+ * tampon aligné sur la page est placé en entier, les pages partagées avec
+ * une autre allocation restent où elles sont.
+ *
+ * La politique par défaut vient de EROSION_NUMA_POLICY (firstTouch ou
+ * interleave). Sur une machine à un seul noeud, ou hors Linux, place() ne
+ * fait rien.
+ *
+ * fill() et copy() écrivent avec ce même découpage statique : sur une
+ * mémoire encore jamais écrite, ils réalisent directement le premier contact.
+ */
+class NumaPlacement
+{
+  public:
+    enum class Policy
+    {
+        FirstTouch,
+        Interleave
+    };
+
+    static void setPolicy(Policy policy) { sPolicy = policy; }
+    static Policy getPolicy() { return sPolicy; }
+
+    /**
+     * @brief Nombre de noeuds NUMA de la machine (au moins 1)
+     */
+    static int nodeCount();
+
+    /**
+     * @brief Redistribue les pages de [data, data + bytes) selon la politique courante
+     */
+    static void place(void *data, std::size_t bytes);
+
+    template <typename T> static void place(std::vector<T> &data)
+    {
+        place(data.data(), data.size() * sizeof(T));
+    }
+
+    /**
+     * @brief Remplissage et copie parallèles, schedule(static) sur les éléments
+     */
+    static void fill(float *data, std::size_t count, float value);
+    static void copy(const float *src, float *dst, std::size_t count);
+
+    static const char *policyName(Policy policy);
+
+  private:
+    static Policy sPolicy;
+};
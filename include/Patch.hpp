@@ -40,7 +40,7 @@ struct Vertex{
 struct Lod
 {
     std::vector<Vertex> vertices;      /** Coordonnées des sommets (x,y,z) et texture (u,v) */
-    std::vector<unsigned int> indices; /** Indices pour le rendu triangle */
+    const std::vector<unsigned int> *indices = nullptr; /** Indices pour le rendu triangle, communs à tous les patches */
 };
 
 /**
@@ -79,6 +79,10 @@ class Patch
 
     Texture* mPatchTexture; /**< Texture associée au patch */
 
+    int mOriginX = 0;            /** Cellule monde X de l'échantillon (0,0) des hauteurs */
+    int mOriginZ = 0;            /** Cellule monde Z de l'échantillon (0,0) des hauteurs */
+    float mTextureExtent = 0.f;  /** Cellules couvertes par la texture, 0 : taille du terrain */
+
   public:
     /**
      * @brief Initialise les paramètres du patch
@@ -90,6 +94,20 @@ class Patch
      */
     void setPatch(unsigned int x, unsigned int z, float xzFactor, unsigned int nbPatchX, unsigned int nbPatchZ,Texture* texture);
 
+    /**
+     * @brief Place le patch dans un monde non borné
+     *
+     * Les hauteurs passées ensuite à generateLodVertices() forment alors un
+     * bloc local dont l'échantillon (0,0) est la cellule monde
+     * (originX, originZ). Les coordonnées de texture sont rapportées à
+     * textureExtent cellules au lieu de la taille du bloc.
+     *
+     * @param originX Cellule monde X de l'origine du bloc
+     * @param originZ Cellule monde Z de l'origine du bloc
+     * @param textureExtent Étendue (en cellules) d'une répétition de l'échelle de texture
+     */
+    void setWorldOrigin(int originX, int originZ, float textureExtent);
+
     /**
      * @brief Ajoute un patch voisin
      * @param neighbor Pointeur vers le patch voisin
@@ -136,6 +154,11 @@ class Patch
      */
     void createBuffersGL();
 
+    /**
+     * @brief Détruit les buffers OpenGL créés par createBuffersGL()
+     */
+    void deleteBuffersGL();
+
     /**
      * @brief Génère les sommets pour tous les niveaux LOD
      * @param heights Vecteur des hauteurs du terrain
@@ -145,19 +168,23 @@ class Patch
      * Pour chaque niveau LOD, génère les sommets avec :
      * - Échantillonnage adapté au pas du LOD
      * - Ajout de "skirt" (jupe) sur les bords pour masquer les trous
+     *
+     * Les colonnes échantillonnées sont calculées une fois par LOD ; la boucle
+     * d'une ligne n'a ni branche ni clamp, la jupe est abaissée à part.
+     * Ne touche qu'aux données du patch : appelable en parallèle sur des
+     * patches distincts.
      */
     void generateLodVertices(std::vector<float> &heights, unsigned int width, unsigned int height);
 
     /**
      * @brief Génère les indices pour tous les niveaux LOD
-     * @param heights Vecteur des hauteurs (non utilisé directement)
-     * @param width Largeur du terrain (non utilisé)
-     * @param height Hauteur du terrain (non utilisé)
      *
      * Crée les indices pour former une grille de triangles
-     * pour chaque niveau de LOD.
+     * pour chaque niveau de LOD. La grille étant la même pour tous les
+     * patches, elle est calculée une seule fois et partagée (Lod::indices
+     * pointe sur la table du niveau).
      */
-    void generateLodIndices(std::vector<float> &heights, unsigned int width, unsigned int height);
+    void generateLodIndices();
 
     /**
      * @brief Effectue le rendu du patch avec son LOD actuel
@@ -185,6 +212,13 @@ class Patch
      */
     int getLodLevel();
 
+    /**
+     * @brief Retourne les sommets d'un niveau de LOD (jupe comprise)
+     * @param lodLevel Niveau de détail (0-4)
+     * @return Sommets ligne par ligne, générés par generateLodVertices()
+     */
+    const std::vector<Vertex> &getLodVertices(int lodLevel) const;
+
     /**
      * @brief Définit le niveau LOD actuel
      * @param level Nouveau niveau LOD
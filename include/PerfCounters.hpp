@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * @class PerfCounters
+ * @brief Compteurs matériels (perf_event_open) de tous les threads OpenMP
+ *
+ * Un compteur perf ouvert avec pid = 0 ne mesure que le thread appelant :
+ * open() ouvre donc un jeu de compteurs dans chaque thread de l'équipe
+ * OpenMP, qui est conservée d'une région parallèle à l'autre. start() et
+ * stop() les activent et les lisent tous depuis le thread principal ;
+ * les valeurs sont sommées sur les threads et corrigées du multiplexage
+ * (temps activé / temps effectif).
+ *
+ * Seul le code utilisateur est compté. Un événement que le noyau ou la
+ * machine ne fournit pas (machine virtuelle, perf_event_paranoid trop
+ * élevé) est simplement marqué indisponible. Hors Linux, open() échoue.
+ */
+class PerfCounters
+{
+  public:
+    enum Event
+    {
+        Cycles,
+        Instructions,
+        LlcMisses,
+        DtlbMisses,
+        BranchMisses,
+        EventCount
+    };
+
+    /**
+     * @brief Valeurs d'une mesure, sommées sur les threads
+     */
+    struct Sample
+    {
+        double values[EventCount] = {};
+        bool valid[EventCount] = {};
+
+        bool has(Event event) const { return valid[event]; }
+        double get(Event event) const { return values[event]; }
+
+        /**
+         * @brief Instructions par cycle (-1 si un des deux compteurs manque)
+         */
+        double ipc() const;
+    };
+
+    PerfCounters() = default;
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /**
+     * @brief Ouvre les compteurs dans chaque thread OpenMP
+     * @return true si au moins un événement est disponible
+     */
+    bool open();
+    void close();
+
+    bool isOpen() const { return !mFds.empty(); }
+
+    /**
+     * @brief Remet à zéro et active tous les compteurs
+     */
+    void start();
+
+    /**
+     * @brief Désactive les compteurs et renvoie la mesure depuis start()
+     */
+    Sample stop();
+
+    /**
+     * @brief Nom de colonne CSV d'un événement (cycles, instructions...)
+     */
+    static const char *eventName(Event event);
+
+  private:
+    int mThreads = 0;
+    std::vector<int> mFds; /**< mFds[thread * EventCount + event], -1 si indisponible */
+};
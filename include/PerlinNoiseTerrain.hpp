@@ -11,10 +11,60 @@
  * This class produces a heightmap by evaluating a Perlin noise function
  * over a 2D grid. Supports customizable frequency, octaves, persistence
  * and lacunarity.
+ *
+ * Two kernels are available. The scalar kernel is the classic
+ * permutation-table Perlin noise. The vectorized kernel evaluates
+ * NOISE_BATCH consecutive samples of a row per call, hashes lattice
+ * corners with integer arithmetic instead of table lookups and floors
+ * by truncation, so the whole batch maps onto SIMD lanes.
+ *
+ * Besides plain fBm, the vectorized kernel provides ridged and hybrid
+ * multifractals (Musgrave) and domain warping. Each variant is a
+ * compile-time pipeline templated on the basis noise and the octave
+ * combiner, so the inner loop of one variant carries no test for the
+ * others.
  */
 class PerlinNoiseTerrain : public Terrain
 {
 public:
+    /**
+     * @brief Noise evaluation kernel.
+     */
+    enum class NoiseKernel
+    {
+        Scalar,    ///< One sample per call, permutation-table gradients.
+        Vectorized ///< NOISE_BATCH samples per call, integer-hash gradients.
+    };
+
+    /**
+     * @brief How octaves are combined.
+     */
+    enum class NoiseType
+    {
+        FBm,    ///< Sum of amplitude-weighted octaves.
+        Ridged, ///< Ridged multifractal: sharp crests, each octave weighted by the previous one.
+        Hybrid  ///< Hybrid multifractal: smooth valleys, rough peaks.
+    };
+
+    /**
+     * @brief Parameters of a noise evaluation (see GenerateRegion).
+     */
+    struct NoiseParams
+    {
+        uint32_t seed = 1;            ///< Hash seed
+        float frequency = 0.005f;     ///< Base frequency
+        int octaves = 4;              ///< Number of octaves
+        float persistence = 0.5f;     ///< Amplitude damping factor for each octave
+        float lacunarity = 2.0f;      ///< Frequency multiplier for each octave
+        NoiseType type = NoiseType::FBm;
+        float offset = 1.0f;          ///< Ridged/hybrid offset added to the basis
+        float gain = 2.0f;            ///< Ridged weight gain
+        bool warp = false;            ///< Domain warping before the octave loop
+        float warpStrength = 1.0f;    ///< Warp displacement, in base lattice cells
+    };
+
+    static constexpr int NOISE_BATCH = 16; ///< Samples evaluated per vectorized call
+
     /**
      * @brief Default constructor.
      */
@@ -41,12 +91,91 @@ public:
                            float persistence = 0.5f,
                            float lacunarity = 2.0f);
 
+    /**
+     * @brief Selects the noise kernel (default = NoiseKernel::Vectorized).
+     *
+     * Both kernels produce Perlin noise with the same lattice, fade curve
+     * and gradient set, but the corner gradients are picked by different
+     * hashes: the same seed gives two different terrains.
+     *
+     * @param kernel Noise evaluation kernel.
+     */
+    void SetNoiseKernel(NoiseKernel kernel);
+
+    /**
+     * @brief Selects the octave combiner (default = NoiseType::FBm).
+     *
+     * Ridged and hybrid noise always use the vectorized kernel.
+     *
+     * @param type Octave combiner.
+     * @param offset Offset added to the basis noise (ridged, hybrid).
+     * @param gain Weight gain between octaves (ridged).
+     */
+    void SetNoiseType(NoiseType type, float offset = 1.0f, float gain = 2.0f);
+
+    /**
+     * @brief Enables domain warping (default = disabled).
+     *
+     * Sample coordinates are displaced by a two-octave noise vector before
+     * the octave loop. Warped noise always uses the vectorized kernel.
+     *
+     * @param enabled Whether to warp the domain.
+     * @param strength Displacement, in cells of the base lattice.
+     */
+    void SetDomainWarp(bool enabled, float strength = 1.0f);
+
+    /**
+     * @brief Duration of the noise evaluation of the last generation.
+     *
+     * Covers the octave loop only (not normalization nor patch creation).
+     *
+     * @return Time in milliseconds.
+     */
+    double GetNoiseTimeMs() const;
+
+    /**
+     * @brief Evaluates raw noise over any rectangle of the unbounded plane.
+     *
+     * Uses the vectorized kernel: sample (x, z) equals cell (x, z) of a
+     * vectorized CreatePerlinNoise with the same parameters, before
+     * normalization. Coordinates may be negative. The function is not
+     * parallelized, so concurrent tile workers can call it directly.
+     *
+     * @param params Seed, octave settings and variant.
+     * @param x0 First column of the region.
+     * @param z0 First row of the region.
+     * @param width Width of the region.
+     * @param height Height of the region.
+     * @param out Receives width * height raw values, row-major.
+     */
+    static void GenerateRegion(const NoiseParams& params, int x0, int z0, int width, int height, float* out);
+
+    /**
+     * @brief Range that GenerateRegion values cannot leave.
+     *
+     * Normalizing with these bounds instead of the observed min/max keeps
+     * independently generated regions consistent with each other.
+     *
+     * @param params Octave settings and variant.
+     * @param low Receives the lower bound.
+     * @param high Receives the upper bound.
+     */
+    static void OutputRange(const NoiseParams& params, float& low, float& high);
+
 private:
     float mBaseFrequency;
     int mNumOctaves;
     float mPersistenceCoef;
     float mLacunarityCoef;
 
+    NoiseKernel mNoiseKernel = NoiseKernel::Vectorized;
+    NoiseType mNoiseType = NoiseType::FBm;
+    float mOffset = 1.0f;
+    float mGain = 2.0f;
+    bool mWarp = false;
+    float mWarpStrength = 1.0f;
+    double mNoiseTimeMs = 0.0;
+
     std::vector<int> mPermutation;
 
     /// Initialize the permutation table (size 512).
@@ -64,14 +193,12 @@ private:
     /// Linear interpolation.
     inline float Lerp(float a, float b, float t) const;
 
-    /// Internal generation function.
-    void CreatePerlinNoiseInternal(float minH, float maxH);
-    
-    /**
-     * @brief Normalizes terrain heights to fit within minHeight and maxHeight.
-     *
-     * Adjusts all values in the terrain grid proportionally to match the
-     * defined minimum and maximum height interval.
-     */
-    void Normalize();
+    /// Internal generation function (scalar kernel); also returns the raw height range.
+    void CreatePerlinNoiseInternal(float& rawMin, float& rawMax);
+
+    /// Internal generation function (vectorized kernel, any variant); also returns the raw height range.
+    void CreatePerlinNoiseVectorized(float& rawMin, float& rawMax);
+
+    /// Parameters of the current generation.
+    NoiseParams GetParams() const;
 };
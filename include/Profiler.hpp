@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class Profiler
+ * @brief Chronométrage par portée des phases d'une image ou d'un pas
+ *
+ * PROFILE_SCOPE("nom") mesure la portée courante et écrit l'événement
+ * (nom, début, fin) dans le tampon circulaire du thread appelant ; seul le
+ * pointeur du nom est conservé, il doit s'agir d'un littéral. Chaque
+ * thread a son propre tampon : l'écriture est sans verrou ni atomique
+ * partagé, seul le premier événement d'un thread l'enregistre auprès du
+ * profileur. Le tampon d'un thread terminé est repris par le suivant :
+ * leur nombre reste celui des threads actifs en même temps. Les RING_CAPACITY derniers événements de chaque thread sont
+ * conservés ; chaque emplacement porte un numéro de séquence, et le
+ * lecteur ignore ceux que le producteur réécrit pendant la lecture.
+ *
+ * endFrame(), appelé une fois par image depuis le thread principal,
+ * consomme les nouveaux événements de tous les threads et met à jour, par
+ * phase, le temps de l'image (cumulé sur les threads) et sa moyenne et son
+ * maximum sur les HISTORY_FRAMES dernières images. Les temps GPU (requêtes
+ * GL_TIME_ELAPSED, voir GpuTimer) y sont ajoutés par recordGpu().
+ *
+ * Compilé avec EROSION_DISABLE_PROFILER (option CMake EROSION_PROFILER=OFF),
+ * PROFILE_SCOPE ne génère aucun code.
+ */
+class Profiler
+{
+  public:
+    static constexpr std::size_t RING_CAPACITY = 8192;
+    static constexpr int HISTORY_FRAMES = 120;
+
+    struct Event
+    {
+        const char *name = nullptr;
+        uint64_t startNs = 0;
+        uint64_t endNs = 0;
+    };
+
+    /**
+     * @brief Temps d'une phase, en millisecondes par image
+     */
+    struct PhaseStats
+    {
+        std::string name;
+        bool gpu = false;
+        double lastMs = 0.0;
+        double avgMs = 0.0;
+        double maxMs = 0.0;
+        float history[HISTORY_FRAMES] = {}; /**< Circulaire, indice frameIndex() % HISTORY_FRAMES */
+    };
+
+    class ScopedTimer
+    {
+      public:
+        explicit ScopedTimer(const char *name) : mName(name), mStartNs(isEnabled() ? now() : 0) {}
+
+        ~ScopedTimer()
+        {
+            if (mStartNs != 0)
+                record(mName, mStartNs, now());
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+      private:
+        const char *mName;
+        uint64_t mStartNs;
+    };
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * @brief Horloge monotone en nanosecondes (jamais nulle)
+     */
+    static uint64_t now();
+
+    /**
+     * @brief Ajoute un événement au tampon du thread appelant
+     */
+    static void record(const char *name, uint64_t startNs, uint64_t endNs);
+
+    /**
+     * @brief Ajoute un temps GPU à l'image courante
+     */
+    static void recordGpu(const char *name, double ms);
+
+    /**
+     * @brief Clôt l'image courante : agrège les événements reçus depuis l'appel précédent
+     */
+    static void endFrame();
+
+    static const std::vector<PhaseStats> &getPhases();
+    static const PhaseStats &getFrameStats();
+    static int frameIndex();
+
+    /**
+     * @brief Écrit les événements conservés au format Chrome trace (chrome://tracing, Perfetto)
+     * @return false si le fichier n'a pas pu être écrit
+     */
+    static bool exportChromeTrace(const std::string &path);
+
+    /**
+     * @brief Vide les tampons et les statistiques
+     */
+    static void reset();
+};
+
+#ifndef EROSION_DISABLE_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) Profiler::ScopedTimer PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
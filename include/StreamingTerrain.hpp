@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Terrain.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Paramètres du mode streaming.
+ */
+struct StreamingConfig
+{
+    int viewRadius = 16;       /**< Rayon (en tuiles) chargé autour de la caméra */
+    int cacheTiles = 1600;     /**< Tuiles gardées en mémoire (LRU), au moins le disque de vue */
+    int workers = 0;           /**< Threads de génération, 0 pour cœurs - 1 */
+    int uploadsPerFrame = 32;  /**< Tuiles envoyées au GPU par image */
+    int erosionSteps = 8;      /**< Pas d'érosion thermique appliqués à chaque tuile */
+    float talusAngle = 30.f;   /**< Angle de talus (degrés) */
+    float transferRate = 0.5f; /**< Taux de transfert */
+};
+
+/**
+ * @class StreamingTerrain
+ * @brief Terrain procédural non borné, généré par tuiles autour de la caméra
+ *
+ * Le monde est découpé en tuiles de PATCH_SIZE cellules ; chaque tuile
+ * devient un Patch du système de LOD existant. Les tuiles manquantes dans
+ * le rayon de vue sont demandées par distance croissante à un pool de
+ * threads qui les génèrent, les érodent et calculent leurs sommets ; le
+ * thread de rendu n'a plus qu'à créer les buffers OpenGL.
+ *
+ * Avant d'être affichée, une tuile subit erosionSteps pas d'érosion
+ * thermique deux phases sur une fenêtre élargie d'un halo de
+ * 2 x erosionSteps cellules. Un pas ne propage l'information qu'à deux
+ * cellules : l'intérieur de la fenêtre est donc identique à ce qu'aurait
+ * donné l'érosion du monde entier, et les tuiles voisines se raccordent
+ * exactement.
+ *
+ * Les tuiles qui sortent du rayon de vue restent en cache jusqu'à ce que
+ * cacheTiles soit dépassé ; la moins récemment vue est alors évincée.
+ */
+class StreamingTerrain : public Terrain
+{
+  public:
+    /**
+     * @brief Source de hauteurs : remplit out (width * height, ligne par
+     * ligne) pour le rectangle de cellules monde commençant en (x0, z0).
+     *
+     * Doit être une fonction pure et réentrante : elle est appelée en
+     * parallèle par les workers, pour des rectangles qui se chevauchent.
+     * Les régions OpenMP qu'elle ouvre n'ont qu'un thread.
+     */
+    using TileGenerator = std::function<void(int x0, int z0, int width, int height, float *out)>;
+
+    static constexpr int TILE_SAMPLES = PATCH_SIZE + 1;   /**< Échantillons par côté (bord partagé) */
+    static constexpr float TEXTURE_EXTENT = 1024.f;       /**< Cellules couvertes par l'échelle de texture */
+
+    /**
+     * @param generator Source de hauteurs
+     * @param minHeight Hauteur minimale produite par la source
+     * @param maxHeight Hauteur maximale produite par la source
+     * @param config Rayon, cache, workers et érosion
+     * @param xzFactor Facteur d'échelle horizontale
+     */
+    StreamingTerrain(TileGenerator generator, float minHeight, float maxHeight,
+                     const StreamingConfig &config, float xzFactor = 1.0f);
+
+    /**
+     * @brief Arrête les workers et libère les buffers OpenGL des tuiles
+     */
+    ~StreamingTerrain();
+
+    StreamingTerrain(const StreamingTerrain &) = delete;
+    StreamingTerrain &operator=(const StreamingTerrain &) = delete;
+
+    /**
+     * @brief Met à jour les tuiles autour de la caméra (thread OpenGL)
+     *
+     * Intègre au plus uploadsPerFrame tuiles prêtes, redemande les tuiles
+     * manquantes quand la caméra change de tuile, marque comme utilisées à
+     * cette image les tuiles du disque de vue et évince les tuiles en trop.
+     *
+     * @param cameraPos Position de la caméra
+     */
+    void update(const glm::vec3 &cameraPos);
+
+    /**
+     * @brief Calcule les hauteurs finales d'une tuile
+     *
+     * Génère la tuile et son halo, applique l'érosion puis extrait les
+     * TILE_SAMPLES x TILE_SAMPLES échantillons de la tuile.
+     *
+     * @param generator Source de hauteurs
+     * @param tx Indice X de la tuile
+     * @param tz Indice Z de la tuile
+     * @param erosionSteps Nombre de pas d'érosion
+     * @param talus Tangente de l'angle de talus
+     * @param transferRate Taux de transfert
+     * @param heights Reçoit les hauteurs de la tuile
+     */
+    static void generateTile(const TileGenerator &generator, int tx, int tz, int erosionSteps,
+                             float talus, float transferRate, std::vector<float> &heights);
+
+    /**
+     * @brief Nombre de tuiles chargées sur le GPU
+     */
+    int getResidentTiles() const { return static_cast<int>(mResident.size()); }
+
+    /**
+     * @brief Nombre de tuiles demandées et pas encore intégrées
+     */
+    int getPendingTiles() const { return static_cast<int>(mRequested.size()); }
+
+  private:
+    struct Resident
+    {
+        Patch *patch = nullptr;
+        unsigned long long lastUse = 0;
+    };
+
+    struct ReadyTile
+    {
+        uint64_t key = 0;
+        std::unique_ptr<Patch> patch;
+    };
+
+    TileGenerator mGenerator;
+    StreamingConfig mConfig;
+    float mTalus = 0.f;
+
+    std::vector<std::pair<int, int>> mRingOffsets; /**< Disque de vue trié par distance */
+
+    // État du thread de rendu
+    std::unordered_map<uint64_t, Resident> mResident;
+    std::unordered_set<uint64_t> mRequested;
+    unsigned long long mFrame = 0;
+    int mCameraTileX = 0;
+    int mCameraTileZ = 0;
+    bool mHasCameraTile = false;
+
+    // Partagé avec les workers, protégé par mMutex
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<uint64_t> mQueue;
+    std::vector<ReadyTile> mReady;
+    bool mStop = false;
+
+    std::vector<std::thread> mWorkers;
+
+    static uint64_t tileKey(int tx, int tz);
+    static int tileX(uint64_t key);
+    static int tileZ(uint64_t key);
+
+    void workerLoop();
+    void requestAround(int cameraTileX, int cameraTileZ);
+    void touchVisible(int cameraTileX, int cameraTileZ);
+    void evict(int cameraTileX, int cameraTileZ);
+};
@@ -3,6 +3,7 @@
 
 #include <GL/glew.h>
 #include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <glm/glm.hpp>
 #include <iostream>
@@ -10,12 +11,67 @@
 #include <string.h>
 #include <vector>
 
+#include "HeightPyramid.hpp"
 #include "Patch.hpp"
 #include "stb_image.hpp"
+#include "TerrainSnapshot.hpp"
 #include "Texture.hpp"
 
 class RendererManager;
 
+/**
+ * @brief Outils de sculpture de Terrain::applyBrush
+ */
+enum class BrushMode
+{
+    Raise,   /**< Ajoute de la hauteur */
+    Lower,   /**< Retire de la hauteur, sans descendre sous la hauteur minimale du terrain */
+    Smooth,  /**< Tire chaque cellule vers la moyenne de ses 8 voisins */
+    Flatten  /**< Tire chaque cellule vers targetHeight */
+};
+
+/**
+ * @brief Coup de pinceau, en coordonnées de cellules
+ *
+ * Le poids vaut 1 jusqu'à radius * (1 - falloff) puis décroît (smoothstep)
+ * jusqu'à 0 au bord du disque.
+ */
+struct BrushStroke
+{
+    BrushMode mode = BrushMode::Raise;
+    float centerX = 0.f;      /**< Colonne du centre */
+    float centerZ = 0.f;      /**< Ligne du centre */
+    float radius = 16.f;      /**< Rayon en cellules */
+    float strength = 1.f;     /**< Hauteur au centre (Raise/Lower), fraction 0..1 (Smooth/Flatten) */
+    float falloff = 0.5f;     /**< Part du rayon sur laquelle le poids décroît */
+    float targetHeight = 0.f; /**< Hauteur visée par Flatten */
+};
+
+/**
+ * @brief Rectangle de cellules [xMin, xMax] x [zMin, zMax], bornes incluses
+ */
+struct CellRect
+{
+    int xMin = 0;
+    int xMax = -1;
+    int zMin = 0;
+    int zMax = -1;
+
+    bool empty() const { return xMin > xMax || zMin > zMax; }
+
+    /**
+     * @brief Rectangle élargi de margin cellules, borné à une grille width x height
+     */
+    CellRect expanded(int margin, int width, int height) const
+    {
+        if (empty())
+            return *this;
+
+        return {std::max(0, xMin - margin), std::min(width - 1, xMax + margin),
+                std::max(0, zMin - margin), std::min(height - 1, zMax + margin)};
+    }
+};
+
 /**
  * @class Terrain
  * @brief Classe de base représentant un terrain avec gestion des hauteurs et LOD
@@ -35,11 +91,14 @@ class Terrain
     float mMinHeight;         /**< Hauteur minimale du terrain */
     int mBorderSize;          /**< Taille de la bordure (aplatie) */
     int mCellSpacing;         /**< Espacement entre les cellules */
+    uint32_t mSeed = 1;       /**< Graine des générateurs procéduraux (CounterRng) */
 
     std::vector<Vertex> mVertex; /**< Sommets complets du terrain (position + texture) */
 
     std::vector<std::unique_ptr<Patch>> mPatches; /**< Patches pour le LOD */
 
+    HeightPyramid mHeightPyramid; /**< Bornes min/max de mData pour raycast() */
+
     Frustrum mFrustrum;                         /**< Frustum pour le culling */
     std::unique_ptr<RendererManager> mRenderer; /**< Gestionnaire de rendu */
 
@@ -50,7 +109,7 @@ class Terrain
      * @brief Met à jour les vertices pour tous les niveaux LOD
      *
      * Délègue la génération des vertices à chaque patch via
-     * Patch::generateLodVertices().
+     * Patch::generateLodVertices(), en parallèle sur les patches.
      */
     void loadVerticesLod();
 
@@ -58,7 +117,7 @@ class Terrain
      * @brief Met à jour les indices pour tous les niveaux LOD
      *
      * Délègue la génération des indices à chaque patch via
-     * Patch::generateLodIndices().
+     * Patch::generateLodIndices(), en parallèle sur les patches.
      */
     void loadIndicesLod();
 
@@ -79,6 +138,27 @@ class Terrain
      */
     void loadTerrain(const char *imagePath, float yFactor, float xzFactor);
 
+    /**
+     * @brief Sauvegarde le champ de hauteurs dans un snapshot binaire
+     * @param path Fichier de sortie
+     * @param metadata Paramètres de génération et nombre de pas d'érosion
+     * @param options Encodage (float/half) et compression
+     * @return true si la sauvegarde a réussi
+     */
+    bool saveSnapshot(const std::string &path, const SnapshotMetadata &metadata,
+                      const SnapshotOptions &options = {}) const;
+
+    /**
+     * @brief Restaure un terrain depuis un snapshot binaire
+     * @param path Fichier à lire
+     * @param yFactor Facteur d'échelle verticale
+     * @param xzFactor Facteur d'échelle horizontale
+     * @param metadata Métadonnées lues (optionnel)
+     * @return true si la restauration a réussi
+     */
+    bool loadSnapshot(const std::string &path, float yFactor, float xzFactor,
+                      SnapshotMetadata *metadata = nullptr);
+
     /**
      * @brief Configure les buffers OpenGL pour le rendu avec LOD
      * @param vao Vertex Array Object
@@ -149,6 +229,59 @@ class Terrain
         mData[j * mWidth + i] = value;
     };
 
+    /**
+     * @brief Applique un coup de pinceau à mData
+     *
+     * Seules les cellules du disque sont écrites. Les patches à remailler
+     * sont ceux de patchesInRect(rectangle retourné).
+     *
+     * @param stroke Pinceau, centre et rayon en cellules
+     * @return Rectangle des cellules modifiées (vide si le disque est hors du terrain)
+     */
+    CellRect applyBrush(const BrushStroke &stroke);
+
+    /**
+     * @brief Indices (dans mPatches) des patches dont le maillage lit une cellule du rectangle
+     */
+    std::vector<int> patchesInRect(const CellRect &rect) const;
+
+    /**
+     * @brief Intersection d'un rayon (repère monde) avec le champ de hauteurs
+     *
+     * Traverse la pyramide min/max (HeightPyramid) et résout l'intersection
+     * exacte dans les quads qu'elle ne permet pas d'écarter. La pyramide est
+     * construite par createPatches() ; sans pyramide aux dimensions de mData
+     * (génération interrompue), retourne false.
+     *
+     * @param origin Origine du rayon
+     * @param direction Direction du rayon (non nécessairement normée)
+     * @param hit Point d'impact (repère monde)
+     * @return true si le rayon touche le terrain
+     */
+    bool raycast(const glm::vec3 &origin, const glm::vec3 &direction, glm::vec3 &hit) const;
+
+    /**
+     * @brief Reconstruit la pyramide de raycast() depuis mData
+     *
+     * À appeler après une modification de mData qui ne passe ni par
+     * applyBrush() ni par updateVerticesGpuLod() (outils sans rendu).
+     */
+    void rebuildHeightPyramid();
+
+    /**
+     * @brief Met à jour la pyramide de raycast() sur les cellules des patches listés
+     * @param patchIndices Indices dans mPatches (par exemple ThermalErosion::getDirtyPatchIndices())
+     */
+    void updateHeightPyramid(const std::vector<int> &patchIndices);
+
+    /**
+     * @brief Retourne le facteur d'échelle horizontal (cellules par unité monde)
+     */
+    float getXzFactor() const
+    {
+        return mXzFactor;
+    };
+
     /**
      * @brief Retourne la hauteur maximale du terrain
      * @return Hauteur maximale
@@ -185,6 +318,36 @@ class Terrain
         return mWidth;
     };
 
+    /**
+     * @brief Fixe la graine utilisée par les générateurs procéduraux
+     * @param seed Graine, à fixer avant l'appel à la fonction Create*
+     */
+    void setSeed(uint32_t seed)
+    {
+        mSeed = seed;
+    };
+
+    /**
+     * @brief Retourne la graine des générateurs procéduraux
+     * @return Graine courante
+     */
+    uint32_t getSeed() const
+    {
+        return mSeed;
+    };
+
+    /**
+     * @brief Ramène les hauteurs brutes dans [mMinHeight, mMaxHeight]
+     *
+     * Les générateurs calculent les extrêmes bruts pendant leur dernière
+     * passe parallèle (réduction min/max par thread) : la normalisation
+     * se fait ensuite en une seule passe parallèle sur mData.
+     *
+     * @param rawMin Hauteur brute minimale de mData
+     * @param rawMax Hauteur brute maximale de mData
+     */
+    void normalizeHeights(float rawMin, float rawMax);
+
     /**
      * @brief Met à jour une valeur dans le vecteur de données
      * @param i Index dans le vecteur
@@ -255,7 +418,8 @@ class Terrain
      * @brief Met à jour les sommets LOD sur le GPU pour tous les patches.
      *
      * Cette méthode régénère d'abord les sommets côté CPU, puis recharge
-     * les buffers GPU de chaque patch.
+     * les buffers GPU de chaque patch. La pyramide de raycast() est
+     * reconstruite.
      */
     void updateVerticesGpuLod();
 
@@ -266,6 +430,9 @@ class Terrain
      * 1. régénération CPU des sommets des patches sales
      * 2. recharge GPU des buffers correspondants
      *
+     * Les noeuds de la pyramide de raycast() qui couvrent ces patches sont
+     * recalculés.
+     *
      * @param dirtyPatchIndices Indices des patches à mettre à jour
      */
     void updateVerticesGpuLod(const std::vector<int>& dirtyPatchIndices);
@@ -18,8 +18,10 @@
 #include "FaultFormationTerrain.hpp"
 #include "MidpointDisplacement.hpp"
 #include "PerlinNoiseTerrain.hpp"
+#include "StreamingTerrain.hpp"
 #include "ThermalErosion.hpp"
 #include "Gui.hpp"
+#include "GpuTimer.hpp"
 
 /**
  * @class TerrainApp
@@ -32,7 +34,7 @@ class TerrainApp
 public:
     /**
      * @brief Constructs a TerrainApp instance
-     * @param seed Seed used to initialize the random number generator
+     * @param seed Default seed of the procedural generators (editable in the GUI)
      */
     TerrainApp(unsigned int seed = 1);
 
@@ -92,6 +94,12 @@ private:
      */
     std::unique_ptr<Terrain> BuildTerrainFromGuiSelection();
 
+    /**
+     * @brief Builds a streaming terrain fed by source, with the GUI view radius and erosion settings.
+     */
+    std::unique_ptr<Terrain> BuildStreamingTerrain(StreamingTerrain::TileGenerator source,
+                                                   float minHeight, float maxHeight);
+
     /**
      * @brief Finalizes terrain after CPU build (camera, textures, LOD, erosion info).
      */
@@ -107,6 +115,15 @@ private:
      */
     void UpdateTerrainGeneration();
 
+    /**
+     * @brief Applies one brush stroke under the mouse cursor while the left button is held.
+     *
+     * Picks the terrain along the cursor ray, edits the heights, relaxes the
+     * brushed region plus a halo with thermal erosion and re-meshes only the
+     * patches that read those cells.
+     */
+    void ApplyBrushFromMouse();
+
 private:
     GLFWwindow* mWindow;              ///< Pointer to the GLFW window
 
@@ -139,7 +156,11 @@ private:
     bool hydraulicEnabled;
     bool hydraulicStarted;
 
+    bool mBrushActive = false;         ///< Bouton gauche maintenu sur le terrain au coup précédent
+    float mBrushTarget = 0.0f;         ///< Hauteur visée par l'outil Aplanir (prise au premier clic)
+
     Gui mGui;                          ///< User Interface instance
+    GpuTimer mGpuTimer;                ///< Temps GPU du terrain et de l'interface (overlay du profileur)
     bool mShowMenu;                    ///< Boolean to toggle menu visibility
 
     std::future<void> mGenerationFuture;   ///< Tâche asynchrone de génération du terrain
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Encodage des hauteurs dans un snapshot.
+ */
+enum class SnapshotEncoding : uint32_t
+{
+    Float32 = 0, /**< Float 32 bits, identique à Terrain::mData */
+    Half = 1     /**< Demi-précision IEEE 754 (binary16) */
+};
+
+/**
+ * @brief Métadonnées sauvegardées avec le champ de hauteurs.
+ *
+ * generator reprend les valeurs de GenMethod (0 : heightmap, 1 : failles,
+ * 2 : midpoint, 3 : Perlin) ; params contient les paramètres du générateur
+ * dans l'ordre de sa fonction Create*. Les champs d'érosion permettent de
+ * reprendre une simulation interrompue avec le même paramétrage.
+ */
+struct SnapshotMetadata
+{
+    static constexpr int MAX_PARAMS = 8;
+
+    uint32_t generator = 0;              /**< Méthode de génération */
+    uint32_t seed = 0;                   /**< Graine utilisée à la génération */
+    float params[MAX_PARAMS] = {};       /**< Paramètres du générateur */
+    uint64_t erosionSteps = 0;           /**< Nombre de pas d'érosion appliqués */
+    float talusAngle = 0.0f;             /**< Angle de talus (degrés) */
+    float transferRate = 0.0f;           /**< Taux de transfert */
+    uint32_t neighborCount = 0;          /**< Voisinage (4 ou 8) */
+    uint32_t variant = 0;                /**< Variante de pas (ValidationTest::ThermalVariant) */
+};
+
+/**
+ * @brief Options d'écriture d'un snapshot.
+ */
+struct SnapshotOptions
+{
+    SnapshotEncoding encoding = SnapshotEncoding::Float32; /**< Encodage des hauteurs */
+    bool compress = false;                                  /**< Compression LZ par blocs */
+    int threads = 0;                                        /**< Threads d'encodage, 0 pour omp_get_max_threads() */
+};
+
+/**
+ * @class SnapshotView
+ * @brief Projection en lecture seule d'un snapshot
+ *
+ * Pour un snapshot Float32 non compressé, data() pointe directement dans
+ * le fichier mappé : aucune copie n'est faite tant qu'on ne lit pas les
+ * hauteurs.
+ */
+class SnapshotView
+{
+  public:
+    SnapshotView() = default;
+    ~SnapshotView();
+
+    SnapshotView(const SnapshotView &) = delete;
+    SnapshotView &operator=(const SnapshotView &) = delete;
+
+    /**
+     * @brief Mappe un fichier snapshot et valide son en-tête
+     */
+    bool open(const std::string &path);
+
+    void close();
+
+    int getWidth() const { return mWidth; }
+    int getHeight() const { return mHeight; }
+    const SnapshotMetadata &getMetadata() const { return mMetadata; }
+
+    /**
+     * @brief Accès direct aux hauteurs (Float32 non compressé uniquement)
+     * @return Pointeur dans le fichier mappé, nullptr sinon
+     */
+    const float *data() const;
+
+    /**
+     * @brief Décode les hauteurs dans un buffer de width * height floats
+     */
+    bool decode(float *out) const;
+
+  private:
+    const unsigned char *mMapping = nullptr;
+    std::size_t mMappingSize = 0;
+    int mWidth = 0;
+    int mHeight = 0;
+    SnapshotMetadata mMetadata;
+    uint32_t mEncoding = 0;
+    uint32_t mCompression = 0;
+    uint64_t mBlockCells = 0;
+    uint64_t mBlockCount = 0;
+    uint64_t mDataOffset = 0;
+};
+
+/**
+ * @class TerrainSnapshot
+ * @brief Format binaire versionné de sauvegarde d'un champ de hauteurs
+ *
+ * Le fichier contient un en-tête, une table de blocs puis les blocs de
+ * hauteurs. Les blocs sont encodés et compressés en parallèle puis
+ * recopiés directement dans le fichier mappé en écriture.
+ */
+class TerrainSnapshot
+{
+  public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint64_t BLOCK_CELLS = 1u << 18; /**< 256 Ki cellules par bloc */
+
+    /**
+     * @brief Écrit un snapshot
+     * @param path Fichier de sortie
+     * @param data Hauteurs (width * height)
+     * @param width Largeur du terrain
+     * @param height Hauteur du terrain
+     * @param metadata Paramètres de génération et d'érosion
+     * @param options Encodage et compression
+     * @return true si l'écriture a réussi
+     */
+    static bool save(const std::string &path, const float *data, int width, int height,
+                     const SnapshotMetadata &metadata, const SnapshotOptions &options = {});
+
+    /**
+     * @brief Lit un snapshot dans un vecteur
+     * @param path Fichier à lire
+     * @param data Hauteurs restaurées (redimensionné)
+     * @param width Largeur lue
+     * @param height Hauteur lue
+     * @param metadata Métadonnées lues (optionnel)
+     * @return true si la lecture a réussi
+     */
+    static bool load(const std::string &path, std::vector<float> &data, int &width, int &height,
+                     SnapshotMetadata *metadata = nullptr);
+
+    /**
+     * @brief Conversion float -> demi-précision (arrondi au plus proche)
+     */
+    static uint16_t floatToHalf(float value);
+
+    /**
+     * @brief Conversion demi-précision -> float
+     */
+    static float halfToFloat(uint16_t value);
+};
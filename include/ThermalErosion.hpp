@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Terrain.hpp"
+#include "DirtyTileSet.hpp"
+#include "ThermalKernel.hpp"
 #include <memory>
 #include <cmath>
 #include <vector>
@@ -10,24 +12,36 @@
 class ThermalErosion
 {
 public:
-    struct NeighborOffset
+    using NeighborOffset = ThermalKernel::NeighborOffset;
+
+    // Résidu d'un pas complet, calculé par le noyau lui-même
+    struct StepResidual
     {
-        int di;
-        int dj;
+        int cellsModified = 0;
+        float maxSlopeExcess = 0.f;  // plus grand dépassement du talus (pente - talus)
+        double movedMass = 0.0;      // matière retirée des cellules érodées
+        double depositedMass = 0.0;  // matière reçue par leurs voisins
+
+        // Bilan de masse du pas, sans relire la grille
+        double massBalance() const { return depositedMass - movedMass; }
     };
 
     ThermalErosion();
 
     void loadTerrainInfo(std::unique_ptr<Terrain>& terrain) {
-        m_data   = terrain->getData();
-        m_height = terrain->getTerrainHeight();
-        m_width  = terrain->getTerrainWidth();
+        loadGrid(terrain->getData(), terrain->getTerrainWidth(), terrain->getTerrainHeight());
+    }
 
-        mNbPatchX = (m_width + PATCH_SIZE - 1) / PATCH_SIZE;
-        mNbPatchZ = (m_height + PATCH_SIZE - 1) / PATCH_SIZE;
+    // Grille brute, sans Terrain (niveaux grossiers du solveur multigrille)
+    void loadGrid(std::vector<float>* data, int width, int height) {
+        m_data   = data;
+        m_height = height;
+        m_width  = width;
 
-        mPatchMarked.resize(mNbPatchX * mNbPatchZ, false);
+        ThermalKernel::indexOffsets(m_width, mNeighborCount, mNeighborIndexOffsets);
+        mDirtyTiles.resize(m_width, m_height, PATCH_SIZE);
 
+        mHasResidual = false;
         resetProgress();
     }
 
@@ -36,8 +50,15 @@ public:
         talusAngle = std::tan(angle * PI / 180.0f);
     }
 
+    // Pente de talus en hauteur par cellule (tangente de l'angle)
+    void setTalusSlope(float slope) { talusAngle = slope; }
+    float getTalusSlope() const { return talusAngle; }
+
     void setTransferRate(float c) { transferRate = c; }
 
+    float getTransferRate() const { return transferRate; }
+    int getNeighborCount() const { return mNeighborCount; }
+
     void useEightNeighbors();
     void useFourNeighbors();
 
@@ -53,7 +74,26 @@ public:
     int stepCheckerboardInPlaceParallel();
     void resetProgress();
 
+    /**
+     * Détente locale après une édition externe de la grille (pinceau) :
+     * jusqu'à maxSteps passes damier en place sur les cellules
+     * [rowMin, rowMax] x [colMin, colMax], arrêtées dès qu'une passe ne
+     * déplace plus rien. Les lignes touchées sont recopiées dans
+     * l'itération découpée en cours, s'il y en a une : l'appelant doit
+     * avoir appelé commitWorkingData() avant d'éditer la grille.
+     * Retourne le nombre de cellules érodées ; ni le résidu ni la liste
+     * des patches modifiés ne sont touchés.
+     */
+    int relaxRegion(int rowMin, int rowMax, int colMin, int colMax, int maxSteps);
+
     bool isIterationFinished() const { return mIterationFinished; }
+
+    // Convergence : le dernier pas complet ne dépasse plus le talus de plus
+    // que le seuil (0 = plus aucune cellule ne bouge)
+    void setConvergenceThreshold(float slopeExcess) { mConvergenceThreshold = slopeExcess; }
+    float getConvergenceThreshold() const { return mConvergenceThreshold; }
+    const StepResidual& getLastResidual() const { return mLastResidual; }
+    bool isConverged() const { return mHasResidual && mLastResidual.maxSlopeExcess <= mConvergenceThreshold; }
     bool needsVisualUpdate() const;
     void commitWorkingData();
 
@@ -61,9 +101,7 @@ public:
 
     void clearDirtyPatchIndices()
     {
-        for (int idx : mDirtyPatchIndices)
-            mPatchMarked[idx] = false;
-
+        mDirtyTiles.clear();
         mDirtyPatchIndices.clear();
     }
 
@@ -78,7 +116,13 @@ private:
     float talusAngle = 0.f;
     float transferRate = 0.f;
 
+    // Itération découpée (stepChunk) : m_workingData ne diffère de *m_data
+    // que sur les lignes [mDirtyRowBegin, mDirtyRowEnd), seules recopiées
+    // par commitWorkingData()
     std::vector<float> m_workingData;
+    bool mWorkingActive = false;
+    int mDirtyRowBegin = 0;
+    int mDirtyRowEnd = 0;
     int mCurrentIndex = 0;
     bool mIterationFinished = false;
 
@@ -86,31 +130,42 @@ private:
     int mCommitThreshold = 20000;
     bool mNeedsVisualUpdate = false;
 
+    // Patches modifiés : marqués sans verrou par les noyaux, une fois par
+    // bloc, puis listés dans mDirtyPatchIndices à la fin de chaque pas
+    DirtyTileSet mDirtyTiles;
     std::vector<int> mDirtyPatchIndices;
-    std::vector<bool> mPatchMarked;
-
-    int mNbPatchX = 0;
-    int mNbPatchZ = 0;
 
-    const NeighborOffset* mActiveNeighbors = nullptr;
     int mNeighborCount = 0;
+    int mNeighborIndexOffsets[8] = {0}; // décalages d'indice pour m_width
 
-    static const NeighborOffset kNeighbors8[8];
-    static const NeighborOffset kNeighbors4[4];
+    // Tampons des pas complets, conservés d'un pas à l'autre et placés une
+    // seule fois sur les noeuds NUMA (NumaPlacement) ; les deltas par thread
+    // sont remis à zéro par la réduction qui les consomme
+    std::vector<float> mSnapshot;
+    std::vector<float> mNextData;
+    std::vector<std::vector<float>> mThreadDeltas;
+
+    StepResidual mCurrentResidual;
+    StepResidual mLastResidual;
+    bool mHasResidual = false;
+    float mConvergenceThreshold = 0.f;
 
 private:
     inline int toIndex(int i, int j) const;
     inline void localIndexToCoords(int localIndex, int& i, int& j) const;
 
-    inline int patchIndexFromCell(int i, int j) const;
-    void markPatchDirtyFromCell(int i, int j);
+    void markRowsDirty(int startIndex, int endIndex);
+    void copyDirtyRows();
+
+    void prepareTwoPhaseBuffers();
+    void prepareThreadBuffers(int numThreads);
 
-    void addMaterialToNeighbor(float* dst,
-                               int neighborIndex,
-                               float moveAmount,
-                               int neighborI,
-                               int neighborJ);
+    inline void recordMove(float slopeExcess, float materialToMove, float deposited);
+    void publishResidual(int changes);
 
+    // Noyaux par cellule (ThermalKernel::erodeCell) : ne marquent pas les
+    // patches, l'appelant le fait une fois par bloc ou par ligne à partir des
+    // cellules modifiées
     bool erodeCell(int i, int j, const float* src, float* dst);
     bool erodeCellInPlace(int i, int j, float* data);
     int applyCheckerboardInPlaceColor(float* data, int color);
@@ -133,8 +188,7 @@ private:
                                            float* delta);
     int applyBlockedParallelErosionToThreadLocalBuffers(
         const float* src,
-        std::vector<std::vector<float>>& threadDeltas,
-        std::vector<std::vector<unsigned char>>& threadPatchMarked);
+        std::vector<std::vector<float>>& threadDeltas);
         int applyCheckerboardErosionRange(const float* src,
                                       float* dst,
                                       int color);
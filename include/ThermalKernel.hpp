@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+
+/**
+ * Noyau par cellule de l'érosion thermique, partagé par ThermalErosion,
+ * TiledThermalErosion et StreamingTerrain : les trois chemins appliquent la
+ * même formule, dans le même ordre de voisins, et donnent donc les mêmes
+ * arrondis.
+ */
+namespace ThermalKernel
+{
+struct NeighborOffset
+{
+    int di;
+    int dj;
+};
+
+/**
+ * Voisins dans l'ordre des dépôts : les quatre premiers sont les voisins
+ * directs (mode 4 voisins), les quatre suivants les diagonales.
+ */
+constexpr NeighborOffset kNeighbors[8] = {
+    {-1,  0},
+    { 1,  0},
+    { 0, -1},
+    { 0,  1},
+    {-1, -1},
+    {-1,  1},
+    { 1, -1},
+    { 1,  1}
+};
+
+/**
+ * @brief Décalages d'indice des count premiers voisins dans une grille de largeur stride
+ */
+inline void indexOffsets(int stride, int count, int *offsets)
+{
+    for (int k = 0; k < count; ++k)
+        offsets[k] = kNeighbors[k].di * stride + kNeighbors[k].dj;
+}
+
+/**
+ * @brief Bilan d'une cellule érodée
+ */
+struct CellMove
+{
+    float maxDiff = 0.f;   /**< Plus forte différence au-dessus du talus */
+    float moved = 0.f;     /**< Matière retirée de la cellule */
+    float deposited = 0.f; /**< Matière reçue par ses voisins */
+};
+
+/**
+ * @brief Érode la cellule center, mouvements transmis à un puits
+ *
+ * sink(index, quantité) reçoit -moved pour la cellule puis un dépôt par
+ * voisin sous le talus, dans l'ordre de kNeighbors. erodeCell() les ajoute
+ * à une grille ; un noyau parallèle peut les accumuler atomiquement.
+ *
+ * @param offsets Décalages d'indice des voisins (indexOffsets)
+ * @param count Nombre de voisins (4 ou 8)
+ * @return false si aucun voisin n'est sous le talus, move n'est alors pas rempli
+ */
+template <typename Sink>
+inline bool erodeCellTo(const float *src, int center, const int *offsets, int count,
+                        float talus, float transferRate, Sink &&sink, CellMove &move)
+{
+    const float currentHeight = src[center];
+
+    float totalDiff = 0.0f;
+    int validNeighbors = 0;
+    float maxDiff = 0.0f;
+    float diffs[8] = {0.0f};
+
+    for (int k = 0; k < count; ++k)
+    {
+        const float diff = currentHeight - src[center + offsets[k]];
+        diffs[k] = diff;
+
+        if (diff > talus) {
+            totalDiff += diff;
+            maxDiff = std::max(maxDiff, diff);
+            ++validNeighbors;
+        }
+    }
+
+    if (totalDiff <= 0.0f || validNeighbors <= 0)
+        return false;
+
+    float materialToMove = transferRate * (totalDiff / validNeighbors);
+    materialToMove = std::min(materialToMove, currentHeight * transferRate);
+
+    sink(center, -materialToMove);
+
+    const float invTotalDiff = 1.0f / totalDiff;
+    float deposited = 0.0f;
+
+    for (int k = 0; k < count; ++k)
+    {
+        if (diffs[k] > talus) {
+            const float moveAmount = materialToMove * (diffs[k] * invTotalDiff);
+            sink(center + offsets[k], moveAmount);
+            deposited += moveAmount;
+        }
+    }
+
+    move.maxDiff = maxDiff;
+    move.moved = materialToMove;
+    move.deposited = deposited;
+    return true;
+}
+
+/**
+ * @brief Érode la cellule center
+ *
+ * Les hauteurs sont lues dans src et les mouvements ajoutés à dst : dst
+ * peut être une copie (deux phases), src lui-même (en place) ou une grille
+ * de deltas nulle.
+ *
+ * @param offsets Décalages d'indice des voisins (indexOffsets)
+ * @param count Nombre de voisins (4 ou 8)
+ * @return false si aucun voisin n'est sous le talus, move n'est alors pas rempli
+ */
+inline bool erodeCell(const float *src, float *dst, int center, const int *offsets, int count,
+                      float talus, float transferRate, CellMove &move)
+{
+    return erodeCellTo(src, center, offsets, count, talus, transferRate,
+                       [dst](int index, float amount) { dst[index] += amount; }, move);
+}
+} // namespace ThermalKernel
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Encodage des échantillons d'un fichier de tuiles.
+ */
+enum class TileFormat : uint32_t
+{
+    Float32 = 0, /**< Hauteur brute en float (aucune perte) */
+    UInt16 = 1   /**< Hauteur quantifiée sur [minHeight, maxHeight] */
+};
+
+/**
+ * @brief En-tête binaire placé au début d'un fichier de tuiles.
+ *
+ * Chaque tuile occupe tileSize x tileSize échantillons (les tuiles de bord
+ * sont complétées) et commence sur une frontière de page, ce qui permet
+ * de paginer chaque tuile indépendamment avec madvise().
+ */
+struct TiledHeader
+{
+    char magic[8];        /**< "ERTILES" */
+    uint32_t version;     /**< Version du format */
+    uint32_t format;      /**< Valeur de TileFormat */
+    int32_t width;        /**< Largeur du terrain en cellules */
+    int32_t height;       /**< Hauteur du terrain en cellules */
+    int32_t tileSize;     /**< Côté d'une tuile en cellules */
+    int32_t nbTileX;      /**< Nombre de tuiles en X */
+    int32_t nbTileZ;      /**< Nombre de tuiles en Z */
+    float minHeight;      /**< Borne basse de quantification */
+    float maxHeight;      /**< Borne haute de quantification */
+    uint32_t reserved;    /**< Alignement */
+    uint64_t tileStride;  /**< Taille en octets d'une tuile (alignée page) */
+    uint64_t dataOffset;  /**< Décalage de la première tuile */
+};
+
+/**
+ * @class TiledHeightField
+ * @brief Terrain stocké sur disque en tuiles dans un unique fichier mappé
+ *
+ * Le fichier est projeté en mémoire avec mmap() : seules les pages
+ * effectivement touchées sont chargées par le noyau, ce qui permet de
+ * manipuler des terrains plus grands que la mémoire vive. Les tuiles
+ * sont rangées ligne par ligne (tz * nbTileX + tx), les cellules d'une
+ * tuile également (z * tileSize + x).
+ */
+class TiledHeightField
+{
+  public:
+    static constexpr uint32_t VERSION = 1;
+
+    TiledHeightField() = default;
+    ~TiledHeightField();
+
+    TiledHeightField(const TiledHeightField &) = delete;
+    TiledHeightField &operator=(const TiledHeightField &) = delete;
+
+    /**
+     * @brief Crée un nouveau fichier de tuiles (initialisé à minHeight)
+     * @param path Chemin du fichier
+     * @param width Largeur du terrain
+     * @param height Hauteur du terrain
+     * @param tileSize Côté d'une tuile
+     * @param format Encodage des échantillons
+     * @param minHeight Borne basse (quantification UInt16)
+     * @param maxHeight Borne haute (quantification UInt16)
+     * @return true si le fichier est créé et mappé
+     */
+    bool create(const std::string &path, int width, int height, int tileSize,
+                TileFormat format, float minHeight, float maxHeight);
+
+    /**
+     * @brief Ouvre et mappe un fichier de tuiles existant
+     * @param path Chemin du fichier
+     * @param writable Ouvre le fichier en lecture/écriture
+     * @return true si l'en-tête est valide
+     */
+    bool open(const std::string &path, bool writable = true);
+
+    /**
+     * @brief Synchronise et démappe le fichier
+     */
+    void close();
+
+    bool isOpen() const { return mMapping != nullptr; }
+    bool isWritable() const { return mWritable; }
+
+    int getWidth() const { return mHeader.width; }
+    int getHeight() const { return mHeader.height; }
+    int getTileSize() const { return mHeader.tileSize; }
+    int getNbTileX() const { return mHeader.nbTileX; }
+    int getNbTileZ() const { return mHeader.nbTileZ; }
+    TileFormat getFormat() const { return static_cast<TileFormat>(mHeader.format); }
+    float getMinHeight() const { return mHeader.minHeight; }
+    float getMaxHeight() const { return mHeader.maxHeight; }
+
+    /**
+     * @brief Décode une tuile complète dans un buffer float
+     * @param tx Indice X de la tuile
+     * @param tz Indice Z de la tuile
+     * @param out Buffer de tileSize * tileSize floats
+     */
+    void readTile(int tx, int tz, float *out) const;
+
+    /**
+     * @brief Encode une tuile complète depuis un buffer float
+     * @param tx Indice X de la tuile
+     * @param tz Indice Z de la tuile
+     * @param in Buffer de tileSize * tileSize floats
+     * @return false si le fichier a été ouvert en lecture seule
+     */
+    bool writeTile(int tx, int tz, const float *in);
+
+    /**
+     * @brief Indique au noyau qu'une tuile va être lue ou peut être libérée
+     * @param tx Indice X de la tuile
+     * @param tz Indice Z de la tuile
+     * @param willNeed true : MADV_WILLNEED, false : MADV_DONTNEED
+     */
+    void adviseTile(int tx, int tz, bool willNeed) const;
+
+    /**
+     * @brief Force l'écriture d'une tuile sur disque (msync)
+     */
+    void syncTile(int tx, int tz) const;
+
+    /**
+     * @brief Convertit une heightmap PNG (8 ou 16 bits) en fichier de tuiles
+     * @param pngPath Image source
+     * @param outPath Fichier de tuiles à créer
+     * @param tileSize Côté d'une tuile
+     * @param format Encodage des échantillons
+     * @return true si la conversion a réussi
+     */
+    static bool convertFromPng(const char *pngPath, const std::string &outPath,
+                               int tileSize = 256, TileFormat format = TileFormat::Float32);
+
+  private:
+    TiledHeader mHeader{};
+    int mFd = -1;
+    bool mWritable = false;
+    unsigned char *mMapping = nullptr;
+    std::size_t mMappingSize = 0;
+
+    unsigned char *tilePtr(int tx, int tz) const;
+    bool mapFile(bool writable);
+};
+
+/**
+ * @class TileCache
+ * @brief Cache LRU de tuiles décodées avec pagination explicite
+ *
+ * Une tuile est chargée (et décodée en float) à la première acquisition,
+ * reste épinglée tant qu'elle n'est pas relâchée, puis peut être évincée :
+ * elle est alors réécrite si elle a été modifiée et ses pages sont rendues
+ * au noyau (MADV_DONTNEED). Les accès sont protégés par un mutex.
+ *
+ * Sur un fichier ouvert en lecture seule, une tuile relâchée comme
+ * modifiée n'est jamais réécrite : l'éviction ou flush() le signalent.
+ */
+class TileCache
+{
+  public:
+    /**
+     * @param field Fichier de tuiles sous-jacent
+     * @param capacity Nombre maximal de tuiles décodées en mémoire
+     */
+    TileCache(TiledHeightField &field, int capacity);
+    ~TileCache();
+
+    /**
+     * @brief Épingle une tuile et retourne ses données décodées
+     * @return Pointeur vers tileSize * tileSize floats, nullptr si le cache est plein
+     */
+    float *acquire(int tx, int tz);
+
+    /**
+     * @brief Relâche une tuile épinglée
+     * @param dirty true si les données ont été modifiées
+     */
+    void release(int tx, int tz, bool dirty = false);
+
+    /**
+     * @brief Précharge (MADV_WILLNEED) les tuiles autour d'une cellule
+     * @param cellX Coordonnée X de la cellule
+     * @param cellZ Coordonnée Z de la cellule
+     * @param radiusTiles Rayon en tuiles
+     */
+    void prefetchAround(int cellX, int cellZ, int radiusTiles);
+
+    /**
+     * @brief Copie un rectangle de cellules, bornées aux bords du terrain
+     *
+     * Les tuiles recouvrant le rectangle sont préchargées puis épinglées
+     * une à une : un appel n'occupe jamais plus d'un emplacement du cache,
+     * et plusieurs threads peuvent lire en même temps.
+     *
+     * @param x0 Première colonne (peut être hors du terrain)
+     * @param z0 Première ligne (peut être hors du terrain)
+     * @param width Nombre de colonnes
+     * @param height Nombre de lignes
+     * @param out Reçoit width * height hauteurs, ligne par ligne
+     * @return false si une tuile n'a pas pu être acquise
+     */
+    bool readRegion(int x0, int z0, int width, int height, float *out);
+
+    /**
+     * @brief Réécrit toutes les tuiles modifiées
+     * @return false si une tuile n'a pas pu être réécrite (fichier en lecture seule)
+     */
+    bool flush();
+
+    int getCapacity() const { return static_cast<int>(mSlots.size()); }
+    long long getHits() const { return mHits; }
+    long long getMisses() const { return mMisses; }
+
+  private:
+    struct Slot
+    {
+        int tileIndex = -1;
+        int pins = 0;
+        bool dirty = false;
+        unsigned long long lastUse = 0;
+        std::vector<float> data;
+    };
+
+    TiledHeightField &mField;
+    std::vector<Slot> mSlots;
+    std::unordered_map<int, int> mSlotOfTile;
+    std::mutex mMutex;
+    unsigned long long mClock = 0;
+    long long mHits = 0;
+    long long mMisses = 0;
+
+    int findVictim() const;
+    bool writeBack(Slot &slot);
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ThermalKernel.hpp"
+#include "TiledHeightField.hpp"
+#include <vector>
+
+/**
+ * @class TiledThermalErosion
+ * @brief Érosion thermique hors-mémoire sur un TiledHeightField
+ *
+ * Chaque pas reproduit la sémantique deux phases de
+ * ThermalErosion::stepBlockedPureTwoPhase() : toutes les cellules lisent
+ * l'état du pas précédent. Une tuile est traitée dans une fenêtre élargie
+ * d'un halo de HALO cellules copié depuis ses voisines ; les résultats
+ * d'une rangée de tuiles restent en attente jusqu'à ce que la rangée
+ * suivante n'ait plus besoin de leurs valeurs d'origine comme halo.
+ *
+ * Les cellules sont érodées par ThermalKernel::erodeCell, comme dans
+ * ThermalErosion : le résultat est identique à celui de la grille en
+ * mémoire. Chaque thread n'épingle qu'une tuile à la fois ; le nombre de
+ * threads est borné par la capacité du cache.
+ */
+class TiledThermalErosion
+{
+  public:
+    static constexpr int HALO = 2;
+
+    /**
+     * @param field Fichier de tuiles à éroder
+     * @param cache Cache de tuiles associé au fichier
+     */
+    TiledThermalErosion(TiledHeightField &field, TileCache &cache);
+
+    void setTalusAngle(float angle);
+    void setTransferRate(float c) { mTransferRate = c; }
+
+    void useEightNeighbors();
+    void useFourNeighbors();
+
+    /**
+     * @brief Applique un pas d'érosion sur l'ensemble des tuiles
+     * @return Nombre de cellules modifiées, -1 si le fichier n'est pas
+     * ouvert en écriture ou si le cache n'a pas pu fournir une tuile (le pas est alors
+     * interrompu et le fichier partiellement mis à jour)
+     */
+    long long step();
+
+  private:
+    TiledHeightField &mField;
+    TileCache &mCache;
+
+    float mTalusAngle = 0.f;
+    float mTransferRate = 0.f;
+
+    int mNeighborCount = 0;
+
+    bool gatherWindow(int tx, int tz, std::vector<float> &window) const;
+    int erodeWindow(int tx, int tz, const std::vector<float> &src, std::vector<float> &dst) const;
+    bool storeTile(int tx, int tz, const std::vector<float> &tile);
+};
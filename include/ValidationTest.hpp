@@ -2,8 +2,12 @@
 
 #include "Terrain.hpp"
 #include "ThermalErosion.hpp"
+#include "MultigridThermalErosion.hpp"
+#include "PerfCounters.hpp"
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 class ValidationTest
@@ -24,12 +28,21 @@ public:
         EightNeighbors
     };
 
+    enum class ScalingMode {
+        Strong,
+        Weak
+    };
+
     struct RunMetrics
     {
         double totalTimeMs = 0.0;
         double avgTimePerStepMs = 0.0;
         float finalMassError = 0.0f;
         int lastCellsModified = 0;
+        int stepsRun = 0;
+        float finalMaxSlopeExcess = 0.0f;
+        float kernelMassError = 0.0f;
+        PerfCounters::Sample counters;
     };
 
     struct SummaryStats
@@ -46,20 +59,51 @@ public:
 
     static std::vector<float> initialData;
     static constexpr float TOLERANCE = 1e-4f;
+    // Pas entre deux contrôles de masse (plus le premier et le dernier pas)
+    static constexpr int MASS_CHECK_INTERVAL = 100;
 
     static float test_mass_conservation(std::vector<float>& finalData);
     static bool test_height_limits(std::vector<float>& finalData);
-    static float calculate_total_mass(const std::vector<float>& data);
+    static double calculate_total_mass(const std::vector<float>& data);
 
     static void run_all_tests(std::unique_ptr<Terrain>& terrain,
                               const std::string& terrainType,
                               int steps);
 
-private:
+    /**
+     * Passage à l'échelle des variantes parallèles sur 1, 2, 4, ... N threads
+     * (N = omp_get_max_threads()). En mode fort, le terrain de côté size est
+     * le même pour tous les nombres de threads ; en mode faible, size est le
+     * côté par thread et la grille contient threads * size * size cellules.
+     * makeTerrain(côté) fournit le terrain ; 0 désigne la taille par défaut.
+     */
+    static void run_scaling_tests(const std::function<std::unique_ptr<Terrain>(int)>& makeTerrain,
+                                  const std::string& terrainType,
+                                  int steps,
+                                  ScalingMode mode,
+                                  int size);
+
+    // Compteurs matériels autour de chaque run mesuré (désactivés par défaut)
+    static void enable_perf_counters(bool enabled) { perfCountersEnabled = enabled; }
+
     static int run_one_step(ThermalErosion& erosion, ThermalVariant variant);
     static std::string variant_to_string(ThermalVariant variant);
+    static bool variant_from_string(const std::string& name, ThermalVariant& variant);
+
+private:
+    static bool perfCountersEnabled;
+    static double machineBandwidth;
+
+    // Largeur d'émission supposée pour le plafond de calcul du roofline
+    static constexpr double NOMINAL_ISSUE_WIDTH = 4.0;
+
     static std::string neighborhood_to_string(NeighborhoodMode mode);
 
+    static double measure_memory_bandwidth();
+
+    // Coeur de chaque thread ("0;1;...") pour les CSV de passage à l'échelle
+    static std::string thread_cpu_list(int threads);
+
     static SummaryStats compute_summary_stats(const std::vector<double>& values);
 
     static void write_raw_runs_csv(const std::string& filepath,
@@ -69,12 +113,24 @@ private:
                                   const SummaryStats& totalStats,
                                   const SummaryStats& avgStepStats,
                                   const SummaryStats& massErrorStats,
-                                  const SummaryStats& lastCellsStats);
+                                  const SummaryStats& lastCellsStats,
+                                  const SummaryStats& stepsRunStats,
+                                  const std::vector<std::pair<std::string, SummaryStats>>& counterStats);
+
+    static void write_roofline_csv(const std::string& filepath,
+                                   const std::string& variantName,
+                                   const std::vector<RunMetrics>& runs,
+                                   double innerCells);
 
-    static void run_variant_tests(std::unique_ptr<Terrain>& terrain,
+    static bool run_variant_tests(std::unique_ptr<Terrain>& terrain,
                                   const std::vector<float>& referenceData,
                                   const std::string& terrainType,
                                   int steps,
                                   ThermalVariant variant,
                                   NeighborhoodMode neighborhood);
+
+    static void run_multigrid_test(std::unique_ptr<Terrain>& terrain,
+                                   const std::vector<float>& referenceData,
+                                   const std::string& terrainType,
+                                   int steps);
 };
\ No newline at end of file
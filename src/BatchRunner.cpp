@@ -0,0 +1,630 @@
+#include "BatchRunner.hpp"
+#include "ErosionCheckpointer.hpp"
+#include "FaultFormationTerrain.hpp"
+#include "MassReduction.hpp"
+#include "MidpointDisplacement.hpp"
+#include "PerlinNoiseTerrain.hpp"
+#include "ThermalErosion.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+std::mutex gLogMutex;
+
+// Même ordre que GenMethod, repris dans SnapshotMetadata::generator
+const std::map<std::string, uint32_t> kGenerators{
+    {"loadHeightmap", 0},
+    {"faultFormation", 1},
+    {"midpointDisplacement", 2},
+    {"perlinNoise", 3}
+};
+
+// Clés qui acceptent une liste de valeurs (balayage)
+const char *const kSweepKeys[] = {
+    "generator", "size", "seed", "steps", "variant", "neighbors", "talus", "rate"
+};
+
+void logLine(const std::string &label, const std::string &message)
+{
+    std::lock_guard<std::mutex> lock(gLogMutex);
+    std::cout << "[" << label << "] " << message << "\n";
+}
+
+std::string trim(const std::string &s)
+{
+    const std::size_t first = s.find_first_not_of(" \t\r");
+    if (first == std::string::npos)
+        return "";
+    const std::size_t last = s.find_last_not_of(" \t\r");
+    return s.substr(first, last - first + 1);
+}
+
+std::vector<std::string> splitList(const std::string &value)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+
+    while (std::getline(stream, item, ','))
+    {
+        item = trim(item);
+        if (!item.empty())
+            items.push_back(item);
+    }
+    return items;
+}
+
+bool isSweepKey(const std::string &key)
+{
+    return std::find(std::begin(kSweepKeys), std::end(kSweepKeys), key) != std::end(kSweepKeys);
+}
+
+bool parseInt(const std::string &value, int &out)
+{
+    char *end = nullptr;
+    const long v = std::strtol(value.c_str(), &end, 10);
+    if (end == value.c_str() || *end != '\0')
+        return false;
+    out = static_cast<int>(v);
+    return true;
+}
+
+bool parseFloat(const std::string &value, float &out)
+{
+    char *end = nullptr;
+    const float v = std::strtof(value.c_str(), &end);
+    if (end == value.c_str() || *end != '\0')
+        return false;
+    out = v;
+    return true;
+}
+
+/**
+ * Applique une valeur scalaire à une configuration.
+ */
+bool applyOption(BatchConfig &config, const std::string &key, const std::string &value)
+{
+    int i = 0;
+
+    if (key == "generator") {
+        if (kGenerators.find(value) == kGenerators.end())
+            return false;
+        config.generator = value;
+        return true;
+    }
+    if (key == "heightmap") {
+        config.heightmap = value;
+        return true;
+    }
+    if (key == "size")
+        return parseInt(value, config.size) && config.size >= 0;
+    if (key == "seed") {
+        if (!parseInt(value, i))
+            return false;
+        config.seed = static_cast<unsigned int>(i);
+        return true;
+    }
+    if (key == "steps")
+        return parseInt(value, config.steps) && config.steps > 0;
+    if (key == "variant")
+        return ValidationTest::variant_from_string(value, config.variant);
+    if (key == "neighbors")
+        return parseInt(value, config.neighborCount) && (config.neighborCount == 4 || config.neighborCount == 8);
+    if (key == "talus")
+        return parseFloat(value, config.talusAngle);
+    if (key == "rate")
+        return parseFloat(value, config.transferRate) && config.transferRate > 0.f && config.transferRate <= 1.f;
+    if (key == "threads")
+        return parseInt(value, config.threads) && config.threads >= 0;
+    if (key == "output") {
+        config.outputDir = value;
+        return true;
+    }
+    if (key == "checkpoint-every")
+        return parseInt(value, config.checkpointInterval) && config.checkpointInterval >= 0;
+
+    return false;
+}
+
+bool loadConfigFile(const std::string &path, std::vector<std::pair<std::string, std::string>> &options)
+{
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Erreur : impossible d'ouvrir " << path << "\n";
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+
+        const std::size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+
+        line = trim(line);
+        if (line.empty())
+            continue;
+
+        const std::size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            std::cerr << "Erreur : " << path << ":" << lineNumber << " : 'clé = valeur' attendu\n";
+            return false;
+        }
+
+        options.emplace_back(trim(line.substr(0, eq)), trim(line.substr(eq + 1)));
+    }
+
+    return true;
+}
+
+int processorCount()
+{
+#ifdef _OPENMP
+    return omp_get_num_procs();
+#else
+    return 1;
+#endif
+}
+} // namespace
+
+void BatchRunner::printUsage(const char *program)
+{
+    std::cout << "Usage: " << program << " run [--config <fichier>] [--<clé> <valeur> ...]\n";
+    std::cout << "  --generator        loadHeightmap | faultFormation | midpointDisplacement | perlinNoise\n";
+    std::cout << "  --heightmap        image lue par loadHeightmap\n";
+    std::cout << "  --size             côté du terrain (0 : taille par défaut du générateur)\n";
+    std::cout << "  --seed             graine du générateur\n";
+    std::cout << "  --steps            nombre de pas d'érosion\n";
+    std::cout << "  --variant          pureTwoPhase | blockedPureTwoPhase | blockedParallelPureTwoPhase | ...\n";
+    std::cout << "  --neighbors        4 | 8\n";
+    std::cout << "  --talus            angle de talus (degrés)\n";
+    std::cout << "  --rate             taux de transfert\n";
+    std::cout << "  --threads          threads OpenMP par job\n";
+    std::cout << "  --jobs             jobs simultanés\n";
+    std::cout << "  --output           dossier de sortie\n";
+    std::cout << "  --checkpoint-every pas entre deux checkpoints (0 : désactivé)\n";
+    std::cout << "generator, size, seed, steps, variant, neighbors, talus et rate acceptent une liste\n";
+    std::cout << "de valeurs séparées par des virgules : chaque combinaison devient un job.\n";
+}
+
+bool BatchRunner::parseArguments(const std::vector<std::string> &args, std::vector<BatchConfig> &jobs,
+                                 int &concurrentJobs)
+{
+    std::vector<std::pair<std::string, std::string>> options;
+
+    for (std::size_t i = 0; i < args.size(); ++i)
+    {
+        if (args[i].compare(0, 2, "--") != 0 || i + 1 >= args.size()) {
+            std::cerr << "Erreur : option invalide " << args[i] << "\n";
+            return false;
+        }
+
+        const std::string key = args[i].substr(2);
+        const std::string value = args[++i];
+
+        if (key == "config") {
+            if (!loadConfigFile(value, options))
+                return false;
+        } else {
+            options.emplace_back(key, value);
+        }
+    }
+
+    BatchConfig base;
+    base.checkpointInterval = 0;
+    concurrentJobs = 0;
+
+    bool checkpointGiven = false;
+
+    // Les valeurs vues en dernier l'emportent : la ligne de commande
+    // surcharge le fichier de configuration qui la précède.
+    std::vector<std::string> sweepOrder;
+    std::map<std::string, std::vector<std::string>> sweeps;
+
+    for (const auto &option : options)
+    {
+        const std::string &key = option.first;
+        const std::string &value = option.second;
+
+        if (key == "jobs") {
+            if (!parseInt(value, concurrentJobs) || concurrentJobs < 0) {
+                std::cerr << "Erreur : valeur invalide pour jobs : " << value << "\n";
+                return false;
+            }
+            continue;
+        }
+
+        if (isSweepKey(key)) {
+            const std::vector<std::string> values = splitList(value);
+            if (values.empty()) {
+                std::cerr << "Erreur : valeur manquante pour " << key << "\n";
+                return false;
+            }
+
+            BatchConfig probe;
+            for (const std::string &v : values) {
+                if (!applyOption(probe, key, v)) {
+                    std::cerr << "Erreur : valeur invalide pour " << key << " : " << v << "\n";
+                    return false;
+                }
+            }
+
+            if (sweeps.find(key) == sweeps.end())
+                sweepOrder.push_back(key);
+            sweeps[key] = values;
+            continue;
+        }
+
+        if (!applyOption(base, key, value)) {
+            std::cerr << "Erreur : option ou valeur invalide : " << key << " = " << value << "\n";
+            return false;
+        }
+        checkpointGiven |= (key == "checkpoint-every");
+    }
+
+    if (!checkpointGiven && !base.outputDir.empty())
+        base.checkpointInterval = 100;
+
+    // Produit cartésien des listes de valeurs
+    jobs.clear();
+    jobs.push_back(base);
+    std::vector<std::string> labels(1);
+
+    for (const std::string &key : sweepOrder)
+    {
+        const std::vector<std::string> &values = sweeps[key];
+        std::vector<BatchConfig> expanded;
+        std::vector<std::string> expandedLabels;
+
+        for (std::size_t j = 0; j < jobs.size(); ++j)
+        {
+            for (const std::string &value : values)
+            {
+                BatchConfig config = jobs[j];
+                applyOption(config, key, value);
+                expanded.push_back(config);
+                expandedLabels.push_back(values.size() > 1 ? labels[j] + "_" + key + value : labels[j]);
+            }
+        }
+
+        jobs.swap(expanded);
+        labels.swap(expandedLabels);
+    }
+
+    if (jobs.front().steps <= 0) {
+        std::cerr << "Erreur : --steps est obligatoire et doit être strictement positif\n";
+        return false;
+    }
+
+    const int procs = processorCount();
+    if (concurrentJobs <= 0)
+        concurrentJobs = std::min(static_cast<int>(jobs.size()), procs);
+    concurrentJobs = std::max(1, std::min(concurrentJobs, static_cast<int>(jobs.size())));
+
+    for (std::size_t j = 0; j < jobs.size(); ++j)
+    {
+        BatchConfig &config = jobs[j];
+
+        if (config.threads == 0)
+            config.threads = std::max(1, procs / concurrentJobs);
+
+        if (jobs.size() > 1) {
+            // job000, job001, ... : les dossiers de sortie restent triés
+            const std::string index = std::to_string(j);
+            config.label = "job" + std::string(index.size() < 3 ? 3 - index.size() : 0, '0') + index + labels[j];
+        }
+
+        if (!config.outputDir.empty()) {
+            if (jobs.size() > 1)
+                config.outputDir = (std::filesystem::path(config.outputDir) / config.label).string();
+            if (config.checkpointInterval > 0)
+                config.checkpointDir = (std::filesystem::path(config.outputDir) / "checkpoints").string();
+        }
+
+        config.metadata.generator = kGenerators.at(config.generator);
+        config.metadata.seed = config.seed;
+    }
+
+    return true;
+}
+
+std::unique_ptr<Terrain> BatchRunner::createTerrain(const std::string &generator, int size, uint32_t seed,
+                                                   const std::string &heightmap)
+{
+    const auto it = kGenerators.find(generator);
+    if (it == kGenerators.end()) {
+        std::cerr << "Heightmap non prise en charge" << std::endl;
+        return nullptr;
+    }
+
+    std::unique_ptr<Terrain> terrain;
+
+    switch (it->second)
+    {
+    case 0:
+        terrain = std::make_unique<Terrain>();
+        terrain->loadTerrain(heightmap.c_str(), 1.0f, 100.0f);
+        break;
+
+    case 1:
+    {
+        const int side = size > 0 ? size : 2048;
+        auto fault = std::make_unique<FaultFormationTerrain>();
+        fault->setSeed(seed);
+        fault->CreateFaultFormation(side, side, 1000, 0, 255, 1);
+        terrain = std::move(fault);
+        break;
+    }
+
+    case 2:
+    {
+        // Le midpoint displacement impose un côté de la forme 2^n + 1
+        int side = 2049;
+        if (size > 0) {
+            side = 2;
+            while (side + 1 < size)
+                side *= 2;
+            side += 1;
+        }
+        auto midpoint = std::make_unique<MidpointDisplacement>();
+        midpoint->setSeed(seed);
+        midpoint->CreateMidpointDisplacement(side, 0, 255, 1, 0.5);
+        terrain = std::move(midpoint);
+        break;
+    }
+
+    case 3:
+    {
+        const int side = size > 0 ? size : 5000;
+        auto perlin = std::make_unique<PerlinNoiseTerrain>();
+        perlin->setSeed(seed);
+        perlin->CreatePerlinNoise(side, side, 0, 255, 1, 0.005);
+        terrain = std::move(perlin);
+        break;
+    }
+    }
+
+    return terrain;
+}
+
+BatchResult BatchRunner::run(std::unique_ptr<Terrain> &terrain, BatchConfig config)
+{
+    BatchResult result;
+
+    if (!terrain || !terrain->getData() || terrain->getData()->empty()) {
+        std::cerr << "Erreur : terrain invalide dans BatchRunner::run.\n";
+        return result;
+    }
+
+    const int width = terrain->getTerrainWidth();
+    const int height = terrain->getTerrainHeight();
+    std::vector<float> &data = *terrain->getData();
+    const double initialMass = MassReduction::sum(data);
+
+    std::unique_ptr<ErosionCheckpointer> checkpointer;
+    uint64_t firstStep = 0;
+
+    if (!config.checkpointDir.empty() && config.checkpointInterval > 0) {
+        checkpointer = std::make_unique<ErosionCheckpointer>(config.checkpointDir, config.checkpointInterval);
+
+        SnapshotMetadata restored;
+        if (checkpointer->resume(data, width, height, restored)) {
+            // Une reprise poursuit la simulation interrompue : ses paramètres
+            // priment sur ceux de la ligne de commande.
+            firstStep = restored.erosionSteps;
+            config.talusAngle = restored.talusAngle;
+            config.transferRate = restored.transferRate;
+            config.neighborCount = static_cast<int>(restored.neighborCount);
+            if (restored.variant <= static_cast<uint32_t>(ValidationTest::ThermalVariant::CheckerboardInPlaceParallel))
+                config.variant = static_cast<ValidationTest::ThermalVariant>(restored.variant);
+            config.metadata = restored;
+        }
+    }
+
+    ThermalErosion erosion;
+    erosion.loadTerrainInfo(terrain);
+    erosion.setTalusAngle(config.talusAngle);
+    erosion.setTransferRate(config.transferRate);
+
+    if (config.neighborCount == 4) {
+        erosion.useFourNeighbors();
+    } else {
+        erosion.useEightNeighbors();
+    }
+
+    SnapshotMetadata metadata = config.metadata;
+    metadata.talusAngle = config.talusAngle;
+    metadata.transferRate = erosion.getTransferRate();
+    metadata.neighborCount = static_cast<uint32_t>(erosion.getNeighborCount());
+    metadata.variant = static_cast<uint32_t>(config.variant);
+
+    {
+        std::ostringstream msg;
+        msg << ValidationTest::variant_to_string(config.variant) << ", " << config.neighborCount
+            << " voisins, talus " << config.talusAngle << ", taux " << config.transferRate
+            << ", " << width << " x " << height << ", pas " << firstStep << " -> " << config.steps;
+        logLine(config.label, msg.str());
+    }
+
+    using clock = std::chrono::high_resolution_clock;
+    const uint64_t totalSteps = static_cast<uint64_t>(config.steps);
+
+    for (uint64_t step = firstStep; step < totalSteps; ++step)
+    {
+        const auto t0 = clock::now();
+        result.lastChanges = ValidationTest::run_one_step(erosion, config.variant);
+        const double stepMs = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+
+        result.totalMs += stepMs;
+
+        if (!checkpointer)
+            continue;
+
+        checkpointer->addStepTime(stepMs);
+
+        const uint64_t done = step + 1;
+        if (checkpointer->isDue(done) || done == totalSteps) {
+            // Le dernier état doit être sur disque même si l'écriture
+            // précédente n'est pas terminée.
+            if (done == totalSteps)
+                checkpointer->finish();
+
+            metadata.erosionSteps = done;
+            checkpointer->checkpoint(data.data(), width, height, metadata);
+
+            logLine(config.label, "pas " + std::to_string(done) + " : " + std::to_string(result.lastChanges)
+                                  + " cellules modifiees");
+        }
+    }
+
+    result.stepsRun = totalSteps > firstStep ? totalSteps - firstStep : 0;
+    result.massError = MassReduction::relativeError(initialMass, MassReduction::sum(data));
+    result.ok = true;
+
+    {
+        std::ostringstream msg;
+        msg << result.stepsRun << " pas en " << result.totalMs << " ms, erreur de masse "
+            << result.massError << ", " << result.lastChanges << " cellules modifiees au dernier pas";
+        logLine(config.label, msg.str());
+    }
+
+    if (checkpointer) {
+        checkpointer->finish();
+
+        std::ostringstream msg;
+        msg << "checkpoints : " << checkpointer->getWritten() << " ecrits, "
+            << checkpointer->getSkipped() << " ignores, " << checkpointer->getFailed()
+            << " en echec ; surcout " << checkpointer->getCaptureMs() << " ms ("
+            << 100.0 * checkpointer->getOverhead() << " % du calcul, intervalle final "
+            << checkpointer->getInterval() << ")";
+        logLine(config.label, msg.str());
+
+        if (checkpointer->getFailed() > 0)
+            result.ok = false;
+    }
+
+    if (!config.outputDir.empty()) {
+        metadata.erosionSteps = totalSteps;
+        const std::string path = (std::filesystem::path(config.outputDir) / "terrain.ersnap").string();
+        if (!TerrainSnapshot::save(path, data.data(), width, height, metadata))
+            result.ok = false;
+    }
+
+    return result;
+}
+
+BatchResult BatchRunner::runJob(const BatchConfig &config)
+{
+#ifdef _OPENMP
+    // Fixe la taille de l'équipe imbriquée de ce job
+    if (config.threads > 0)
+        omp_set_num_threads(config.threads);
+#endif
+
+    if (!config.outputDir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(config.outputDir, ec);
+        if (ec) {
+            std::cerr << "Erreur : impossible de créer " << config.outputDir << " : " << ec.message() << "\n";
+            return {};
+        }
+    }
+
+    using clock = std::chrono::high_resolution_clock;
+    const auto t0 = clock::now();
+
+    // Les générateurs tirent leurs nombres de CounterRng : les jobs peuvent
+    // générer en même temps, chacun avec sa graine.
+    std::unique_ptr<Terrain> terrain = createTerrain(config.generator, config.size, config.seed, config.heightmap);
+
+    const double generationMs = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+
+    if (!terrain)
+        return {};
+
+    BatchResult result = run(terrain, config);
+    result.generationMs = generationMs;
+    return result;
+}
+
+bool BatchRunner::runAll(const std::vector<BatchConfig> &jobs, int concurrentJobs)
+{
+    const int nbJobs = static_cast<int>(jobs.size());
+    std::vector<BatchResult> results(jobs.size());
+
+    std::cout << nbJobs << " job(s), " << concurrentJobs << " simultané(s)\n";
+
+#ifdef _OPENMP
+    // Niveau externe : un thread par job ; niveau imbriqué : les noyaux
+    // d'érosion de chaque job.
+    omp_set_max_active_levels(2);
+#endif
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(concurrentJobs)
+    for (int j = 0; j < nbJobs; ++j)
+    {
+        results[j] = runJob(jobs[j]);
+    }
+
+    bool ok = true;
+    for (const BatchResult &result : results)
+        ok = ok && result.ok;
+
+    if (!jobs.empty() && !jobs.front().outputDir.empty()) {
+        // Avec un balayage, chaque job écrit dans un sous-dossier de la sortie
+        std::filesystem::path root(jobs.front().outputDir);
+        if (jobs.size() > 1)
+            root = root.parent_path();
+
+        const std::string summaryPath = (root / "summary.csv").string();
+        std::ofstream out(summaryPath);
+        out << "job,label,generator,size,seed,variant,neighbors,talus,rate,steps,threads,"
+               "generation_ms,total_time_ms,avg_time_per_step_ms,final_mass_error,last_cells_modified,status\n";
+
+        for (int j = 0; j < nbJobs; ++j)
+        {
+            const BatchConfig &c = jobs[j];
+            const BatchResult &r = results[j];
+
+            out << j << ","
+                << c.label << ","
+                << c.generator << ","
+                << c.size << ","
+                << c.seed << ","
+                << ValidationTest::variant_to_string(c.variant) << ","
+                << c.neighborCount << ","
+                << c.talusAngle << ","
+                << c.transferRate << ","
+                << c.steps << ","
+                << c.threads << ","
+                << r.generationMs << ","
+                << r.totalMs << ","
+                << (r.stepsRun > 0 ? r.totalMs / static_cast<double>(r.stepsRun) : 0.0) << ","
+                << r.massError << ","
+                << r.lastChanges << ","
+                << (r.ok ? "ok" : "failed") << "\n";
+        }
+
+        std::cout << "Resume : " << summaryPath << "\n";
+    }
+
+    return ok;
+}
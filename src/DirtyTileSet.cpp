@@ -0,0 +1,71 @@
+#include "DirtyTileSet.hpp"
+
+void DirtyTileSet::resize(int width, int height, int tileSize)
+{
+    mWidth = std::max(0, width);
+    mHeight = std::max(0, height);
+    mTileSize = std::max(1, tileSize);
+    mTilesX = std::max(1, mWidth / mTileSize);
+    mTilesZ = std::max(1, mHeight / mTileSize);
+
+    mWordCount = (static_cast<std::size_t>(tileCount()) + 63) / 64;
+    mWords.reset(new std::atomic<uint64_t>[mWordCount]);
+    mCollected.assign(mWordCount, 0);
+
+    for (std::size_t w = 0; w < mWordCount; ++w)
+        mWords[w].store(0, std::memory_order_relaxed);
+}
+
+void DirtyTileSet::markCells(int iMin, int iMax, int jMin, int jMax)
+{
+    iMin = std::max(iMin, 0);
+    jMin = std::max(jMin, 0);
+    iMax = std::min(iMax, mHeight - 1);
+    jMax = std::min(jMax, mWidth - 1);
+
+    if (iMin > iMax || jMin > jMax)
+        return;
+
+    // Une cellule sur un bord de tuile (i % tileSize == 0) est aussi le
+    // dernier échantillon de la tuile précédente : on part de la tuile de
+    // la cellule i - 1.
+    const int tzMin = std::min(std::max(iMin - 1, 0) / mTileSize, mTilesZ - 1);
+    const int tzMax = std::min(iMax / mTileSize, mTilesZ - 1);
+    const int txMin = std::min(std::max(jMin - 1, 0) / mTileSize, mTilesX - 1);
+    const int txMax = std::min(jMax / mTileSize, mTilesX - 1);
+
+    for (int tx = txMin; tx <= txMax; ++tx)
+        for (int tz = tzMin; tz <= tzMax; ++tz)
+            markTile(tx * mTilesZ + tz);
+}
+
+void DirtyTileSet::collect(std::vector<int> &out)
+{
+    for (std::size_t w = 0; w < mWordCount; ++w)
+    {
+        uint64_t fresh = mWords[w].load(std::memory_order_relaxed) & ~mCollected[w];
+        if (!fresh)
+            continue;
+
+        mCollected[w] |= fresh;
+
+        while (fresh)
+        {
+            const int bit = __builtin_ctzll(fresh);
+            out.push_back(static_cast<int>(w * 64) + bit);
+            fresh &= fresh - 1;
+        }
+    }
+}
+
+void DirtyTileSet::clear()
+{
+    for (std::size_t w = 0; w < mWordCount; ++w)
+    {
+        if (mCollected[w] || mWords[w].load(std::memory_order_relaxed))
+        {
+            mWords[w].store(0, std::memory_order_relaxed);
+            mCollected[w] = 0;
+        }
+    }
+}
@@ -0,0 +1,274 @@
+#include "ErosionCheckpointer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace
+{
+const char *const kCheckpointPrefix = "checkpoint_";
+const char *const kCheckpointSuffix = ".ersnap";
+
+bool isCheckpointName(const std::string &name)
+{
+    const std::size_t prefix = std::strlen(kCheckpointPrefix);
+    const std::size_t suffix = std::strlen(kCheckpointSuffix);
+
+    return name.size() > prefix + suffix
+        && name.compare(0, prefix, kCheckpointPrefix) == 0
+        && name.compare(name.size() - suffix, suffix, kCheckpointSuffix) == 0;
+}
+
+/**
+ * Les noms contiennent le pas sur un nombre fixe de chiffres : l'ordre
+ * lexicographique est aussi l'ordre chronologique.
+ */
+std::vector<std::string> listCheckpoints(const std::string &directory)
+{
+    namespace fs = std::filesystem;
+
+    std::vector<std::string> names;
+    std::error_code ec;
+
+    for (const fs::directory_entry &entry : fs::directory_iterator(directory, ec))
+    {
+        const std::string name = entry.path().filename().string();
+        if (entry.is_regular_file(ec) && isCheckpointName(name))
+            names.push_back(name);
+    }
+
+    std::sort(names.begin(), names.end());
+    return names;
+}
+} // namespace
+
+ErosionCheckpointer::ErosionCheckpointer(const std::string &directory, int interval, int keep)
+    : mDirectory(directory), mInterval(interval), mKeep(std::max(1, keep))
+{
+    std::error_code ec;
+    std::filesystem::create_directories(mDirectory, ec);
+    if (ec)
+        std::cerr << "Error: cannot create checkpoint directory " << mDirectory << ": " << ec.message() << "\n";
+
+    mNextStep = static_cast<uint64_t>(std::max(0, mInterval));
+    mWriter = std::thread(&ErosionCheckpointer::writerLoop, this);
+}
+
+ErosionCheckpointer::~ErosionCheckpointer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondition.notify_all();
+
+    if (mWriter.joinable())
+        mWriter.join();
+}
+
+std::string ErosionCheckpointer::checkpointPath(uint64_t step) const
+{
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s%012llu%s", kCheckpointPrefix,
+                  static_cast<unsigned long long>(step), kCheckpointSuffix);
+    return (std::filesystem::path(mDirectory) / name).string();
+}
+
+bool ErosionCheckpointer::findLatest(const std::string &directory, std::string &path)
+{
+    const std::vector<std::string> names = listCheckpoints(directory);
+
+    // Un checkpoint illisible (disque plein, fichier tronqué à la main...)
+    // ne doit pas empêcher de repartir du précédent.
+    for (auto it = names.rbegin(); it != names.rend(); ++it)
+    {
+        const std::string candidate = (std::filesystem::path(directory) / *it).string();
+
+        SnapshotView view;
+        if (view.open(candidate))
+        {
+            path = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ErosionCheckpointer::resume(std::vector<float> &data, int width, int height, SnapshotMetadata &metadata)
+{
+    std::string path;
+    if (!findLatest(mDirectory, path))
+        return false;
+
+    std::vector<float> restored;
+    int restoredWidth = 0;
+    int restoredHeight = 0;
+    SnapshotMetadata restoredMetadata;
+
+    if (!TerrainSnapshot::load(path, restored, restoredWidth, restoredHeight, &restoredMetadata))
+        return false;
+
+    if (restoredWidth != width || restoredHeight != height)
+    {
+        std::cerr << "Error: checkpoint " << path << " is " << restoredWidth << " x " << restoredHeight
+                  << ", expected " << width << " x " << height << ".\n";
+        return false;
+    }
+
+    data.swap(restored);
+    metadata = restoredMetadata;
+    mNextStep = metadata.erosionSteps + static_cast<uint64_t>(std::max(0, mInterval));
+    mLastCaptureStep = metadata.erosionSteps;
+
+    std::cout << "Reprise depuis " << path << " (pas " << metadata.erosionSteps << ")\n";
+    return true;
+}
+
+bool ErosionCheckpointer::checkpoint(const float *data, int width, int height, const SnapshotMetadata &metadata)
+{
+    using clock = std::chrono::high_resolution_clock;
+    const auto t0 = clock::now();
+
+    int buffer;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        // Le thread d'E/S n'a pas encore pris la capture précédente : le
+        // disque ne suit pas, on saute ce checkpoint sans attendre.
+        if (mHasPending)
+        {
+            ++mSkipped;
+            mNextStep = metadata.erosionSteps + static_cast<uint64_t>(mInterval);
+            return false;
+        }
+
+        buffer = (mWritingBuffer == 0) ? 1 : 0;
+    }
+
+    // Le buffer choisi n'est lu par personne : copie sans verrou, répartie
+    // sur les threads de calcul pour rester proche de la bande passante.
+    const std::size_t count = static_cast<std::size_t>(width) * height;
+    std::vector<float> &capture = mBuffers[buffer];
+    capture.resize(count);
+
+    const std::size_t chunk = 1u << 16;
+    const long long nbChunks = static_cast<long long>((count + chunk - 1) / chunk);
+
+    #pragma omp parallel for schedule(static)
+    for (long long c = 0; c < nbChunks; ++c)
+    {
+        const std::size_t begin = static_cast<std::size_t>(c) * chunk;
+        const std::size_t n = std::min(chunk, count - begin);
+        std::memcpy(capture.data() + begin, data + begin, n * sizeof(float));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPending.buffer = buffer;
+        mPending.width = width;
+        mPending.height = height;
+        mPending.metadata = metadata;
+        mHasPending = true;
+    }
+    mCondition.notify_all();
+
+    const double captureMs = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+    mCaptureMs += captureMs;
+
+    // Intervalle adaptatif : si la copie dépasse le budget par rapport au
+    // calcul écoulé depuis la dernière capture, on espace les checkpoints.
+    // Les captures ignorées entre-temps comptent dans les pas écoulés.
+    const uint64_t stepsSinceCapture = metadata.erosionSteps - std::min(mLastCaptureStep, metadata.erosionSteps);
+
+    if (mStepMsSinceCapture > 0.0 && stepsSinceCapture > 0 && captureMs > MAX_OVERHEAD * mStepMsSinceCapture)
+    {
+        const double msPerStep = mStepMsSinceCapture / static_cast<double>(stepsSinceCapture);
+        const int needed = static_cast<int>(std::ceil(captureMs / (MAX_OVERHEAD * msPerStep)));
+        if (needed > mInterval)
+        {
+            std::cout << "Checkpoint : intervalle porte de " << mInterval << " a " << needed
+                      << " pas (copie " << captureMs << " ms)\n";
+            mInterval = needed;
+        }
+    }
+
+    mStepMsSinceCapture = 0.0;
+    mLastCaptureStep = metadata.erosionSteps;
+    mNextStep = metadata.erosionSteps + static_cast<uint64_t>(mInterval);
+
+    return true;
+}
+
+void ErosionCheckpointer::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (true)
+    {
+        mCondition.wait(lock, [this] { return mStop || mHasPending; });
+
+        if (!mHasPending)
+            break;
+
+        const Job job = mPending;
+        mHasPending = false;
+        mWritingBuffer = job.buffer;
+        lock.unlock();
+
+        // Un seul thread d'encodage : l'équipe OpenMP de la simulation
+        // garde tous les cœurs
+        SnapshotOptions options;
+        options.threads = 1;
+
+        const bool ok = TerrainSnapshot::save(checkpointPath(job.metadata.erosionSteps),
+                                              mBuffers[job.buffer].data(), job.width, job.height,
+                                              job.metadata, options);
+        if (ok)
+            prune();
+
+        lock.lock();
+        mWritingBuffer = -1;
+        if (ok)
+            ++mWritten;
+        else
+            ++mFailed;
+        mCondition.notify_all();
+    }
+}
+
+void ErosionCheckpointer::prune()
+{
+    const std::vector<std::string> names = listCheckpoints(mDirectory);
+
+    if (names.size() <= static_cast<std::size_t>(mKeep))
+        return;
+
+    for (std::size_t i = 0; i + mKeep < names.size(); ++i)
+    {
+        std::error_code ec;
+        std::filesystem::remove(std::filesystem::path(mDirectory) / names[i], ec);
+    }
+}
+
+void ErosionCheckpointer::finish()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCondition.wait(lock, [this] { return !mHasPending && mWritingBuffer < 0; });
+}
+
+int ErosionCheckpointer::getWritten() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mWritten;
+}
+
+int ErosionCheckpointer::getFailed() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFailed;
+}
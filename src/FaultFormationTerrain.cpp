@@ -1,8 +1,12 @@
 #include "FaultFormationTerrain.hpp"
+#include "CounterRng.hpp"
+#include "NumaPlacement.hpp"
 #include <algorithm>
 #include <utility>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
+#include <limits>
 #include <omp.h>
 
 FaultFormationTerrain::FaultFormationTerrain()
@@ -22,10 +26,14 @@ void FaultFormationTerrain::CreateFaultFormation(int width, int height, int iter
     this->mRenderer = (std::make_unique<RendererManager>(this));
 
     this->mData.assign(width * height, 0.0f);
+    NumaPlacement::place(mData);
 
-    CreateFaultFormationInternal(iterations, minHeight, maxHeight, applyFilter, filter);
+    float rawMin = 0.0f;
+    float rawMax = 0.0f;
 
-    Normalize();
+    CreateFaultFormationInternal(iterations, minHeight, maxHeight, applyFilter, filter, rawMin, rawMax);
+
+    normalizeHeights(rawMin, rawMax);
     
     createPatches();
 }
@@ -35,27 +43,62 @@ bool FaultFormationTerrain::TerrainPoint::IsEqual(TerrainPoint& p) const
     return (x == p.x) && (z == p.z);
 }
 
-void FaultFormationTerrain::CreateFaultFormationInternal(int iterations, float minHeight, float maxHeight, bool applyFilter, float filter)
+void FaultFormationTerrain::SetFaultMode(FaultMode mode)
+{
+    mFaultMode = mode;
+}
+
+void FaultFormationTerrain::CreateFaultFormationInternal(int iterations, float minHeight, float maxHeight, bool applyFilter, float filter,
+                                                         float& rawMin, float& rawMax)
 {
     const float deltaHeight = maxHeight - minHeight;
-    float* data = mData.data();
-    const int width = mWidth;
-    const int height = mHeight;
+
+    std::vector<FaultLine> faults(iterations);
 
     for (int curIter = 0; curIter < iterations; ++curIter)
     {
         const float iterationRatio = static_cast<float>(curIter) / static_cast<float>(iterations);
-        const float h = maxHeight - iterationRatio * deltaHeight;
 
         TerrainPoint p1, p2;
-        GenRandomTerrainPoints(p1, p2);
+        GenRandomTerrainPoints(curIter, p1, p2);
+
+        FaultLine& fault = faults[curIter];
+        fault.p1x = p1.x;
+        fault.p1z = p1.z;
+        fault.dirX = p2.x - p1.x;
+        fault.dirZ = p2.z - p1.z;
+        fault.h = maxHeight - iterationRatio * deltaHeight;
+    }
+
+    if (mFaultMode == FaultMode::RowEvents)
+        ApplyFaultsRowEvents(faults, rawMin, rawMax);
+    else
+        ApplyFaultsFullSweep(faults, rawMin, rawMax);
 
-        const int dirX = p2.x - p1.x;
-        const int dirZ = p2.z - p1.z;
-        const int p1x = p1.x;
-        const int p1z = p1.z;
+    if (applyFilter)
+        ApplyFIRFilter(filter, rawMin, rawMax);
+}
 
-        #pragma omp parallel for schedule(static)
+void FaultFormationTerrain::ApplyFaultsFullSweep(const std::vector<FaultLine>& faults, float& rawMin, float& rawMax)
+{
+    float* data = mData.data();
+    const int width = mWidth;
+    const int height = mHeight;
+
+    float lo = std::numeric_limits<float>::max();
+    float hi = std::numeric_limits<float>::lowest();
+
+    for (std::size_t f = 0; f < faults.size(); ++f)
+    {
+        const FaultLine& fault = faults[f];
+        const float h = fault.h;
+        const int dirX = fault.dirX;
+        const int dirZ = fault.dirZ;
+        const int p1x = fault.p1x;
+        const int p1z = fault.p1z;
+        const bool lastFault = (f + 1 == faults.size());
+
+        #pragma omp parallel for schedule(static) reduction(min:lo) reduction(max:hi)
         for (int z = 0; z < height; ++z)
         {
             const int rowOffset = z * width;
@@ -70,24 +113,118 @@ void FaultFormationTerrain::CreateFaultFormationInternal(int iterations, float m
                     data[rowOffset + x] += h;
                 }
             }
+
+            if (!lastFault)
+                continue;
+
+            #pragma omp simd reduction(min:lo) reduction(max:hi)
+            for (int x = 0; x < width; ++x)
+            {
+                lo = std::min(lo, data[rowOffset + x]);
+                hi = std::max(hi, data[rowOffset + x]);
+            }
         }
     }
 
-    if (applyFilter)
-        ApplyFIRFilter(filter);
+    rawMin = faults.empty() ? 0.0f : lo;
+    rawMax = faults.empty() ? 0.0f : hi;
 }
 
-void FaultFormationTerrain::GenRandomTerrainPoints(TerrainPoint& p1, TerrainPoint& p2)
+namespace
 {
-    p1.x = std::rand() % mWidth;
-    p1.z = std::rand() % mHeight;
+// Divisions entières arrondies vers -inf et +inf (d > 0)
+inline long long FloorDiv(long long n, long long d)
+{
+    return (n >= 0) ? n / d : -((-n + d - 1) / d);
+}
+
+inline long long CeilDiv(long long n, long long d)
+{
+    return -FloorDiv(-n, d);
+}
+} // namespace
+
+void FaultFormationTerrain::ApplyFaultsRowEvents(const std::vector<FaultLine>& faults, float& rawMin, float& rawMax)
+{
+    float* data = mData.data();
+    const int width = mWidth;
+    const int height = mHeight;
+
+    float lo = std::numeric_limits<float>::max();
+    float hi = std::numeric_limits<float>::lowest();
+
+    #pragma omp parallel reduction(min:lo) reduction(max:hi)
+    {
+        // events[x] holds the height change starting at column x
+        std::vector<double> events(width + 1);
+
+        #pragma omp for schedule(static)
+        for (int z = 0; z < height; ++z)
+        {
+            std::fill(events.begin(), events.end(), 0.0);
+
+            for (const FaultLine& fault : faults)
+            {
+                // cross(x) = a - dirZ * (x - p1x) > 0
+                const long long a = static_cast<long long>(fault.dirX) * (z - fault.p1z);
+                long long begin = 0;
+                long long end = width;
+
+                if (fault.dirZ == 0)
+                {
+                    if (a <= 0)
+                        continue;
+                }
+                else if (fault.dirZ > 0)
+                {
+                    // dirZ * (x - p1x) < a  <=>  x < p1x + ceil(a / dirZ)
+                    end = std::min<long long>(width, fault.p1x + CeilDiv(a, fault.dirZ));
+                }
+                else
+                {
+                    // -dirZ * (x - p1x) > -a  <=>  x > p1x + floor(-a / -dirZ)
+                    begin = std::max<long long>(0, fault.p1x + FloorDiv(-a, -fault.dirZ) + 1);
+                }
+
+                if (begin >= end)
+                    continue;
+
+                events[begin] += fault.h;
+                events[end] -= fault.h;
+            }
+
+            const int rowOffset = z * width;
+            double level = 0.0;
+
+            for (int x = 0; x < width; ++x)
+            {
+                level += events[x];
+
+                const float value = static_cast<float>(level);
+                data[rowOffset + x] = value;
+                lo = std::min(lo, value);
+                hi = std::max(hi, value);
+            }
+        }
+    }
+
+    rawMin = lo;
+    rawMax = hi;
+}
+
+void FaultFormationTerrain::GenRandomTerrainPoints(int iteration, TerrainPoint& p1, TerrainPoint& p2)
+{
+    const uint64_t stream = CounterRng::stream(CounterRng::FaultLines, iteration);
+
+    p1.x = CounterRng::below(mSeed, stream, 0, mWidth);
+    p1.z = CounterRng::below(mSeed, stream, 1, mHeight);
 
     int counter = 0;
 
     do
     {
-        p2.x = std::rand() % mWidth;
-        p2.z = std::rand() % mHeight;
+        p2.x = CounterRng::below(mSeed, stream, 2 * counter + 2, mWidth);
+        p2.z = CounterRng::below(mSeed, stream, 2 * counter + 3, mHeight);
 
         if (++counter == 1000)
         {
@@ -98,77 +235,89 @@ void FaultFormationTerrain::GenRandomTerrainPoints(TerrainPoint& p1, TerrainPoin
     } while (p1.IsEqual(p2));
 }
 
-void FaultFormationTerrain::Normalize()
+void FaultFormationTerrain::ApplyFIRFilter(float filter, float& rawMin, float& rawMax)
 {
-    auto minMax = std::minmax_element(mData.begin(), mData.end());
-
-    const float minVal = *minMax.first;
-    const float maxVal = *minMax.second;
-    const float minMaxDelta = maxVal - minVal;
-    const float minMaxRange = mMaxHeight - mMinHeight;
+    float* data = mData.data();
+    const int width = mWidth;
+    const int height = mHeight;
+    const float keep = 1.0f - filter;
 
-    if (minMaxDelta == 0.0f)
-    {
-        std::fill(mData.begin(), mData.end(), mMinHeight);
+    if (width <= 0 || height <= 0)
         return;
-    }
-
-    const float scale = minMaxRange / minMaxDelta;
 
+    // Horizontal passes: each row only depends on itself, so the
+    // left-to-right and right-to-left passes run back to back per row.
     #pragma omp parallel for schedule(static)
-    for (int i = 0; i < static_cast<int>(mData.size()); ++i)
-    {
-        mData[i] = (mData[i] - minVal) * scale + mMinHeight;
-    }
-}
-
-void FaultFormationTerrain::ApplyFIRFilter(float filter)
-{
-    for (int z = 0; z < mHeight; z++)
+    for (int z = 0; z < height; ++z)
     {
-        float PrevVal = getHeight(0, z);
+        float* row = data + static_cast<std::size_t>(z) * width;
 
-        for (int x = 1; x < mWidth; x++)
+        float prevVal = row[0];
+        for (int x = 1; x < width; ++x)
         {
-            PrevVal = FIRFilterSinglePoint(x, z, PrevVal, filter);
+            prevVal = filter * prevVal + keep * row[x];
+            row[x] = prevVal;
         }
-    }
-
-    for (int z = 0; z < mHeight; z++)
-    {
-        float PrevVal = getHeight(mWidth - 1, z);
 
-        for (int x = mWidth - 2; x >= 0; x--)
+        prevVal = row[width - 1];
+        for (int x = width - 2; x >= 0; --x)
         {
-            PrevVal = FIRFilterSinglePoint(x, z, PrevVal, filter);
+            prevVal = filter * prevVal + keep * row[x];
+            row[x] = prevVal;
         }
     }
 
-    for (int x = 0; x < mWidth; x++)
+    // Vertical passes: a strip of adjacent columns is filtered together,
+    // one row at a time, so accesses stay contiguous and the columns map
+    // to SIMD lanes. Both directions run per strip while it is in cache.
+    const int nbStrips = (width + FIR_STRIP_WIDTH - 1) / FIR_STRIP_WIDTH;
+
+    float lo = std::numeric_limits<float>::max();
+    float hi = std::numeric_limits<float>::lowest();
+
+    #pragma omp parallel for schedule(dynamic) reduction(min:lo) reduction(max:hi)
+    for (int s = 0; s < nbStrips; ++s)
     {
-        float PrevVal = getHeight(x, 0);
+        const int x0 = s * FIR_STRIP_WIDTH;
+        const int count = std::min(FIR_STRIP_WIDTH, width - x0);
+        float prevVal[FIR_STRIP_WIDTH];
 
-        for (int z = 1; z < mHeight; z++)
+        std::memcpy(prevVal, data + x0, count * sizeof(float));
+        for (int z = 1; z < height; ++z)
         {
-            PrevVal = FIRFilterSinglePoint(x, z, PrevVal, filter);
+            float* row = data + static_cast<std::size_t>(z) * width + x0;
+
+            #pragma omp simd
+            for (int i = 0; i < count; ++i)
+            {
+                prevVal[i] = filter * prevVal[i] + keep * row[i];
+                row[i] = prevVal[i];
+            }
         }
-    }
 
-    for (int x = 0; x < mWidth; x++)
-    {
-        float PrevVal = getHeight(x, mHeight - 1);
+        // The last row is final after the top-to-bottom pass
+        std::memcpy(prevVal, data + static_cast<std::size_t>(height - 1) * width + x0, count * sizeof(float));
+        for (int i = 0; i < count; ++i)
+        {
+            lo = std::min(lo, prevVal[i]);
+            hi = std::max(hi, prevVal[i]);
+        }
 
-        for (int z = mHeight - 2; z >= 0; z--)
+        for (int z = height - 2; z >= 0; --z)
         {
-            PrevVal = FIRFilterSinglePoint(x, z, PrevVal, filter);
+            float* row = data + static_cast<std::size_t>(z) * width + x0;
+
+            #pragma omp simd reduction(min:lo) reduction(max:hi)
+            for (int i = 0; i < count; ++i)
+            {
+                prevVal[i] = filter * prevVal[i] + keep * row[i];
+                row[i] = prevVal[i];
+                lo = std::min(lo, prevVal[i]);
+                hi = std::max(hi, prevVal[i]);
+            }
         }
     }
-}
 
-float FaultFormationTerrain::FIRFilterSinglePoint(int x, int z, float PrevVal, float filter)
-{
-    float CurVal = getHeight(x, z);
-    float NewVal = filter * PrevVal + (1.0f - filter) * CurVal;
-    setHeight(x, z, NewVal);
-    return NewVal;
-}
\ No newline at end of file
+    rawMin = lo;
+    rawMax = hi;
+}
@@ -0,0 +1,70 @@
+#include "GpuTimer.hpp"
+#include "Profiler.hpp"
+
+void GpuTimer::begin(const char *name)
+{
+    if (mActive >= 0 || !Profiler::isEnabled())
+        return;
+
+    int slot = -1;
+    for (int i = 0; i < static_cast<int>(mQueries.size()); ++i)
+    {
+        if (!mQueries[i].pending)
+        {
+            slot = i;
+            break;
+        }
+    }
+
+    if (slot < 0)
+    {
+        mQueries.emplace_back();
+        slot = static_cast<int>(mQueries.size()) - 1;
+        glGenQueries(1, &mQueries[slot].id);
+    }
+
+    mQueries[slot].name = name;
+    glBeginQuery(GL_TIME_ELAPSED, mQueries[slot].id);
+    mActive = slot;
+}
+
+void GpuTimer::end()
+{
+    if (mActive < 0)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    mQueries[mActive].pending = true;
+    mActive = -1;
+}
+
+void GpuTimer::collect()
+{
+    for (Query &query : mQueries)
+    {
+        if (!query.pending)
+            continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(query.id, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(query.id, GL_QUERY_RESULT, &elapsedNs);
+        Profiler::recordGpu(query.name, elapsedNs * 1e-6);
+        query.pending = false;
+    }
+}
+
+void GpuTimer::release()
+{
+    for (Query &query : mQueries)
+    {
+        if (query.id)
+            glDeleteQueries(1, &query.id);
+    }
+
+    mQueries.clear();
+    mActive = -1;
+}
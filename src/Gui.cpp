@@ -1,5 +1,6 @@
 #include "Gui.hpp"
 #include "Terrain.hpp" 
+#include "Profiler.hpp"
 
 #include <GL/glew.h> 
 #include "backends/imgui_impl_glfw.h"
@@ -41,6 +42,8 @@ void Gui::Init(GLFWwindow* window) {
 }
 
 void Gui::Render(Terrain* terrain) {
+    PROFILE_SCOPE("gui");
+
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -115,12 +118,21 @@ void Gui::Render(Terrain* terrain) {
             ImGui::Text("Chargement depuis un fichier image PNG.");
             const char* imgItems[] = { "canyon_heightmap.png", "fuji_heightmap.png", "paris_heightmap.png","helbert_heightmap.png","sopka_heightmap.png","grandCayon_heightmap.png"};
             ImGui::Combo("Fichier Source", &selectedImage, imgItems, 6);
+            ImGui::Checkbox("Fichier tuile (streaming)", &tiledStreaming);
+            HelpMarker("Affiche un fichier cree par la commande convert : seules les tuiles autour de la camera sont lues, via le cache de tuiles.");
+            if (tiledStreaming) {
+                ImGui::InputText("Fichier tuile", tiledFile, sizeof(tiledFile));
+                ImGui::SliderInt("Rayon de vue (tuiles)", &streamRadius, 4, 48);
+                ImGui::SliderInt("Pas d'erosion par tuile", &streamErosionSteps, 0, 32);
+            }
         }
         else if (selectedMethod == GEN_FAULT_FORMATION) {
             ImGui::Text("Generation procedurale par failles.");
             ImGui::InputInt("Largeur (X)", &faultWidth);
             ImGui::InputInt("Hauteur (Z)", &faultHeight);
             ImGui::InputInt("Iterations", &faultIterations, 10, 100);
+            ImGui::Checkbox("Mode rapide (par lignes)", &faultRowEvents);
+            HelpMarker("Calcule les failles ligne par ligne : O(H x (W + iterations)) au lieu de O(W x H x iterations).");
             ImGui::DragFloatRange2("Hauteur Min/Max", &faultMinHeight, &faultMaxHeight, 1.0f, 0.0f, 500.0f);
             
             ImGui::Checkbox("Appliquer Filtre Lissage", &faultUseFilter);
@@ -135,6 +147,13 @@ void Gui::Render(Terrain* terrain) {
             
             ImGui::SliderFloat("Rugosite (Roughness)", &midpointRoughness, 0.0f, 2.0f);
             ImGui::DragFloatRange2("Hauteur Min/Max", &midpointMinHeight, &midpointMaxHeight, 1.0f, 0.0f, 500.0f);
+            ImGui::Checkbox("Streaming par tuiles", &midpointStreaming);
+            HelpMarker("Genere seulement les tuiles de 32x32 autour de la camera, erodees avant affichage. Permet des tailles bien plus grandes (ex: 65537) ; au-dela du bord, la derniere cellule est repetee.");
+            if (midpointStreaming) {
+                ImGui::SliderInt("Rayon de vue (tuiles)", &streamRadius, 4, 48);
+                ImGui::SliderInt("Pas d'erosion par tuile", &streamErosionSteps, 0, 32);
+                HelpMarker("Utilise l'angle de talus et le taux de transfert de la simulation.");
+            }
         }
         else if (selectedMethod == GEN_PERLIN_NOISE) {
             ImGui::Text("Generation procedurale par Bruit de Perlin.");
@@ -147,6 +166,32 @@ void Gui::Render(Terrain* terrain) {
             ImGui::SliderInt("Octaves", &perlinOctaves, 1, 10);
             ImGui::SliderFloat("Persistance", &perlinPersistence, 0.1f, 1.5f);
             ImGui::SliderFloat("Lacunarite", &perlinLacunarity, 1.0f, 5.0f);
+
+            const char* noiseTypes[] = { "fBm", "Multifractal ridged", "Multifractal hybride" };
+            ImGui::Combo("Type de bruit", &perlinType, noiseTypes, IM_ARRAYSIZE(noiseTypes));
+            if (perlinType != 0) {
+                ImGui::SliderFloat("Decalage (offset)", &perlinOffset, 0.0f, 2.0f);
+                if (perlinType == 1)
+                    ImGui::SliderFloat("Gain", &perlinGain, 0.5f, 4.0f);
+                HelpMarker("Ridged : cretes vives. Hybride : vallees lisses, sommets rugueux.");
+            }
+            ImGui::Checkbox("Deformation du domaine (warp)", &perlinWarp);
+            if (perlinWarp)
+                ImGui::SliderFloat("Intensite du warp", &perlinWarpStrength, 0.0f, 4.0f);
+            ImGui::Checkbox("Noyau vectoriel", &perlinVectorized);
+            HelpMarker("Evalue 16 echantillons par appel avec des gradients haches (SIMD). Le terrain differe du noyau scalaire pour une meme graine. Ridged, hybride et warp utilisent toujours ce noyau.");
+            ImGui::Checkbox("Monde infini (streaming)", &perlinStreaming);
+            HelpMarker("Genere des tuiles de 32x32 autour de la camera en arriere-plan, erodees avant affichage. Largeur et hauteur sont ignorees.");
+            if (perlinStreaming) {
+                ImGui::SliderInt("Rayon de vue (tuiles)", &streamRadius, 4, 48);
+                ImGui::SliderInt("Pas d'erosion par tuile", &streamErosionSteps, 0, 32);
+                HelpMarker("Utilise l'angle de talus et le taux de transfert de la simulation.");
+            }
+        }
+
+        if (selectedMethod != GEN_HEIGHTMAP) {
+            ImGui::InputInt("Graine", &seed);
+            HelpMarker("Meme graine et memes parametres : meme terrain, quel que soit le nombre de threads.");
         }
 
         ImGui::Spacing();
@@ -215,6 +260,21 @@ void Gui::Render(Terrain* terrain) {
                     ImGui::Text("Cellules modifiees : %d", thermalCellsModified);
                 }
 
+                if (ImGui::CollapsingHeader("Sculpture"))
+                {
+                    const char* brushModes[] = {"Elever", "Abaisser", "Lisser", "Aplanir"};
+
+                    ImGui::Checkbox("Pinceau (clic gauche)", &brushEnabled);
+                    ImGui::Combo("Outil", &brushMode, brushModes, IM_ARRAYSIZE(brushModes));
+                    ImGui::SliderFloat("Rayon", &brushRadius, 1.0f, 64.0f, "%.0f cellules");
+                    ImGui::SliderFloat("Force", &brushStrength, 0.0f, brushMode < 2 ? 10.0f : 1.0f);
+                    ImGui::SliderFloat("Attenuation", &brushFalloff, 0.0f, 1.0f);
+                    ImGui::SliderInt("Passes de detente", &brushRelaxSteps, 0, 32);
+                    ImGui::SliderInt("Marge de detente", &brushRelaxHalo, 0, 32);
+
+                    ImGui::Text("Dernier coup       : %.2f ms (%d patches)", brushLastMs, brushLastPatches);
+                }
+
                 /*
                 if (ImGui::CollapsingHeader("Erosion Hydraulique"))
                 {
@@ -247,9 +307,15 @@ void Gui::Render(Terrain* terrain) {
                 ImGui::Text("Mouse :");
                 ImGui::BulletText("Move mouse : Rotate camera");
                 ImGui::BulletText("Scroll wheel : Zoom in/out");
+                ImGui::BulletText("Left click : Sculpt (brush enabled, menu shown)");
                 
                 ImGui::Separator();
-                if (terrain != nullptr) {
+                ImGui::Checkbox("Profileur (F3)", &showProfiler);
+                ImGui::Separator();
+                if (streamingActive) {
+                     ImGui::Text("Tuiles chargees : %d (en attente : %d)", streamResidentTiles, streamPendingTiles);
+                }
+                else if (terrain != nullptr) {
                      ImGui::Text("Taille Terrain: %d x %d", terrain->getTerrainWidth(), terrain->getTerrainHeight());
                 }
                 ImGui::EndTabItem();
@@ -258,12 +324,73 @@ void Gui::Render(Terrain* terrain) {
             ImGui::EndTabBar();
         }
         ImGui::End();
+
+        if (showProfiler)
+            RenderProfilerOverlay();
     }
 
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
+void Gui::RenderProfilerOverlay() {
+    ImGuiIO& io = ImGui::GetIO();
+
+    ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x - 10.0f, 10.0f), ImGuiCond_FirstUseEver, ImVec2(1.0f, 0.0f));
+    ImGui::SetNextWindowSize(ImVec2(420, 360), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.85f);
+
+    if (!ImGui::Begin("Profileur", &showProfiler)) {
+        ImGui::End();
+        return;
+    }
+
+    bool enabled = Profiler::isEnabled();
+    if (ImGui::Checkbox("Mesurer", &enabled))
+        Profiler::setEnabled(enabled);
+
+    const Profiler::PhaseStats& frame = Profiler::getFrameStats();
+    const int offset = Profiler::frameIndex() % Profiler::HISTORY_FRAMES;
+
+    ImGui::Text("Image : %.2f ms (moy. %.2f, max %.2f)", frame.lastMs, frame.avgMs, frame.maxMs);
+    ImGui::PlotLines("##frame", frame.history, Profiler::HISTORY_FRAMES, offset,
+                     nullptr, 0.0f, static_cast<float>(frame.maxMs) * 1.1f, ImVec2(-1, 50));
+
+    // Temps CPU cumulés sur les threads, temps GPU avec quelques images de retard
+    if (ImGui::BeginTable("##phases", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+        ImGui::TableSetupColumn("Phase");
+        ImGui::TableSetupColumn("ms");
+        ImGui::TableSetupColumn("moy.");
+        ImGui::TableSetupColumn("max");
+        ImGui::TableHeadersRow();
+
+        for (const Profiler::PhaseStats& phase : Profiler::getPhases()) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            if (phase.gpu)
+                ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "GPU %s", phase.name.c_str());
+            else
+                ImGui::Text("%s", phase.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", phase.lastMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", phase.avgMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", phase.maxMs);
+        }
+
+        ImGui::EndTable();
+    }
+
+    ImGui::Separator();
+    ImGui::InputText("Fichier", traceFile, sizeof(traceFile));
+    if (ImGui::Button("Exporter la trace Chrome"))
+        Profiler::exportChromeTrace(traceFile);
+    HelpMarker("Derniers evenements de chaque thread, a ouvrir dans chrome://tracing ou ui.perfetto.dev.");
+
+    ImGui::End();
+}
+
 void Gui::Shutdown() {
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
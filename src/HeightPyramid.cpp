@@ -0,0 +1,388 @@
+#include "HeightPyramid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+// Décalage (en cellules) du point courant dans le sens du rayon : le noeud
+// choisi est celui dans lequel le rayon entre, pas celui qu'il quitte
+constexpr float kNudge = 1e-3f;
+
+float nudged(float position, float direction)
+{
+    return position + (direction > 0.0f ? kNudge : (direction < 0.0f ? -kNudge : 0.0f));
+}
+
+// Sortie du rayon de la dalle [lo, hi] d'un axe (infini si le rayon y est parallèle)
+float slabExit(float origin, float direction, float lo, float hi)
+{
+    if (direction > 0.0f)
+        return (hi - origin) / direction;
+    if (direction < 0.0f)
+        return (lo - origin) / direction;
+    return std::numeric_limits<float>::max();
+}
+
+/**
+ * Plus petite racine dans [0, sMax] de a + b s + c s^2, sachant a > 0 ;
+ * le rayon passe sous la surface au premier passage à zéro.
+ */
+bool firstRoot(float a, float b, float c, float sMax, float &s)
+{
+    if (std::abs(c) < 1e-12f)
+    {
+        if (b >= 0.0f)
+            return false;
+
+        s = -a / b;
+        return s <= sMax;
+    }
+
+    const float discriminant = b * b - 4.0f * a * c;
+    if (discriminant < 0.0f)
+        return false;
+
+    // Forme stable : q = -(b + signe(b) sqrt(delta)) / 2, racines q / c et a / q
+    const float root = std::sqrt(discriminant);
+    const float q = -0.5f * (b + (b >= 0.0f ? root : -root));
+
+    float r0 = (q != 0.0f) ? q / c : std::numeric_limits<float>::max();
+    float r1 = (q != 0.0f) ? a / q : std::numeric_limits<float>::max();
+    if (r0 > r1)
+        std::swap(r0, r1);
+
+    if (r0 >= 0.0f && r0 <= sMax)
+    {
+        s = r0;
+        return true;
+    }
+    if (r1 >= 0.0f && r1 <= sMax)
+    {
+        s = r1;
+        return true;
+    }
+    return false;
+}
+} // namespace
+
+void HeightPyramid::build(const float *data, int width, int height)
+{
+    mWidth = width;
+    mHeight = height;
+    mLevels.clear();
+    mLevelWidth.clear();
+    mLevelHeight.clear();
+
+    if (!data || width < 2 || height < 2)
+        return;
+
+    int levelWidth = (width - 1 + LEAF - 1) / LEAF;
+    int levelHeight = (height - 1 + LEAF - 1) / LEAF;
+
+    while (true)
+    {
+        mLevelWidth.push_back(levelWidth);
+        mLevelHeight.push_back(levelHeight);
+        mLevels.emplace_back(static_cast<std::size_t>(levelWidth) * levelHeight);
+
+        if (levelWidth == 1 && levelHeight == 1)
+            break;
+
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+
+    refreshRange(data, 0, mLevelWidth[0] - 1, 0, mLevelHeight[0] - 1);
+}
+
+HeightPyramid::Bounds HeightPyramid::leafBounds(const float *data, int nx, int nz) const
+{
+    const int xBegin = nx * LEAF;
+    const int zBegin = nz * LEAF;
+    const int xEnd = std::min(xBegin + LEAF, mWidth - 1);
+    const int zEnd = std::min(zBegin + LEAF, mHeight - 1);
+
+    Bounds bounds{std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+
+    for (int z = zBegin; z <= zEnd; ++z)
+    {
+        const float *row = data + static_cast<std::size_t>(z) * mWidth;
+        for (int x = xBegin; x <= xEnd; ++x)
+        {
+            bounds.lo = std::min(bounds.lo, row[x]);
+            bounds.hi = std::max(bounds.hi, row[x]);
+        }
+    }
+
+    return bounds;
+}
+
+void HeightPyramid::refreshRange(const float *data, int nxMin, int nxMax, int nzMin, int nzMax)
+{
+    std::vector<Bounds> &leaves = mLevels[0];
+    const int leafWidth = mLevelWidth[0];
+
+    #pragma omp parallel for schedule(static) if ((nzMax - nzMin) * (nxMax - nxMin) > 4096)
+    for (int nz = nzMin; nz <= nzMax; ++nz)
+        for (int nx = nxMin; nx <= nxMax; ++nx)
+            leaves[static_cast<std::size_t>(nz) * leafWidth + nx] = leafBounds(data, nx, nz);
+
+    for (std::size_t level = 1; level < mLevels.size(); ++level)
+    {
+        const std::vector<Bounds> &children = mLevels[level - 1];
+        const int childWidth = mLevelWidth[level - 1];
+        const int childHeight = mLevelHeight[level - 1];
+        const int levelWidth = mLevelWidth[level];
+
+        nxMin /= 2;
+        nxMax /= 2;
+        nzMin /= 2;
+        nzMax /= 2;
+
+        for (int nz = nzMin; nz <= nzMax; ++nz)
+        {
+            for (int nx = nxMin; nx <= nxMax; ++nx)
+            {
+                Bounds bounds = children[static_cast<std::size_t>(2 * nz) * childWidth + 2 * nx];
+
+                for (int cz = 2 * nz; cz <= std::min(2 * nz + 1, childHeight - 1); ++cz)
+                    for (int cx = 2 * nx; cx <= std::min(2 * nx + 1, childWidth - 1); ++cx)
+                    {
+                        const Bounds &child = children[static_cast<std::size_t>(cz) * childWidth + cx];
+                        bounds.lo = std::min(bounds.lo, child.lo);
+                        bounds.hi = std::max(bounds.hi, child.hi);
+                    }
+
+                mLevels[level][static_cast<std::size_t>(nz) * levelWidth + nx] = bounds;
+            }
+        }
+    }
+}
+
+void HeightPyramid::update(const float *data, int xMin, int xMax, int zMin, int zMax)
+{
+    if (mLevels.empty())
+        return;
+
+    // Une cellule appartient aux quads qui la précèdent et qui la suivent
+    const int qxMin = std::max(xMin - 1, 0);
+    const int qxMax = std::min(xMax, mWidth - 2);
+    const int qzMin = std::max(zMin - 1, 0);
+    const int qzMax = std::min(zMax, mHeight - 2);
+
+    if (qxMin > qxMax || qzMin > qzMax)
+        return;
+
+    refreshRange(data, qxMin / LEAF, qxMax / LEAF, qzMin / LEAF, qzMax / LEAF);
+}
+
+void HeightPyramid::updateTiles(const float *data, const std::vector<int> &tiles, int tileSize, int tilesZ)
+{
+    if (mLevels.empty() || tileSize <= 0)
+        return;
+
+    // Une grille plus petite qu'une tuile forme une seule tuile, comme dans DirtyTileSet
+    const int tilesX = std::max(1, mWidth / tileSize);
+    tilesZ = std::max(1, tilesZ);
+
+    for (int tile : tiles)
+    {
+        const int tx = tile / tilesZ;
+        const int tz = tile % tilesZ;
+        const int xMax = (tx + 1 >= tilesX) ? mWidth - 1 : (tx + 1) * tileSize;
+        const int zMax = (tz + 1 >= tilesZ) ? mHeight - 1 : (tz + 1) * tileSize;
+        update(data, tx * tileSize, xMax, tz * tileSize, zMax);
+    }
+}
+
+float HeightPyramid::surfaceHeight(const float *data, float x, float z) const
+{
+    x = std::clamp(x, 0.0f, static_cast<float>(mWidth - 1));
+    z = std::clamp(z, 0.0f, static_cast<float>(mHeight - 1));
+
+    const int qx = std::min(static_cast<int>(x), mWidth - 2);
+    const int qz = std::min(static_cast<int>(z), mHeight - 2);
+    const float u = x - qx;
+    const float v = z - qz;
+
+    const float *row = data + static_cast<std::size_t>(qz) * mWidth + qx;
+    const float top = row[0] + (row[1] - row[0]) * u;
+    const float bottom = row[mWidth] + (row[mWidth + 1] - row[mWidth]) * u;
+    return top + (bottom - top) * v;
+}
+
+bool HeightPyramid::intersectLeaf(const float *data, int nx, int nz, const float o[3], const float d[3],
+                                  float tBegin, float tEnd, float &tHit) const
+{
+    const int qxMin = nx * LEAF;
+    const int qzMin = nz * LEAF;
+    const int qxMax = std::min(qxMin + LEAF, mWidth - 1) - 1;
+    const int qzMax = std::min(qzMin + LEAF, mHeight - 1) - 1;
+    const float dMax = std::max(std::abs(d[0]), std::abs(d[2]));
+
+    float t = tBegin;
+
+    while (true)
+    {
+        const float px = o[0] + d[0] * t;
+        const float pz = o[2] + d[2] * t;
+        const int qx = std::clamp(static_cast<int>(std::floor(nudged(px, d[0]))), qxMin, qxMax);
+        const int qz = std::clamp(static_cast<int>(std::floor(nudged(pz, d[2]))), qzMin, qzMax);
+
+        float tQuad = std::min({tEnd, slabExit(o[0], d[0], static_cast<float>(qx), static_cast<float>(qx + 1)),
+                                slabExit(o[2], d[2], static_cast<float>(qz), static_cast<float>(qz + 1))});
+        if (!(tQuad > t))
+            tQuad = std::min(tEnd, t + kNudge / std::max(dMax, 1e-12f));
+
+        const float *row = data + static_cast<std::size_t>(qz) * mWidth + qx;
+        const float h00 = row[0];
+        const float h10 = row[1];
+        const float h01 = row[mWidth];
+        const float h11 = row[mWidth + 1];
+
+        const float yBegin = o[1] + d[1] * t;
+        const float yEnd = o[1] + d[1] * tQuad;
+
+        if (std::min(yBegin, yEnd) <= std::max({h00, h10, h01, h11}))
+        {
+            // Hauteur bilinéaire le long du rayon : h(s) = h0 + h1 s + h2 s^2, s = t' - t
+            const float u = px - qx;
+            const float v = pz - qz;
+            const float k1 = h10 - h00;
+            const float k2 = h01 - h00;
+            const float k3 = h00 - h10 - h01 + h11;
+
+            const float a = yBegin - (h00 + k1 * u + k2 * v + k3 * u * v);
+            const float b = d[1] - (k1 * d[0] + k2 * d[2] + k3 * (u * d[2] + v * d[0]));
+            const float c = -k3 * d[0] * d[2];
+
+            float s = 0.0f;
+            if (a <= 0.0f || firstRoot(a, b, c, tQuad - t, s))
+            {
+                tHit = t + s;
+                return true;
+            }
+        }
+
+        if (tQuad >= tEnd)
+            return false;
+
+        t = tQuad;
+    }
+}
+
+bool HeightPyramid::raycast(const float *data, const float origin[3], const float direction[3], float &tHit) const
+{
+    if (mLevels.empty() || !data)
+        return false;
+
+    const float *o = origin;
+    const float *d = direction;
+
+    // Portion du rayon au-dessus du rectangle de la grille
+    float t0 = 0.0f;
+    float t1 = std::numeric_limits<float>::max();
+    const float upper[3] = {static_cast<float>(mWidth - 1), 0.0f, static_cast<float>(mHeight - 1)};
+
+    for (int axis = 0; axis < 3; axis += 2)
+    {
+        if (d[axis] == 0.0f)
+        {
+            if (o[axis] < 0.0f || o[axis] > upper[axis])
+                return false;
+            continue;
+        }
+
+        float tA = (0.0f - o[axis]) / d[axis];
+        float tB = (upper[axis] - o[axis]) / d[axis];
+        if (tA > tB)
+            std::swap(tA, tB);
+
+        t0 = std::max(t0, tA);
+        t1 = std::min(t1, tB);
+    }
+
+    if (t0 > t1)
+        return false;
+
+    // Un rayon qui arrive sous la surface (origine sous le terrain, entrée par un bord) ne le touche pas
+    if (o[1] + d[1] * t0 < surfaceHeight(data, o[0] + d[0] * t0, o[2] + d[2] * t0))
+        return false;
+
+    // Tranche de hauteurs de la grille : au-dessus, rien à toucher
+    const Bounds root = rootBounds();
+    if (d[1] < 0.0f)
+    {
+        if (o[1] > root.hi)
+            t0 = std::max(t0, (root.hi - o[1]) / d[1]);
+        t1 = std::min(t1, (root.lo - o[1]) / d[1]);
+    }
+    else if (d[1] > 0.0f)
+    {
+        t1 = std::min(t1, (root.hi - o[1]) / d[1]);
+    }
+    else if (o[1] > root.hi)
+    {
+        return false;
+    }
+
+    if (t0 > t1)
+        return false;
+
+    const int top = levelCount() - 1;
+    const float dMax = std::max(std::abs(d[0]), std::abs(d[2]));
+    int level = top;
+    float t = t0;
+
+    while (true)
+    {
+        const int size = LEAF << level;
+        const int levelWidth = mLevelWidth[level];
+        const int levelHeight = mLevelHeight[level];
+
+        const float px = nudged(o[0] + d[0] * t, d[0]);
+        const float pz = nudged(o[2] + d[2] * t, d[2]);
+        const int nx = std::clamp(static_cast<int>(std::floor(px / size)), 0, levelWidth - 1);
+        const int nz = std::clamp(static_cast<int>(std::floor(pz / size)), 0, levelHeight - 1);
+
+        const float x0 = static_cast<float>(nx * size);
+        const float z0 = static_cast<float>(nz * size);
+        const float x1 = std::min(x0 + size, upper[0]);
+        const float z1 = std::min(z0 + size, upper[2]);
+
+        float tExit = std::min({t1, slabExit(o[0], d[0], x0, x1), slabExit(o[2], d[2], z0, z1)});
+        if (!(tExit > t))
+            tExit = std::min(t1, t + kNudge / std::max(dMax, 1e-12f));
+
+        const Bounds &bounds = mLevels[level][static_cast<std::size_t>(nz) * levelWidth + nx];
+        const float yLow = std::min(o[1] + d[1] * t, o[1] + d[1] * tExit);
+
+        if (yLow > bounds.hi)
+        {
+            // Noeud entièrement sous le rayon : sauté, on remonte d'un niveau
+            if (tExit >= t1)
+                return false;
+
+            t = tExit;
+            level = std::min(level + 1, top);
+            continue;
+        }
+
+        if (level > 0)
+        {
+            --level;
+            continue;
+        }
+
+        if (intersectLeaf(data, nx, nz, o, d, t, tExit, tHit))
+            return true;
+
+        if (tExit >= t1)
+            return false;
+
+        t = tExit;
+        level = std::min(level + 1, top);
+    }
+}
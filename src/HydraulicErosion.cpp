@@ -1,15 +1,18 @@
 #include "HydraulicErosion.hpp"
+#include "CounterRng.hpp"
 
 HydraulicErosion::HydraulicErosion(int iterations,
                                    float rain,
                                    float erosionRate,
                                    float depositRate,
-                                   float evaporation)
+                                   float evaporation,
+                                   uint32_t seed)
     : iterations(iterations),
       rain(rain),
       erosionRate(erosionRate),
       depositRate(depositRate),
-      evaporation(evaporation)
+      evaporation(evaporation),
+      seed(seed)
 {
 }
 
@@ -17,8 +20,9 @@ void HydraulicErosion::apply(Terrain& terrain)
 {
     for (int it = 0; it < iterations; it++)
     {
-        int i = rand() % terrain.get_terrain_height();
-        int j = rand() % terrain.get_terrain_width();
+        const uint64_t stream = CounterRng::stream(CounterRng::HydraulicDrops, it);
+        int i = CounterRng::below(seed, stream, 0, terrain.get_terrain_height());
+        int j = CounterRng::below(seed, stream, 1, terrain.get_terrain_width());
 
         float water = rain;
         float sediment = 0.0f;
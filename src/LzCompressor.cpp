@@ -0,0 +1,203 @@
+#include "LzCompressor.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+constexpr std::size_t kMinMatch = 4;
+constexpr std::size_t kLastLiterals = 5;
+constexpr std::size_t kMaxOffset = 65535;
+constexpr int kHashLog = 14;
+
+inline uint32_t read32(const uint8_t *p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t hashSequence(uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - kHashLog);
+}
+
+inline uint8_t *writeLength(uint8_t *op, std::size_t length)
+{
+    while (length >= 255)
+    {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = static_cast<uint8_t>(length);
+    return op;
+}
+
+uint8_t *emitSequence(uint8_t *op, const uint8_t *literals, std::size_t literalLength,
+                      std::size_t offset, std::size_t matchLength)
+{
+    uint8_t *token = op++;
+    const std::size_t matchCode = matchLength - kMinMatch;
+
+    *token = static_cast<uint8_t>(((literalLength < 15 ? literalLength : 15) << 4)
+                                  | (matchCode < 15 ? matchCode : 15));
+
+    if (literalLength >= 15)
+        op = writeLength(op, literalLength - 15);
+
+    std::memcpy(op, literals, literalLength);
+    op += literalLength;
+
+    *op++ = static_cast<uint8_t>(offset & 0xFF);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+
+    if (matchCode >= 15)
+        op = writeLength(op, matchCode - 15);
+
+    return op;
+}
+} // namespace
+
+std::size_t LzCompressor::maxCompressedSize(std::size_t n)
+{
+    return n + n / 255 + 16;
+}
+
+std::size_t LzCompressor::compress(const uint8_t *src, std::size_t n, uint8_t *dst)
+{
+    uint8_t *op = dst;
+    std::size_t anchor = 0;
+
+    if (n > kMinMatch + kLastLiterals + 4)
+    {
+        std::vector<uint32_t> table(1u << kHashLog, 0);
+        const std::size_t matchLimit = n - kLastLiterals;
+        const std::size_t searchLimit = n - kLastLiterals - kMinMatch;
+        std::size_t ip = 0;
+
+        while (ip < searchLimit)
+        {
+            const uint32_t sequence = read32(src + ip);
+            const uint32_t h = hashSequence(sequence);
+            const std::size_t candidate = table[h];
+            table[h] = static_cast<uint32_t>(ip + 1);
+
+            if (candidate == 0 || ip - (candidate - 1) > kMaxOffset
+                || read32(src + candidate - 1) != sequence)
+            {
+                ++ip;
+                continue;
+            }
+
+            const std::size_t matchPos = candidate - 1;
+            std::size_t length = kMinMatch;
+            while (ip + length < matchLimit && src[matchPos + length] == src[ip + length])
+                ++length;
+
+            op = emitSequence(op, src + anchor, ip - anchor, ip - matchPos, length);
+
+            ip += length;
+            anchor = ip;
+        }
+    }
+
+    // Dernière séquence : littéraux seuls
+    const std::size_t literalLength = n - anchor;
+    *op++ = static_cast<uint8_t>((literalLength < 15 ? literalLength : 15) << 4);
+    if (literalLength >= 15)
+        op = writeLength(op, literalLength - 15);
+    std::memcpy(op, src + anchor, literalLength);
+    op += literalLength;
+
+    return static_cast<std::size_t>(op - dst);
+}
+
+bool LzCompressor::decompress(const uint8_t *src, std::size_t n, uint8_t *dst, std::size_t rawSize)
+{
+    const uint8_t *ip = src;
+    const uint8_t *const iend = src + n;
+    uint8_t *op = dst;
+    uint8_t *const oend = dst + rawSize;
+
+    auto readLength = [&](std::size_t &length) {
+        uint8_t b;
+        do
+        {
+            if (ip >= iend)
+                return false;
+            b = *ip++;
+            length += b;
+        } while (b == 255);
+        return true;
+    };
+
+    while (ip < iend)
+    {
+        const uint8_t token = *ip++;
+
+        std::size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(literalLength))
+            return false;
+
+        if (literalLength > static_cast<std::size_t>(iend - ip)
+            || literalLength > static_cast<std::size_t>(oend - op))
+            return false;
+
+        std::memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        if (ip == iend)
+            break;
+
+        if (iend - ip < 2)
+            return false;
+
+        const std::size_t offset = ip[0] | (static_cast<std::size_t>(ip[1]) << 8);
+        ip += 2;
+
+        std::size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLength(matchLength))
+            return false;
+        matchLength += kMinMatch;
+
+        if (offset == 0 || offset > static_cast<std::size_t>(op - dst)
+            || matchLength > static_cast<std::size_t>(oend - op))
+            return false;
+
+        const uint8_t *match = op - offset;
+        if (offset >= matchLength)
+        {
+            std::memcpy(op, match, matchLength);
+        }
+        else
+        {
+            // Chevauchement source/destination : copie octet par octet
+            for (std::size_t k = 0; k < matchLength; ++k)
+                op[k] = match[k];
+        }
+        op += matchLength;
+    }
+
+    return op == oend;
+}
+
+void LzCompressor::shuffle(const uint8_t *src, std::size_t count, std::size_t wordSize, uint8_t *dst)
+{
+    for (std::size_t b = 0; b < wordSize; ++b)
+    {
+        uint8_t *plane = dst + b * count;
+        for (std::size_t i = 0; i < count; ++i)
+            plane[i] = src[i * wordSize + b];
+    }
+}
+
+void LzCompressor::unshuffle(const uint8_t *src, std::size_t count, std::size_t wordSize, uint8_t *dst)
+{
+    for (std::size_t b = 0; b < wordSize; ++b)
+    {
+        const uint8_t *plane = src + b * count;
+        for (std::size_t i = 0; i < count; ++i)
+            dst[i * wordSize + b] = plane[i];
+    }
+}
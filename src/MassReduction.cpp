@@ -0,0 +1,74 @@
+#include "MassReduction.hpp"
+
+#include <algorithm>
+#include <cmath>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+double MassReduction::sum(const float *data, std::size_t count)
+{
+    if (count == 0)
+        return 0.0;
+
+#ifdef _OPENMP
+    const int numThreads = omp_get_max_threads();
+#else
+    const int numThreads = 1;
+#endif
+
+    const std::ptrdiff_t blockCount = static_cast<std::ptrdiff_t>((count + BLOCK_SIZE - 1) / BLOCK_SIZE);
+
+    // Une somme et une compensation par thread, écrites une seule fois
+    std::vector<double> threadSums(numThreads, 0.0);
+    std::vector<double> threadCompensations(numThreads, 0.0);
+
+    #pragma omp parallel num_threads(numThreads)
+    {
+#ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+#else
+        const int tid = 0;
+#endif
+
+        double localSum = 0.0;
+        double localCompensation = 0.0;
+
+        #pragma omp for schedule(static)
+        for (std::ptrdiff_t block = 0; block < blockCount; ++block)
+        {
+            const std::size_t begin = static_cast<std::size_t>(block) * BLOCK_SIZE;
+            const std::size_t end = std::min(begin + BLOCK_SIZE, count);
+
+            double blockSum = 0.0;
+
+            #pragma omp simd reduction(+:blockSum)
+            for (std::size_t i = begin; i < end; ++i)
+                blockSum += data[i];
+
+            accumulate(localSum, localCompensation, blockSum);
+        }
+
+        threadSums[tid] = localSum;
+        threadCompensations[tid] = localCompensation;
+    }
+
+    double total = 0.0;
+    double compensation = 0.0;
+
+    for (int t = 0; t < numThreads; ++t)
+    {
+        accumulate(total, compensation, threadSums[t]);
+        compensation += threadCompensations[t];
+    }
+
+    return total + compensation;
+}
+
+double MassReduction::relativeError(double reference, double value)
+{
+    if (reference == 0.0)
+        return 0.0;
+
+    return std::abs(value - reference) / std::abs(reference);
+}
@@ -1,23 +1,135 @@
 #include "MidpointDisplacement.hpp"
+#include "CounterRng.hpp"
+#include "NumaPlacement.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <cstdio>
 
-static float RandomFloat(float a, float b)
+/**
+ * Déplacement aléatoire d'une cellule : il ne dépend que de la graine, du
+ * niveau de subdivision et de la cellule, pas de l'ordre de parcours.
+ */
+static float RandomFloat(uint32_t seed, int rectSize, int x, int z, int width, float a, float b)
 {
-    return a + (b - a) * (float(rand()) / float(RAND_MAX));
+    const uint64_t stream = CounterRng::stream(CounterRng::MidpointOffsets, rectSize);
+    const uint64_t cell = static_cast<uint64_t>(z) * width + x;
+    return CounterRng::uniform(seed, stream, cell, a, b);
 }
+
 static bool isPowerOfTwo(int n) {
     return n > 0 && (n & (n - 1)) == 0;
 }
 
+namespace
+{
+/**
+ * Diamond step value of the centre (x + half, z + half) of the square of
+ * side rectSize whose lower corner is (x, z). Shared by the full and the
+ * region generators so both evaluate exactly the same expression.
+ */
+template <typename Getter>
+inline float DiamondValue(const Getter& get, uint32_t seed, int size, int rectSize, float curHeight, int x, int z)
+{
+    const int half = rectSize / 2;
+
+    const float bottomLeft  = get(x, z);
+    const float bottomRight = get(x + rectSize, z);
+    const float topLeft     = get(x, z + rectSize);
+    const float topRight    = get(x + rectSize, z + rectSize);
+
+    const float average = (bottomLeft + bottomRight + topLeft + topRight) / 4.0f;
+
+    return average + RandomFloat(seed, rectSize, x + half, z + half, size, -curHeight, curHeight);
+}
+
+/**
+ * Square step value of (x, z): average of the in-bounds neighbours at
+ * distance half, in the order top, bottom, left, right.
+ */
+template <typename Getter>
+inline float SquareValue(const Getter& get, uint32_t seed, int size, int rectSize, float curHeight, int x, int z)
+{
+    const int half = rectSize / 2;
+    float sum = 0.0f;
+    int count = 0;
+
+    if (z - half >= 0)
+    {
+        sum += get(x, z - half);
+        count++;
+    }
+
+    if (z + half < size)
+    {
+        sum += get(x, z + half);
+        count++;
+    }
+
+    if (x - half >= 0)
+    {
+        sum += get(x - half, z);
+        count++;
+    }
+
+    if (x + half < size)
+    {
+        sum += get(x + half, z);
+        count++;
+    }
+
+    const float average = sum / count;
+
+    return average + RandomFloat(seed, rectSize, x, z, size, -curHeight, curHeight);
+}
+
+/**
+ * Points of the lattice of spacing `spacing` inside an axis-aligned box.
+ */
+struct LatticeGrid
+{
+    int spacing = 1;
+    int x0 = 0;
+    int z0 = 0;
+    int nx = 0;
+    int nz = 0;
+    std::vector<float> values;
+
+    float get(int x, int z) const
+    {
+        return values[static_cast<std::size_t>((z - z0) / spacing) * nx + (x - x0) / spacing];
+    }
+};
+
+struct Box
+{
+    int x0, z0, x1, z1; // bornes incluses
+};
+
+/**
+ * Expands a box by margin, snaps it outwards to multiples of spacing and
+ * clamps it to the terrain.
+ */
+Box ExpandBox(const Box& box, int margin, int spacing, int size)
+{
+    auto snapDown = [&](int v) { return std::max(0, v - margin) / spacing * spacing; };
+    auto snapUp = [&](int v) {
+        const int up = std::min(size - 1, v + margin);
+        return (up + spacing - 1) / spacing * spacing;
+    };
+
+    return {snapDown(box.x0), snapDown(box.z0), snapUp(box.x1), snapUp(box.z1)};
+}
+} // namespace
+
 MidpointDisplacement::MidpointDisplacement()
 {
 }
 
 void MidpointDisplacement::CreateMidpointDisplacement(int size, float minHeight, float maxHeight, float scale, float roughness)
 {
-    
+
     this->mWidth  = size;
     this->mHeight = size;
     this->mMinHeight = minHeight;
@@ -27,115 +139,260 @@ void MidpointDisplacement::CreateMidpointDisplacement(int size, float minHeight,
     this->mBorderSize = 0;
 
     this->mData.assign(mWidth * mHeight, 0.0f);
+    NumaPlacement::place(mData);
 
     this->mRenderer = (std::make_unique<RendererManager>(this));
-    
+
     if(!isPowerOfTwo(size - 1))
     {
         printf("Invalid terrain size : %d (size must be 2^n + 1)\n", size);
         return;
     }
-    CreateMidpointDisplacementInterne(roughness);
-    Normalize();
+    float rawMin = 0.0f;
+    float rawMax = 0.0f;
+
+    CreateMidpointDisplacementInterne(roughness, rawMin, rawMax);
+    normalizeHeights(rawMin, rawMax);
 
     createPatches();
 }
 
-void MidpointDisplacement::CreateMidpointDisplacementInterne(float roughness)
+void MidpointDisplacement::CreateMidpointDisplacementRegion(int size, int x0, int z0, int width, int height,
+                                                            float minHeight, float maxHeight, float scale, float roughness)
 {
-    int rectSize = mHeight - 1;
+    this->mWidth  = width;
+    this->mHeight = height;
+    this->mMinHeight = minHeight;
+    this->mMaxHeight = maxHeight;
+    this->mYFactor = 1.0f;
+    this->mXzFactor = 1.0f / scale;
+    this->mBorderSize = 0;
+
+    this->mRenderer = (std::make_unique<RendererManager>(this));
+
+    if (!GenerateRegion(mSeed, size, roughness, x0, z0, width, height, mData))
+    {
+        this->mData.assign(static_cast<std::size_t>(std::max(0, width)) * std::max(0, height), 0.0f);
+        return;
+    }
+    NumaPlacement::place(mData);
+
+    // Chaque tuile ne connaît pas les extrêmes du terrain complet : on
+    // normalise par la borne théorique pour que les tuiles se raccordent.
+    const float bound = MaxDisplacement(size, roughness);
+    const float targetRange = mMaxHeight - mMinHeight;
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < static_cast<int>(mData.size()); ++i)
+    {
+        mData[i] = (mData[i] + bound) / (2.0f * bound) * targetRange + mMinHeight;
+    }
+
+    createPatches();
+}
+
+float MidpointDisplacement::MaxDisplacement(int size, float roughness)
+{
+    int rectSize = size - 1;
     float curHeight = (float)rectSize / 2.0f;
-    float heightReduce = std::pow(2.0f, -roughness);
+    const float heightReduce = std::pow(2.0f, -roughness);
+    float bound = 0.0f;
 
     while (rectSize > 1)
     {
-        DiamondStep(rectSize, curHeight);
-        SquareStep(rectSize, curHeight);
-
+        bound += curHeight;
         rectSize /= 2;
         curHeight *= heightReduce;
     }
+
+    return bound > 0.0f ? bound : 1.0f;
 }
 
-void MidpointDisplacement::Normalize()
+bool MidpointDisplacement::GenerateRegion(uint32_t seed, int size, float roughness, int x0, int z0,
+                                          int width, int height, std::vector<float>& out)
 {
-    auto minMax = std::minmax_element(mData.begin(), mData.end());
-    float min = *minMax.first;
-    float max = *minMax.second;
+    if (!isPowerOfTwo(size - 1))
+    {
+        printf("Invalid terrain size : %d (size must be 2^n + 1)\n", size);
+        return false;
+    }
+
+    if (width <= 0 || height <= 0 || x0 < 0 || z0 < 0 || x0 + width > size || z0 + height > size)
+    {
+        printf("Invalid region %d,%d %dx%d for terrain size %d\n", x0, z0, width, height, size);
+        return false;
+    }
 
-    float minMaxDelta = max - min;
-    float targetRange = mMaxHeight - mMinHeight;
+    const float heightReduce = std::pow(2.0f, -roughness);
 
-    for(auto& element : mData)
+    // Boîtes nécessaires à chaque niveau, du plus fin au plus grossier : un
+    // point du réseau de pas s dépend des points du réseau 2s à distance
+    // au plus 2s (carré dont le voisin est un centre de losange).
+    std::vector<Box> boxes;
+    std::vector<int> spacings;
+    Box box = {x0, z0, x0 + width - 1, z0 + height - 1};
+
+    for (int spacing = 1; spacing < size - 1; spacing *= 2)
     {
-        element = (element - min) / minMaxDelta * targetRange + mMinHeight;
+        box = ExpandBox(box, 0, spacing, size);
+        boxes.push_back(box);
+        spacings.push_back(spacing);
+        box = ExpandBox(box, 2 * spacing, 2 * spacing, size);
     }
-}
 
-void MidpointDisplacement::DiamondStep(int rectSize, float curHeight)
-{
-    int halfRectSize = rectSize / 2;
+    // Niveau le plus grossier : les quatre coins, à zéro
+    LatticeGrid coarse;
+    coarse.spacing = size - 1;
+    coarse.nx = 2;
+    coarse.nz = 2;
+    coarse.values.assign(4, 0.0f);
+
+    int rectSize = size - 1;
+    float curHeight = (float)rectSize / 2.0f;
 
-    for (int z = 0; z < mHeight; z += rectSize)
+    for (int level = static_cast<int>(boxes.size()) - 1; level >= 0; --level)
     {
-        for (int x = 0; x < mWidth; x += rectSize)
-        {
-            int nextZ = (z + rectSize) % mHeight;
-            int nextX = (x + rectSize) % mWidth;
+        const Box& target = boxes[level];
+        const int spacing = spacings[level];
 
-            float bottomLeft  = getHeight(z, x);
-            float bottomRight = getHeight(z, nextX);
-            float topLeft     = getHeight(nextZ, x);
-            float topRight    = getHeight(nextZ, nextX);
+        LatticeGrid fine;
+        fine.spacing = spacing;
+        fine.x0 = target.x0;
+        fine.z0 = target.z0;
+        fine.nx = (target.x1 - target.x0) / spacing + 1;
+        fine.nz = (target.z1 - target.z0) / spacing + 1;
+        fine.values.resize(static_cast<std::size_t>(fine.nx) * fine.nz);
 
-            int midX = (x + halfRectSize) % mWidth;
-            int midZ = (z + halfRectSize) % mHeight;
+        auto getCoarse = [&coarse](int x, int z) { return coarse.get(x, z); };
 
-            float average = (bottomLeft + bottomRight + topLeft + topRight) / 4.0f;
+        // Les centres de losange voisins d'un point du carré sont recalculés
+        // à la volée : l'expression est déterministe, la valeur est la même.
+        auto getLevel = [&](int x, int z) {
+            if (x % rectSize == 0 && z % rectSize == 0)
+                return coarse.get(x, z);
+            return DiamondValue(getCoarse, seed, size, rectSize, curHeight, x - spacing, z - spacing);
+        };
+
+        #pragma omp parallel for schedule(static)
+        for (int iz = 0; iz < fine.nz; ++iz)
+        {
+            const int z = fine.z0 + iz * spacing;
 
-            setHeight(midX, midZ, average + RandomFloat(-curHeight, curHeight));
+            for (int ix = 0; ix < fine.nx; ++ix)
+            {
+                const int x = fine.x0 + ix * spacing;
+                const bool onCoarseX = (x % rectSize == 0);
+                const bool onCoarseZ = (z % rectSize == 0);
+                float value;
+
+                if (onCoarseX && onCoarseZ)
+                    value = coarse.get(x, z);
+                else if (!onCoarseX && !onCoarseZ)
+                    value = DiamondValue(getCoarse, seed, size, rectSize, curHeight, x - spacing, z - spacing);
+                else
+                    value = SquareValue(getLevel, seed, size, rectSize, curHeight, x, z);
+
+                fine.values[static_cast<std::size_t>(iz) * fine.nx + ix] = value;
+            }
         }
+
+        coarse = std::move(fine);
+        rectSize /= 2;
+        curHeight *= heightReduce;
     }
+
+    out.resize(static_cast<std::size_t>(width) * height);
+
+    #pragma omp parallel for schedule(static)
+    for (int z = 0; z < height; ++z)
+    {
+        for (int x = 0; x < width; ++x)
+            out[static_cast<std::size_t>(z) * width + x] = coarse.get(x0 + x, z0 + z);
+    }
+
+    return true;
 }
 
-void MidpointDisplacement::SquareStep(int rectSize, float curHeight)
+void MidpointDisplacement::CreateMidpointDisplacementInterne(float roughness, float& rawMin, float& rawMax)
 {
-    int halfRectSize = rectSize / 2;
+    int rectSize = mHeight - 1;
+    float curHeight = (float)rectSize / 2.0f;
+    float heightReduce = std::pow(2.0f, -roughness);
 
-    for (int z = 0; z < mHeight; z += halfRectSize)
+    // Les quatre coins restent à zéro
+    rawMin = 0.0f;
+    rawMax = 0.0f;
+
+    while (rectSize > 1)
     {
-        for (int x = (z + halfRectSize) % rectSize; x < mWidth; x += rectSize)
+        DiamondStep(rectSize, curHeight, rawMin, rawMax);
+        SquareStep(rectSize, curHeight, rawMin, rawMax);
+
+        rectSize /= 2;
+        curHeight *= heightReduce;
+    }
+}
+
+void MidpointDisplacement::DiamondStep(int rectSize, float curHeight, float& rawMin, float& rawMax)
+{
+    const int size = mWidth;
+    const int halfRectSize = rectSize / 2;
+    const int nbSquares = (size - 1) / rectSize;
+    float* data = mData.data();
+
+    auto get = [data, size](int x, int z) { return data[static_cast<std::size_t>(z) * size + x]; };
+
+    float lo = rawMin;
+    float hi = rawMax;
+
+    // Les centres ne lisent que les coins du niveau : pas de dépendance
+    // entre les itérations.
+    #pragma omp parallel for schedule(static) reduction(min:lo) reduction(max:hi)
+    for (int sz = 0; sz < nbSquares; ++sz)
+    {
+        const int z = sz * rectSize;
+
+        for (int x = 0; x < size - 1; x += rectSize)
         {
-            float sum = 0.0f;
-            int count = 0;
+            const float value = DiamondValue(get, mSeed, size, rectSize, curHeight, x, z);
+            data[static_cast<std::size_t>(z + halfRectSize) * size + x + halfRectSize] = value;
+            lo = std::min(lo, value);
+            hi = std::max(hi, value);
+        }
+    }
 
-            if (isInside(z - halfRectSize, x))
-            {
-                sum += getHeight(x, z - halfRectSize);
-                count++;
-            }
+    rawMin = lo;
+    rawMax = hi;
+}
 
-            if (isInside(z + halfRectSize, x))
-            {
-                sum += getHeight(x, z + halfRectSize);
-                count++;
-            }
+void MidpointDisplacement::SquareStep(int rectSize, float curHeight, float& rawMin, float& rawMax)
+{
+    const int size = mWidth;
+    const int halfRectSize = rectSize / 2;
+    const int nbRows = (size - 1) / halfRectSize + 1;
+    float* data = mData.data();
 
-            if (isInside(z, x - halfRectSize))
-            {
-                sum += getHeight(x - halfRectSize, z);
-                count++;
-            }
+    auto get = [data, size](int x, int z) { return data[static_cast<std::size_t>(z) * size + x]; };
 
-            if (isInside(z, x + halfRectSize))
-            {
-                sum += getHeight(x + halfRectSize, z);
-                count++;
-            }
+    // Les points du carré lisent les coins et les centres, jamais d'autres
+    // points du carré : les rangées sont indépendantes.
+    float lo = rawMin;
+    float hi = rawMax;
 
-            float average = sum / count;
+    #pragma omp parallel for schedule(static) reduction(min:lo) reduction(max:hi)
+    for (int row = 0; row < nbRows; ++row)
+    {
+        const int z = row * halfRectSize;
 
-            setHeight(x, z, average + RandomFloat(-curHeight, curHeight));
+        for (int x = (z + halfRectSize) % rectSize; x < size; x += rectSize)
+        {
+            const float value = SquareValue(get, mSeed, size, rectSize, curHeight, x, z);
+            data[static_cast<std::size_t>(z) * size + x] = value;
+            lo = std::min(lo, value);
+            hi = std::max(hi, value);
         }
     }
-}
\ No newline at end of file
+
+    rawMin = lo;
+    rawMax = hi;
+}
@@ -0,0 +1,199 @@
+#include "MultigridThermalErosion.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+MultigridThermalErosion::MultigridThermalErosion()
+{
+}
+
+void MultigridThermalErosion::setTalusAngle(float angle)
+{
+    const float PI = 3.14159265f;
+    mTalusSlope = std::tan(angle * PI / 180.0f);
+}
+
+void MultigridThermalErosion::restrict(const Level &fine, Level &coarse)
+{
+    coarse.width = (fine.width + 1) / 2;
+    coarse.height = (fine.height + 1) / 2;
+    coarse.data.resize(static_cast<std::size_t>(coarse.width) * coarse.height);
+
+    #pragma omp parallel for schedule(static)
+    for (int ci = 0; ci < coarse.height; ++ci)
+    {
+        const int i0 = 2 * ci;
+        const int i1 = std::min(i0 + 1, fine.height - 1);
+
+        for (int cj = 0; cj < coarse.width; ++cj)
+        {
+            const int j0 = 2 * cj;
+            const int j1 = std::min(j0 + 1, fine.width - 1);
+
+            // Moyenne des cellules fines couvertes (1, 2 ou 4 sur les bords impairs)
+            float sum = 0.0f;
+            int count = 0;
+            for (int i = i0; i <= i1; ++i)
+            {
+                for (int j = j0; j <= j1; ++j)
+                {
+                    sum += fine.data[static_cast<std::size_t>(i) * fine.width + j];
+                    ++count;
+                }
+            }
+
+            coarse.data[static_cast<std::size_t>(ci) * coarse.width + cj] = sum / count;
+        }
+    }
+}
+
+void MultigridThermalErosion::prolongate(const std::vector<float> &restricted, const Level &coarse, Level &fine)
+{
+    const int cw = coarse.width;
+    const int ch = coarse.height;
+
+    auto correction = [&](int ci, int cj) {
+        ci = std::min(std::max(ci, 0), ch - 1);
+        cj = std::min(std::max(cj, 0), cw - 1);
+        const std::size_t c = static_cast<std::size_t>(ci) * cw + cj;
+        return coarse.data[c] - restricted[c];
+    };
+
+    // Interpolation bilinéaire centrée sur les cellules (poids 9, 3, 3, 1
+    // sur 16) : chaque cellule grossière distribue exactement 4 fois sa
+    // correction, bords répliqués compris.
+    auto fineCorrection = [&](int i, int j) {
+        const int ci = i / 2;
+        const int ni = (i % 2 == 0) ? ci - 1 : ci + 1;
+        const int cj = j / 2;
+        const int nj = (j % 2 == 0) ? cj - 1 : cj + 1;
+
+        return (9.0f * correction(ci, cj) + 3.0f * correction(ni, cj)
+              + 3.0f * correction(ci, nj) + correction(ni, nj)) / 16.0f;
+    };
+
+    double applied = 0.0;
+    double magnitude = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:applied, magnitude)
+    for (int i = 0; i < fine.height; ++i)
+    {
+        for (int j = 0; j < fine.width; ++j)
+        {
+            const float value = fineCorrection(i, j);
+            fine.data[static_cast<std::size_t>(i) * fine.width + j] += value;
+            applied += value;
+            magnitude += std::abs(value);
+        }
+    }
+
+    // La relaxation grossière conserve la somme des corrections, mais les
+    // blocs incomplets des dimensions impaires n'en reçoivent qu'une
+    // partie : l'écart est retiré des cellules corrigées, au prorata de
+    // leur correction.
+    if (applied == 0.0 || magnitude == 0.0)
+        return;
+
+    const double residual = applied / magnitude;
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < fine.height; ++i)
+    {
+        for (int j = 0; j < fine.width; ++j)
+        {
+            const float value = fineCorrection(i, j);
+            fine.data[static_cast<std::size_t>(i) * fine.width + j] -= static_cast<float>(residual * std::abs(value));
+        }
+    }
+}
+
+int MultigridThermalErosion::relax(Level &level, float talusSlope, int maxSteps, int stallSteps, int &stepsDone) const
+{
+    ThermalErosion erosion;
+    erosion.loadGrid(&level.data, level.width, level.height);
+    erosion.setTalusSlope(talusSlope);
+    erosion.setTransferRate(mTransferRate);
+
+    if (mEightNeighbors)
+        erosion.useEightNeighbors();
+    else
+        erosion.useFourNeighbors();
+
+    int changes = 0;
+    int best = -1;
+    int sinceBest = 0;
+
+    for (stepsDone = 0; stepsDone < maxSteps; )
+    {
+        changes = erosion.stepBlockedParallelPureTwoPhase();
+        ++stepsDone;
+
+        if (changes == 0)
+            break;
+
+        // Plateau : le nombre de cellules au-dessus du talus ne baisse plus
+        if (best < 0 || changes < best) {
+            best = changes;
+            sinceBest = 0;
+        } else if (++sinceBest >= stallSteps) {
+            break;
+        }
+    }
+
+    return changes;
+}
+
+int MultigridThermalErosion::solve(std::vector<float> &data, int width, int height, const MultigridSettings &settings)
+{
+    std::vector<Level> levels(1);
+    levels[0].width = width;
+    levels[0].height = height;
+    levels[0].data.swap(data);
+
+    for (int l = 0; l < settings.levels; ++l)
+    {
+        const Level &fine = levels.back();
+        if ((fine.width + 1) / 2 < settings.minCoarseSize || (fine.height + 1) / 2 < settings.minCoarseSize)
+            break;
+
+        Level coarse;
+        restrict(fine, coarse);
+        levels.push_back(std::move(coarse));
+    }
+
+    mLevelSteps.assign(levels.size(), 0);
+
+    // La correction remontée au niveau l - 1 est l'écart entre l'état final
+    // du niveau l et sa restriction d'origine : elle inclut les corrections
+    // déjà reçues des niveaux plus grossiers.
+    std::vector<std::vector<float>> restricted(levels.size());
+    for (std::size_t l = 1; l < levels.size(); ++l)
+        restricted[l] = levels[l].data;
+
+    for (int l = static_cast<int>(levels.size()) - 1; l >= 1; --l)
+    {
+
+        // Une cellule du niveau l couvre 2^l cellules fines. La marge évite
+        // que l'interpolation ne laisse les pentes fines juste au-dessus du
+        // talus.
+        const float talus = mTalusSlope * static_cast<float>(1 << l) * settings.coarseTalusFactor;
+        relax(levels[l], talus, settings.coarseSteps, settings.stallSteps, mLevelSteps[l]);
+
+        prolongate(restricted[l], levels[l], levels[l - 1]);
+        levels[l].data.clear();
+        restricted[l].clear();
+    }
+
+    int changes = 0;
+    if (settings.fineSteps > 0)
+    {
+        // Sur la grille fine, le nombre de cellules modifiées remonte
+        // d'abord (les corrections interpolées sont lissées) : pas de
+        // critère de stagnation.
+        changes = relax(levels[0], mTalusSlope, settings.fineSteps, settings.fineSteps, mLevelSteps[0]);
+    }
+
+    data.swap(levels[0].data);
+    return changes;
+}
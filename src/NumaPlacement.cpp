@@ -0,0 +1,187 @@
+#include "NumaPlacement.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+// EROSION_NUMA_POLICY=interleave choisit l'entrelacement, sinon premier contact
+NumaPlacement::Policy policyFromEnvironment()
+{
+    const char *value = std::getenv("EROSION_NUMA_POLICY");
+    if (value && std::string(value) == "interleave")
+        return NumaPlacement::Policy::Interleave;
+
+    return NumaPlacement::Policy::FirstTouch;
+}
+
+// Identifiants des noeuds en ligne (node0, node1... de sysfs)
+const std::vector<int> &onlineNodes()
+{
+    static const std::vector<int> nodes = [] {
+        namespace fs = std::filesystem;
+
+        std::vector<int> ids;
+        std::error_code ec;
+
+        for (const fs::directory_entry &entry : fs::directory_iterator("/sys/devices/system/node", ec))
+        {
+            const std::string name = entry.path().filename().string();
+            if (name.size() > 4 && name.compare(0, 4, "node") == 0
+                && std::isdigit(static_cast<unsigned char>(name[4])))
+                ids.push_back(std::stoi(name.substr(4)));
+        }
+
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }();
+
+    return nodes;
+}
+
+#ifdef __linux__
+void warnOnce(const char *call)
+{
+    // place() peut être appelé depuis plusieurs threads à la fois
+    static std::atomic<bool> warned{false};
+    if (!warned.exchange(true))
+        std::cerr << "Warning: " << call << " a échoué, pages NUMA laissées en place.\n";
+}
+
+void moveToThreadNodes(std::uintptr_t begin, long npages, long pageSize)
+{
+    #pragma omp parallel
+    {
+        std::vector<void *> pages;
+
+        // Même découpage qu'un parallel for schedule(static) sur les éléments
+        #pragma omp for schedule(static) nowait
+        for (long p = 0; p < npages; ++p)
+            pages.push_back(reinterpret_cast<void *>(begin + static_cast<std::uintptr_t>(p) * pageSize));
+
+        unsigned cpu = 0;
+        unsigned node = 0;
+        if (!pages.empty() && syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+        {
+            std::vector<int> nodes(pages.size(), static_cast<int>(node));
+            std::vector<int> status(pages.size(), 0);
+
+            if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nodes.data(), status.data(),
+                        MPOL_MF_MOVE) < 0)
+                warnOnce("move_pages");
+        }
+    }
+}
+
+// Sans OMP_PROC_BIND, un thread peut migrer de socket après le déplacement
+// de ses pages : le premier contact n'a alors plus de sens
+bool threadsBound()
+{
+#ifdef _OPENMP
+    return omp_get_proc_bind() != omp_proc_bind_false;
+#else
+    return false;
+#endif
+}
+
+void interleave(std::uintptr_t begin, std::size_t length)
+{
+    const std::vector<int> &nodes = onlineNodes();
+    constexpr int bits = 8 * sizeof(unsigned long);
+
+    std::vector<unsigned long> mask(static_cast<std::size_t>(nodes.back() / bits + 1), 0ul);
+    for (int node : nodes)
+        mask[node / bits] |= 1ul << (node % bits);
+
+    // Le noyau lit maxnode - 1 bits du masque
+    const unsigned long maxNode = mask.size() * bits + 1;
+
+    if (syscall(SYS_mbind, begin, length, MPOL_INTERLEAVE, mask.data(), maxNode, MPOL_MF_MOVE) < 0)
+        warnOnce("mbind");
+}
+#endif
+} // namespace
+
+NumaPlacement::Policy NumaPlacement::sPolicy = policyFromEnvironment();
+
+int NumaPlacement::nodeCount()
+{
+    return std::max(1, static_cast<int>(onlineNodes().size()));
+}
+
+void NumaPlacement::place(void *data, std::size_t bytes)
+{
+#ifdef __linux__
+    if (!data || bytes == 0 || nodeCount() < 2)
+        return;
+
+    // Seules les pages entièrement couvertes par le tampon sont déplacées :
+    // une page partielle appartient aussi à l'allocation voisine
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    const std::uintptr_t mask = static_cast<std::uintptr_t>(pageSize) - 1;
+    const std::uintptr_t begin = (reinterpret_cast<std::uintptr_t>(data) + mask) & ~mask;
+    const std::uintptr_t end = (reinterpret_cast<std::uintptr_t>(data) + bytes) & ~mask;
+
+    if (end <= begin)
+        return;
+
+    Policy policy = sPolicy;
+    if (policy == Policy::FirstTouch && !threadsBound())
+    {
+        static std::atomic<bool> warned{false};
+        if (!warned.exchange(true))
+            std::cerr << "Warning: threads OpenMP non liés (OMP_PROC_BIND), placement NUMA en entrelacement. "
+                         "Définir OMP_PROC_BIND=close et OMP_PLACES=cores pour le premier contact.\n";
+        policy = Policy::Interleave;
+    }
+
+    if (policy == Policy::Interleave)
+        interleave(begin, end - begin);
+    else
+        moveToThreadNodes(begin, static_cast<long>((end - begin) / pageSize), pageSize);
+#else
+    (void)data;
+    (void)bytes;
+#endif
+}
+
+void NumaPlacement::fill(float *data, std::size_t count, float value)
+{
+    #pragma omp parallel for schedule(static)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(count); ++i)
+        data[i] = value;
+}
+
+void NumaPlacement::copy(const float *src, float *dst, std::size_t count)
+{
+    #pragma omp parallel for schedule(static)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(count); ++i)
+        dst[i] = src[i];
+}
+
+const char *NumaPlacement::policyName(Policy policy)
+{
+    switch (policy)
+    {
+    case Policy::FirstTouch:
+        return "firstTouch";
+    case Policy::Interleave:
+        return "interleave";
+    default:
+        return "unknown";
+    }
+}
@@ -10,6 +10,13 @@ void Patch::setPatch(unsigned int x, unsigned int z, float xzFactor, unsigned in
     this->mPatchTexture = texture;
 }
 
+void Patch::setWorldOrigin(int originX, int originZ, float textureExtent)
+{
+    this->mOriginX = originX;
+    this->mOriginZ = originZ;
+    this->mTextureExtent = textureExtent;
+}
+
 void Patch::addNeighbor(Patch *neighbor)
 {
     mNeighbors.push_back(neighbor);
@@ -68,13 +75,59 @@ void Patch::createBuffersGL()
         // Créer EBO
         glGenBuffers(1, &mEbo[lod]);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEbo[lod]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, this->mLod[lod].indices.size() * sizeof(unsigned int),
-                     this->mLod[lod].indices.data(), GL_DYNAMIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, this->mLod[lod].indices->size() * sizeof(unsigned int),
+                     this->mLod[lod].indices->data(), GL_DYNAMIC_DRAW);
 
         glBindVertexArray(0);
     }
 }
 
+void Patch::deleteBuffersGL()
+{
+    glDeleteVertexArrays(5, mVao);
+    glDeleteBuffers(5, mVbo);
+    glDeleteBuffers(5, mEbo);
+}
+
+namespace
+{
+constexpr int kMaxResolution = PATCH_SIZE + 3; /**< Sommets par côté au LOD 0, jupe comprise */
+
+/**
+ * Indices d'une grille resolution x resolution : identiques pour tous les
+ * patches, calculés une seule fois par niveau de LOD.
+ */
+std::vector<unsigned int> buildGridIndices(int resolution)
+{
+    const int cellsPerRow = resolution - 1;
+    std::vector<unsigned int> indices(static_cast<std::size_t>(cellsPerRow) * cellsPerRow * 6);
+
+    unsigned int *out = indices.data();
+    for (int y = 0; y < cellsPerRow; y++)
+    {
+        for (int x = 0; x < cellsPerRow; x++, out += 6)
+        {
+            const unsigned int topLeft = y * resolution + x;
+            const unsigned int topRight = topLeft + 1;
+            const unsigned int bottomLeft = topLeft + resolution;
+            const unsigned int bottomRight = bottomLeft + 1;
+
+            // Triangle 1
+            out[0] = topLeft;
+            out[1] = bottomLeft;
+            out[2] = topRight;
+
+            // Triangle 2
+            out[3] = topRight;
+            out[4] = bottomLeft;
+            out[5] = bottomRight;
+        }
+    }
+
+    return indices;
+}
+} // namespace
+
 void Patch::generateLodVertices(std::vector<float> &heights, unsigned int width, unsigned int height)
 {
     const float skirtDepth = 0.01f;
@@ -84,98 +137,86 @@ void Patch::generateLodVertices(std::vector<float> &heights, unsigned int width,
     const int basePatchZ = static_cast<int>(mPatchZ) * PATCH_SIZE;
 
     const float invXzFactor = 1.0f / mXzFactor;
-    const float invTexWidth = textureScale / (static_cast<float>(width) * mXzFactor);
-    const float invTexHeight = textureScale / (static_cast<float>(height) * mXzFactor);
+    const float texWidth = (mTextureExtent > 0.f) ? mTextureExtent : static_cast<float>(width);
+    const float texHeight = (mTextureExtent > 0.f) ? mTextureExtent : static_cast<float>(height);
+    const float invTexWidth = textureScale / (texWidth * mXzFactor);
+    const float invTexHeight = textureScale / (texHeight * mXzFactor);
+
+    // Colonnes d'échantillonnage (bornées), x et u : une table par LOD au lieu
+    // d'un clamp et d'une conversion par sommet
+    int sampleX[kMaxResolution];
+    float positionX[kMaxResolution];
+    float textureU[kMaxResolution];
 
     for (int k = 0; k < 5; ++k)
     {
         const int step = mLodSteps[k];
         const int innerResolution = (PATCH_SIZE / step) + 1;
         const int resolution = innerResolution + 2;
-        const int totalVertices = resolution * resolution;
+        const int last = resolution - 1;
 
-        auto &vertices = mLod[k].vertices;
-        vertices.resize(totalVertices);
+        for (int localX = 0; localX < resolution; ++localX)
+        {
+            const int innerX = localX - 1;
+            const int clampedX = std::clamp(innerX, 0, innerResolution - 1);
+            const int worldX = mOriginX + basePatchX + innerX * step;
 
-        int outIndex = 0;
+            sampleX[localX] = std::clamp(basePatchX + clampedX * step, 0, static_cast<int>(width) - 1);
+            positionX[localX] = static_cast<float>(worldX) * invXzFactor;
+            textureU[localX] = static_cast<float>(worldX) * invTexWidth;
+        }
+
+        auto &vertices = mLod[k].vertices;
+        vertices.resize(resolution * resolution);
 
         for (int localY = 0; localY < resolution; ++localY)
         {
             const int innerY = localY - 1;
             const int clampedY = std::clamp(innerY, 0, innerResolution - 1);
+            const int worldZ = mOriginZ + basePatchZ + innerY * step;
+            const int sampleZ = std::clamp(basePatchZ + clampedY * step, 0, static_cast<int>(height) - 1);
 
-            const int worldZ = basePatchZ + innerY * step;
-            int sampleZ = basePatchZ + clampedY * step;
-            sampleZ = std::clamp(sampleZ, 0, static_cast<int>(height) - 1);
+            const float *row = heights.data() + static_cast<std::size_t>(sampleZ) * width;
+            const float positionZ = static_cast<float>(worldZ) * invXzFactor;
+            const float textureV = static_cast<float>(worldZ) * invTexHeight;
+            Vertex *out = vertices.data() + localY * resolution;
 
-            const bool borderY = (localY == 0 || localY == resolution - 1);
+            #pragma omp simd
+            for (int localX = 0; localX < resolution; ++localX)
+            {
+                out[localX].position.x = positionX[localX];
+                out[localX].position.y = row[sampleX[localX]];
+                out[localX].position.z = positionZ;
+                out[localX].texture.x = textureU[localX];
+                out[localX].texture.y = textureV;
+            }
 
-            for (int localX = 0; localX < resolution; ++localX, ++outIndex)
+            // Jupe : lignes de bord entières, puis les deux colonnes de bord
+            if (localY == 0 || localY == last)
             {
-                const int innerX = localX - 1;
-                const int clampedX = std::clamp(innerX, 0, innerResolution - 1);
-
-                const int worldX = basePatchX + innerX * step;
-                int sampleX = basePatchX + clampedX * step;
-                sampleX = std::clamp(sampleX, 0, static_cast<int>(width) - 1);
-
-                float heightValue = heights[sampleZ * static_cast<int>(width) + sampleX];
-
-                if (borderY || localX == 0 || localX == resolution - 1)
-                {
-                    heightValue -= skirtDepth;
-                }
-
-                vertices[outIndex].position = glm::vec3(
-                    static_cast<float>(worldX) * invXzFactor,
-                    heightValue,
-                    static_cast<float>(worldZ) * invXzFactor
-                );
-
-                vertices[outIndex].texture = glm::vec2(
-                    static_cast<float>(worldX) * invTexWidth,
-                    static_cast<float>(worldZ) * invTexHeight
-                );
+                #pragma omp simd
+                for (int localX = 0; localX < resolution; ++localX)
+                    out[localX].position.y -= skirtDepth;
+            }
+            else
+            {
+                out[0].position.y -= skirtDepth;
+                out[last].position.y -= skirtDepth;
             }
         }
     }
 }
 
-void Patch::generateLodIndices(std::vector<float> &heights, unsigned int width, unsigned int height)
+void Patch::generateLodIndices()
 {
+    // Une grille par pas de mLodSteps (1, 2, 4, 8, 16), jupe comprise
+    static const std::vector<unsigned int> gridIndices[5] = {
+        buildGridIndices(PATCH_SIZE / 1 + 3), buildGridIndices(PATCH_SIZE / 2 + 3), buildGridIndices(PATCH_SIZE / 4 + 3),
+        buildGridIndices(PATCH_SIZE / 8 + 3), buildGridIndices(PATCH_SIZE / 16 + 3)};
+
     for (int k = 0; k < 5; ++k)
     {
-        mLod[k].indices.clear();
-
-        int step = mLodSteps[k];
-
-        int innerResolution = (PATCH_SIZE / step) + 1;
-        int resolution = innerResolution + 2;
-
-        int cellsPerRow = resolution - 1;
-
-        mLod[k].indices.reserve(resolution * resolution * 6);
-
-        for (int y = 0; y < cellsPerRow; y++)
-        {
-            for (int x = 0; x < cellsPerRow; x++)
-            {
-                int topLeft = y * resolution + x;
-                int topRight = y * resolution + x + 1;
-                int bottomLeft = (y + 1) * resolution + x;
-                int bottomRight = (y + 1) * resolution + x + 1;
-
-                // Triangle 1
-                mLod[k].indices.push_back(topLeft);
-                mLod[k].indices.push_back(bottomLeft);
-                mLod[k].indices.push_back(topRight);
-
-                // Triangle 2
-                mLod[k].indices.push_back(topRight);
-                mLod[k].indices.push_back(bottomLeft);
-                mLod[k].indices.push_back(bottomRight);
-            }
-        }
+        mLod[k].indices = &gridIndices[k];
     }
 }
 
@@ -183,14 +224,14 @@ void Patch::render()
 {
     int lodLevel = this->mLodLevel;
     glBindVertexArray(mVao[lodLevel]);
-    glDrawElements(GL_TRIANGLES, mLod[lodLevel].indices.size(), GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, mLod[lodLevel].indices->size(), GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
 }
 
 int Patch::chooseLod(glm::vec3 cameraPos, Frustrum *frustrum)
 {
-    float centreX = (mPatchX * PATCH_SIZE + PATCH_SIZE * 0.5f) / mXzFactor;
-    float centreZ = (mPatchZ * PATCH_SIZE + PATCH_SIZE * 0.5f) / mXzFactor;
+    float centreX = (mOriginX + static_cast<int>(mPatchX) * PATCH_SIZE + PATCH_SIZE * 0.5f) / mXzFactor;
+    float centreZ = (mOriginZ + static_cast<int>(mPatchZ) * PATCH_SIZE + PATCH_SIZE * 0.5f) / mXzFactor;
     float hauteurMoyenne = 0.5f;
 
     glm::vec3 centre(centreX, hauteurMoyenne, centreZ);
@@ -228,6 +269,11 @@ int Patch::getLodLevel()
     return this->mLodLevel;
 }
 
+const std::vector<Vertex> &Patch::getLodVertices(int lodLevel) const
+{
+    return this->mLod[lodLevel].vertices;
+}
+
 void Patch::setLodLevel(int level)
 {
     this->mLodLevel = level;
@@ -259,8 +305,8 @@ void Patch::uploadSingleLodToGpu(int lodLevel)
     glBufferSubData(
         GL_ELEMENT_ARRAY_BUFFER,
         0,
-        mLod[lodLevel].indices.size() * sizeof(unsigned int),
-        mLod[lodLevel].indices.data()
+        mLod[lodLevel].indices->size() * sizeof(unsigned int),
+        mLod[lodLevel].indices->data()
     );
 
     glBindVertexArray(0);
@@ -0,0 +1,193 @@
+#include "PerfCounters.hpp"
+
+#include <cstdint>
+#include <cstring>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+#ifdef __linux__
+int openEvent(PerfCounters::Event event)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch (event)
+    {
+    case PerfCounters::Cycles:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case PerfCounters::Instructions:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case PerfCounters::LlcMisses:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case PerfCounters::DtlbMisses:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB
+                    | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case PerfCounters::BranchMisses:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    default:
+        return -1;
+    }
+
+    // pid = 0, cpu = -1 : le thread appelant, sur n'importe quel coeur
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+} // namespace
+
+double PerfCounters::Sample::ipc() const
+{
+    if (!has(Cycles) || !has(Instructions) || values[Cycles] <= 0.0)
+        return -1.0;
+
+    return values[Instructions] / values[Cycles];
+}
+
+PerfCounters::~PerfCounters()
+{
+    close();
+}
+
+bool PerfCounters::open()
+{
+    close();
+
+#ifdef __linux__
+#ifdef _OPENMP
+    mThreads = omp_get_max_threads();
+#else
+    mThreads = 1;
+#endif
+
+    mFds.assign(static_cast<std::size_t>(mThreads) * EventCount, -1);
+
+    #pragma omp parallel num_threads(mThreads)
+    {
+#ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+#else
+        const int tid = 0;
+#endif
+        for (int e = 0; e < EventCount; ++e)
+            mFds[tid * EventCount + e] = openEvent(static_cast<Event>(e));
+    }
+
+    for (int fd : mFds)
+    {
+        if (fd >= 0)
+            return true;
+    }
+
+    close();
+#endif
+
+    return false;
+}
+
+void PerfCounters::close()
+{
+#ifdef __linux__
+    for (int fd : mFds)
+    {
+        if (fd >= 0)
+            ::close(fd);
+    }
+#endif
+
+    mFds.clear();
+    mThreads = 0;
+}
+
+void PerfCounters::start()
+{
+#ifdef __linux__
+    for (int fd : mFds)
+    {
+        if (fd < 0)
+            continue;
+
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+PerfCounters::Sample PerfCounters::stop()
+{
+    Sample sample;
+
+#ifdef __linux__
+    for (int fd : mFds)
+    {
+        if (fd >= 0)
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    for (int t = 0; t < mThreads; ++t)
+    {
+        for (int e = 0; e < EventCount; ++e)
+        {
+            const int fd = mFds[t * EventCount + e];
+            if (fd < 0)
+                continue;
+
+            // valeur, temps activé, temps effectivement compté
+            uint64_t data[3] = {0, 0, 0};
+            if (read(fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+                continue;
+
+            double value = static_cast<double>(data[0]);
+            if (data[2] > 0 && data[2] < data[1])
+                value *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+
+            sample.values[e] += value;
+            sample.valid[e] = true;
+        }
+    }
+#endif
+
+    return sample;
+}
+
+const char *PerfCounters::eventName(Event event)
+{
+    switch (event)
+    {
+    case Cycles:
+        return "cycles";
+    case Instructions:
+        return "instructions";
+    case LlcMisses:
+        return "llc_misses";
+    case DtlbMisses:
+        return "dtlb_misses";
+    case BranchMisses:
+        return "branch_misses";
+    default:
+        return "unknown";
+    }
+}
@@ -1,11 +1,235 @@
 #include "PerlinNoiseTerrain.hpp"
+#include "CounterRng.hpp"
+#include "NumaPlacement.hpp"
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <numeric>
 #include <cstdlib>
+#include <chrono>
+
+namespace
+{
+/// Fade function (6t^5 - 15t^4 + 10t^3), usable inside SIMD loops.
+inline float FadeCurve(float t)
+{
+    return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+/// Integer hash of a lattice corner (multiply-xorshift finalizer).
+inline uint32_t HashCorner(int x, int y, uint32_t seed)
+{
+    uint32_t h = (static_cast<uint32_t>(x) * 0x8DA6B343u) ^ (static_cast<uint32_t>(y) * 0xD8163841u) ^ seed;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+/**
+ * Dot product of (dx, dy) with one of the 8 gradients of the scalar table,
+ * picked by selects instead of a lookup: bits 0-1 are the signs, bit 2
+ * chooses between a diagonal and an axis, bit 3 chooses the axis.
+ */
+inline float GradientDot(uint32_t h, float dx, float dy)
+{
+    const float sx = (h & 1u) ? -dx : dx;
+    const float sy = (h & 2u) ? -dy : dy;
+    const float axis = (h & 8u) ? sy : sx;
+    return (h & 4u) ? axis : sx + sy;
+}
+
+/// Floor for values in int range, by truncation and correction.
+inline int FloorToInt(float v)
+{
+    const int t = static_cast<int>(v);
+    return t - (v < static_cast<float>(t) ? 1 : 0);
+}
+
+using NoiseParams = PerlinNoiseTerrain::NoiseParams;
+constexpr int BATCH = PerlinNoiseTerrain::NOISE_BATCH;
+
+/**
+ * Basis functions evaluate one noise sample in [-1, 1]; they are inlined
+ * in the lane loops of RunPipeline.
+ */
+struct GradientBasis
+{
+    static inline float Sample(float x, float y, uint32_t seed)
+    {
+        const int x0 = FloorToInt(x);
+        const int y0 = FloorToInt(y);
+        const float xf = x - static_cast<float>(x0);
+        const float yf = y - static_cast<float>(y0);
+
+        const float tl = GradientDot(HashCorner(x0,     y0,     seed), xf,     yf);
+        const float tr = GradientDot(HashCorner(x0 + 1, y0,     seed), xf - 1, yf);
+        const float bl = GradientDot(HashCorner(x0,     y0 + 1, seed), xf,     yf - 1);
+        const float br = GradientDot(HashCorner(x0 + 1, y0 + 1, seed), xf - 1, yf - 1);
+
+        const float u = FadeCurve(xf);
+        const float v = FadeCurve(yf);
+        const float top = tl + u * (tr - tl);
+        const float bottom = bl + u * (br - bl);
+
+        return top + v * (bottom - top);
+    }
+};
+
+/**
+ * Combiners fold octave number `octave` (basis value n, amplitude) into
+ * the per-sample state (sum, weight); weight starts at 1.
+ */
+struct FBmCombiner
+{
+    static inline void Accumulate(float n, int, float amplitude, const NoiseParams&, float& sum, float&)
+    {
+        sum += amplitude * n;
+    }
+};
+
+struct RidgedCombiner
+{
+    static inline void Accumulate(float n, int, float amplitude, const NoiseParams& p, float& sum, float& weight)
+    {
+        float signal = p.offset - std::fabs(n);
+        signal *= signal;
+        signal *= weight;
+
+        weight = std::min(std::max(signal * p.gain, 0.0f), 1.0f);
+        sum += signal * amplitude;
+    }
+};
+
+struct HybridCombiner
+{
+    static inline void Accumulate(float n, int octave, float amplitude, const NoiseParams& p, float& sum, float& weight)
+    {
+        const float signal = (n + p.offset) * amplitude;
+
+        if (octave == 0)
+        {
+            sum = signal;
+            weight = signal;
+        }
+        else
+        {
+            sum += weight * signal;
+            weight *= signal;
+        }
+
+        weight = std::min(std::max(weight, 0.0f), 1.0f);
+    }
+};
+
+/**
+ * Displaces the batch coordinates by a two-octave noise vector, with
+ * seeds distinct from those of the main octaves.
+ */
+template <class Basis>
+inline void WarpBatch(const NoiseParams& p, float* px, float* py)
+{
+    const uint32_t seedX = p.seed ^ 0x68E31DA4u;
+    const uint32_t seedY = p.seed ^ 0xB5297A4Du;
+
+    #pragma omp simd
+    for (int i = 0; i < BATCH; ++i)
+    {
+        const float wx = Basis::Sample(px[i], py[i], seedX) + 0.5f * Basis::Sample(2.0f * px[i], 2.0f * py[i], seedX + 1);
+        const float wy = Basis::Sample(px[i], py[i], seedY) + 0.5f * Basis::Sample(2.0f * px[i], 2.0f * py[i], seedY + 1);
+
+        px[i] += p.warpStrength * wx;
+        py[i] += p.warpStrength * wy;
+    }
+}
+
+/**
+ * Noise pipeline specialised at compile time: samples are processed by
+ * batches of NOISE_BATCH consecutive columns, octaves outermost so that
+ * the batch state stays in registers, lanes innermost for SIMD.
+ */
+template <class Basis, class Combiner, bool Warp>
+void RunPipeline(const NoiseParams& p, int x0, int z0, int width, int height, float* out)
+{
+    for (int z = 0; z < height; ++z)
+    {
+        float* row = out + static_cast<size_t>(z) * width;
+        const float y = static_cast<float>(z0 + z) * p.frequency;
+
+        for (int x = 0; x < width; x += BATCH)
+        {
+            float px[BATCH];
+            float py[BATCH];
+            float sum[BATCH];
+            float weight[BATCH];
+
+            // Full batches even at the end of the row: the extra lanes
+            // are computed and dropped, the trip count stays constant.
+            #pragma omp simd
+            for (int i = 0; i < BATCH; ++i)
+            {
+                px[i] = static_cast<float>(x0 + x + i) * p.frequency;
+                py[i] = y;
+                sum[i] = 0.0f;
+                weight[i] = 1.0f;
+            }
+
+            if (Warp)
+                WarpBatch<Basis>(p, px, py);
+
+            float amplitude = 1.0f;
+            float freq = 1.0f;
+
+            for (int o = 0; o < p.octaves; ++o)
+            {
+                // Each octave hashes with its own seed so that the octaves
+                // do not share their lattice gradients.
+                const uint32_t octaveSeed = p.seed + 0x9E3779B9u * static_cast<uint32_t>(o);
+
+                #pragma omp simd
+                for (int i = 0; i < BATCH; ++i)
+                {
+                    const float n = Basis::Sample(px[i] * freq, py[i] * freq, octaveSeed);
+                    Combiner::Accumulate(n, o, amplitude, p, sum[i], weight[i]);
+                }
+
+                amplitude *= p.persistence;
+                freq *= p.lacunarity;
+            }
+
+            std::copy(sum, sum + std::min(BATCH, width - x), row + x);
+        }
+    }
+}
+} // namespace
 
 PerlinNoiseTerrain::PerlinNoiseTerrain() {}
 
+void PerlinNoiseTerrain::SetNoiseKernel(NoiseKernel kernel)
+{
+    mNoiseKernel = kernel;
+}
+
+void PerlinNoiseTerrain::SetNoiseType(NoiseType type, float offset, float gain)
+{
+    mNoiseType = type;
+    mOffset = offset;
+    mGain = gain;
+}
+
+void PerlinNoiseTerrain::SetDomainWarp(bool enabled, float strength)
+{
+    mWarp = enabled;
+    mWarpStrength = strength;
+}
+
+double PerlinNoiseTerrain::GetNoiseTimeMs() const
+{
+    return mNoiseTimeMs;
+}
+
 void PerlinNoiseTerrain::CreatePerlinNoise(int width, int height,
                                            float minHeight, float maxHeight,
                                            float scale,
@@ -23,6 +247,7 @@ void PerlinNoiseTerrain::CreatePerlinNoise(int width, int height,
     this->mBorderSize = 0;
 
     this->mData.assign(width * height, 0.0f);
+    NumaPlacement::place(mData);
 
     this->mRenderer = (std::make_unique<RendererManager>(this));
 
@@ -31,14 +256,31 @@ void PerlinNoiseTerrain::CreatePerlinNoise(int width, int height,
     mPersistenceCoef = persistence;
     mLacunarityCoef = lacunarity;
 
-    InitPermutation();
-    CreatePerlinNoiseInternal(minHeight, maxHeight);
-    Normalize();
+    const auto t0 = std::chrono::high_resolution_clock::now();
+
+    float rawMin = 0.0f;
+    float rawMax = 0.0f;
+
+    // The scalar kernel only implements plain fBm
+    if (mNoiseKernel == NoiseKernel::Vectorized || mNoiseType != NoiseType::FBm || mWarp)
+    {
+        CreatePerlinNoiseVectorized(rawMin, rawMax);
+    }
+    else
+    {
+        InitPermutation();
+        CreatePerlinNoiseInternal(rawMin, rawMax);
+    }
+
+    mNoiseTimeMs = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - t0).count();
+
+    normalizeHeights(rawMin, rawMax);
 
     createPatches();
 }
 
-void PerlinNoiseTerrain::CreatePerlinNoiseInternal(float minH, float maxH)
+void PerlinNoiseTerrain::CreatePerlinNoiseInternal(float& rawMin, float& rawMax)
 {
     float* data = mData.data();
     const int width = mWidth;
@@ -48,7 +290,10 @@ void PerlinNoiseTerrain::CreatePerlinNoiseInternal(float minH, float maxH)
     const float persistence = mPersistenceCoef;
     const float lacunarity = mLacunarityCoef;
 
-    #pragma omp parallel for schedule(static)
+    float lo = std::numeric_limits<float>::max();
+    float hi = std::numeric_limits<float>::lowest();
+
+    #pragma omp parallel for schedule(static) reduction(min:lo) reduction(max:hi)
     for (int z = 0; z < height; ++z)
     {
         const int rowOffset = z * width;
@@ -70,8 +315,120 @@ void PerlinNoiseTerrain::CreatePerlinNoiseInternal(float minH, float maxH)
             }
 
             data[rowOffset + x] = noise;
+            lo = std::min(lo, noise);
+            hi = std::max(hi, noise);
+        }
+    }
+
+    rawMin = lo;
+    rawMax = hi;
+}
+
+void PerlinNoiseTerrain::CreatePerlinNoiseVectorized(float& rawMin, float& rawMax)
+{
+    float* data = mData.data();
+    const int width = mWidth;
+    const int height = mHeight;
+    const NoiseParams params = GetParams();
+
+    float lo = std::numeric_limits<float>::max();
+    float hi = std::numeric_limits<float>::lowest();
+
+    // The row has just been written and is still in L1: its min/max costs
+    // no extra trip to memory.
+    #pragma omp parallel for schedule(static) reduction(min:lo) reduction(max:hi)
+    for (int z = 0; z < height; ++z)
+    {
+        float* row = data + static_cast<size_t>(z) * width;
+        GenerateRegion(params, 0, z, width, 1, row);
+
+        #pragma omp simd reduction(min:lo) reduction(max:hi)
+        for (int x = 0; x < width; ++x)
+        {
+            lo = std::min(lo, row[x]);
+            hi = std::max(hi, row[x]);
         }
     }
+
+    rawMin = lo;
+    rawMax = hi;
+}
+
+PerlinNoiseTerrain::NoiseParams PerlinNoiseTerrain::GetParams() const
+{
+    NoiseParams params;
+    params.seed = mSeed;
+    params.frequency = mBaseFrequency;
+    params.octaves = mNumOctaves;
+    params.persistence = mPersistenceCoef;
+    params.lacunarity = mLacunarityCoef;
+    params.type = mNoiseType;
+    params.offset = mOffset;
+    params.gain = mGain;
+    params.warp = mWarp;
+    params.warpStrength = mWarpStrength;
+    return params;
+}
+
+void PerlinNoiseTerrain::GenerateRegion(const NoiseParams& params, int x0, int z0, int width, int height, float* out)
+{
+    switch (params.type)
+    {
+    case NoiseType::FBm:
+        if (params.warp)
+            RunPipeline<GradientBasis, FBmCombiner, true>(params, x0, z0, width, height, out);
+        else
+            RunPipeline<GradientBasis, FBmCombiner, false>(params, x0, z0, width, height, out);
+        break;
+
+    case NoiseType::Ridged:
+        if (params.warp)
+            RunPipeline<GradientBasis, RidgedCombiner, true>(params, x0, z0, width, height, out);
+        else
+            RunPipeline<GradientBasis, RidgedCombiner, false>(params, x0, z0, width, height, out);
+        break;
+
+    case NoiseType::Hybrid:
+        if (params.warp)
+            RunPipeline<GradientBasis, HybridCombiner, true>(params, x0, z0, width, height, out);
+        else
+            RunPipeline<GradientBasis, HybridCombiner, false>(params, x0, z0, width, height, out);
+        break;
+    }
+}
+
+void PerlinNoiseTerrain::OutputRange(const NoiseParams& params, float& low, float& high)
+{
+    // |basis| <= 1 and every combiner weight stays in [0, 1]
+    float amplitudes = 0.0f;
+    float amplitude = 1.0f;
+
+    for (int o = 0; o < params.octaves; ++o)
+    {
+        amplitudes += amplitude;
+        amplitude *= params.persistence;
+    }
+
+    switch (params.type)
+    {
+    case NoiseType::FBm:
+        low = -amplitudes;
+        high = amplitudes;
+        break;
+
+    case NoiseType::Ridged:
+    {
+        const float peak = std::max(params.offset * params.offset, (params.offset - 1.0f) * (params.offset - 1.0f));
+        low = 0.0f;
+        high = peak * amplitudes;
+        break;
+    }
+
+    case NoiseType::Hybrid:
+        low = std::min(0.0f, params.offset - 1.0f) * amplitudes;
+        high = (params.offset + 1.0f) * amplitudes;
+        break;
+    }
 }
 
 void PerlinNoiseTerrain::InitPermutation()
@@ -80,9 +437,11 @@ void PerlinNoiseTerrain::InitPermutation()
     std::vector<int> p(256);
     std::iota(p.begin(), p.end(), 0);
 
+    const uint64_t stream = CounterRng::stream(CounterRng::PerlinPermutation, 0);
+
     for (int i = 255; i > 0; --i)
     {
-        int j = rand() % (i + 1);
+        int j = CounterRng::below(mSeed, stream, i, i + 1);
         std::swap(p[i], p[j]);
     }
 
@@ -152,27 +511,3 @@ inline float PerlinNoiseTerrain::Lerp(float a, float b, float t) const
 {
     return a + t * (b - a);
 }
-
-void PerlinNoiseTerrain::Normalize()
-{
-    auto minMax = std::minmax_element(mData.begin(), mData.end());
-
-    const float minVal = *minMax.first;
-    const float maxVal = *minMax.second;
-    const float minMaxDelta = maxVal - minVal;
-    const float minMaxRange = mMaxHeight - mMinHeight;
-
-    if (minMaxDelta == 0.0f)
-    {
-        std::fill(mData.begin(), mData.end(), mMinHeight);
-        return;
-    }
-
-    const float scale = minMaxRange / minMaxDelta;
-
-    #pragma omp parallel for schedule(static)
-    for (int i = 0; i < static_cast<int>(mData.size()); ++i)
-    {
-        mData[i] = (mData[i] - minVal) * scale + mMinHeight;
-    }
-}
\ No newline at end of file
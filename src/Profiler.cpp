@@ -0,0 +1,323 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+/**
+ * Emplacement du tampon, protégé par un verrou de séquence : seq vaut i + 1
+ * quand l'emplacement contient l'événement i, 0 pendant son écriture. Les
+ * champs sont atomiques (accès relâchés) pour que la lecture concurrente ne
+ * soit pas une course de données.
+ */
+struct Slot
+{
+    std::atomic<uint64_t> seq{0};
+    std::atomic<const char *> name{nullptr};
+    std::atomic<uint64_t> startNs{0};
+    std::atomic<uint64_t> endNs{0};
+};
+
+/**
+ * Tampon d'un thread : seul ce thread écrit slots et head. Le lecteur
+ * (thread principal) écarte les emplacements réécrits pendant sa lecture.
+ * owned repasse à false à la sortie du thread : le tampon est alors repris
+ * par le prochain thread qui enregistre un événement.
+ */
+struct ThreadRing
+{
+    int tid = 0;
+    std::atomic<bool> owned{true};
+    Slot slots[Profiler::RING_CAPACITY];
+    std::atomic<uint64_t> head{0};
+
+    // Côté lecteur uniquement
+    uint64_t drained = 0;
+    uint64_t exportFrom = 0;
+};
+
+std::atomic<bool> gEnabled{true};
+
+std::mutex gRegistryMutex;
+std::vector<std::unique_ptr<ThreadRing>> gRings;
+
+// Agrégats, manipulés par le thread principal uniquement
+std::vector<Profiler::PhaseStats> gPhases;
+std::unordered_map<std::string, std::size_t> gPhaseIndex;
+std::vector<double> gFrameSums;
+Profiler::PhaseStats gFrameStats;
+int gFrameIndex = 0;
+uint64_t gLastFrameNs = 0;
+
+/**
+ * Rend le tampon à la sortie du thread : les threads de génération et les
+ * workers du streaming vont et viennent, le registre reste borné par le
+ * nombre de threads vivants en même temps.
+ */
+struct RingLease
+{
+    ThreadRing *ring = nullptr;
+
+    ~RingLease()
+    {
+        if (ring)
+            ring->owned.store(false, std::memory_order_release);
+    }
+};
+
+ThreadRing *localRing()
+{
+    thread_local RingLease lease;
+
+    if (!lease.ring)
+    {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+
+        // Les événements laissés par l'ancien propriétaire restent lisibles :
+        // head et les numéros de séquence continuent depuis où il s'était arrêté.
+        for (std::unique_ptr<ThreadRing> &ring : gRings)
+        {
+            if (!ring->owned.load(std::memory_order_acquire))
+            {
+                ring->owned.store(true, std::memory_order_relaxed);
+                lease.ring = ring.get();
+                break;
+            }
+        }
+
+        if (!lease.ring)
+        {
+            gRings.push_back(std::make_unique<ThreadRing>());
+            lease.ring = gRings.back().get();
+            lease.ring->tid = static_cast<int>(gRings.size()) - 1;
+        }
+    }
+
+    return lease.ring;
+}
+
+// Visite des événements [from, head) encore présents dans le tampon
+template <typename Visitor> uint64_t readRing(const ThreadRing &ring, uint64_t from, Visitor visit)
+{
+    const uint64_t head = ring.head.load(std::memory_order_acquire);
+    const uint64_t capacity = Profiler::RING_CAPACITY;
+
+    from = std::max(from, head > capacity ? head - capacity : 0);
+
+    for (uint64_t i = from; i < head; ++i)
+    {
+        const Slot &slot = ring.slots[i % capacity];
+
+        // L'événement i a déjà été remplacé, ou est en cours de remplacement
+        const uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before != i + 1)
+            continue;
+
+        Profiler::Event event;
+        event.name = slot.name.load(std::memory_order_relaxed);
+        event.startNs = slot.startNs.load(std::memory_order_relaxed);
+        event.endNs = slot.endNs.load(std::memory_order_relaxed);
+
+        // Réécrit pendant la copie : les champs peuvent mêler deux événements
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != before)
+            continue;
+
+        visit(event);
+    }
+
+    return head;
+}
+
+std::size_t phaseSlot(const std::string &name, bool gpu)
+{
+    const std::string key = gpu ? "gpu:" + name : name;
+
+    auto it = gPhaseIndex.find(key);
+    if (it != gPhaseIndex.end())
+        return it->second;
+
+    Profiler::PhaseStats stats;
+    stats.name = name;
+    stats.gpu = gpu;
+
+    gPhases.push_back(stats);
+    gFrameSums.push_back(0.0);
+    gPhaseIndex.emplace(key, gPhases.size() - 1);
+    return gPhases.size() - 1;
+}
+
+void pushHistory(Profiler::PhaseStats &stats, double ms)
+{
+    stats.lastMs = ms;
+    stats.history[gFrameIndex % Profiler::HISTORY_FRAMES] = static_cast<float>(ms);
+
+    const int count = std::min(gFrameIndex + 1, Profiler::HISTORY_FRAMES);
+    double sum = 0.0;
+    double peak = 0.0;
+    for (int i = 0; i < count; ++i)
+    {
+        sum += stats.history[i];
+        peak = std::max(peak, static_cast<double>(stats.history[i]));
+    }
+
+    stats.avgMs = sum / count;
+    stats.maxMs = peak;
+}
+} // namespace
+
+void Profiler::setEnabled(bool enabled)
+{
+    gEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::isEnabled()
+{
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now()
+{
+    const auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) + 1;
+}
+
+void Profiler::record(const char *name, uint64_t startNs, uint64_t endNs)
+{
+    ThreadRing *ring = localRing();
+
+    const uint64_t head = ring->head.load(std::memory_order_relaxed);
+    Slot &slot = ring->slots[head % RING_CAPACITY];
+
+    // Aucun champ ne devient visible avant le passage de seq à 0
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startNs.store(startNs, std::memory_order_relaxed);
+    slot.endNs.store(endNs, std::memory_order_relaxed);
+
+    slot.seq.store(head + 1, std::memory_order_release);
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::recordGpu(const char *name, double ms)
+{
+    gFrameSums[phaseSlot(name, true)] += ms;
+}
+
+void Profiler::endFrame()
+{
+    {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+
+        for (std::unique_ptr<ThreadRing> &ring : gRings)
+        {
+            ring->drained = readRing(*ring, ring->drained, [](const Event &event) {
+                gFrameSums[phaseSlot(event.name, false)] += (event.endNs - event.startNs) * 1e-6;
+            });
+        }
+    }
+
+    for (std::size_t p = 0; p < gPhases.size(); ++p)
+    {
+        pushHistory(gPhases[p], gFrameSums[p]);
+        gFrameSums[p] = 0.0;
+    }
+
+    const uint64_t nowNs = now();
+    gFrameStats.name = "frame";
+    pushHistory(gFrameStats, gLastFrameNs ? (nowNs - gLastFrameNs) * 1e-6 : 0.0);
+    gLastFrameNs = nowNs;
+
+    ++gFrameIndex;
+}
+
+const std::vector<Profiler::PhaseStats> &Profiler::getPhases()
+{
+    return gPhases;
+}
+
+const Profiler::PhaseStats &Profiler::getFrameStats()
+{
+    return gFrameStats;
+}
+
+int Profiler::frameIndex()
+{
+    return gFrameIndex;
+}
+
+bool Profiler::exportChromeTrace(const std::string &path)
+{
+    std::ofstream out(path);
+    if (!out)
+    {
+        std::cerr << "Erreur : impossible d'écrire la trace " << path << std::endl;
+        return false;
+    }
+
+    struct TracedEvent
+    {
+        int tid;
+        Event event;
+    };
+
+    std::vector<TracedEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+
+        for (const std::unique_ptr<ThreadRing> &ring : gRings)
+        {
+            const int tid = ring->tid;
+            readRing(*ring, ring->exportFrom, [&](const Event &event) { events.push_back({tid, event}); });
+        }
+    }
+
+    uint64_t origin = 0;
+    for (const TracedEvent &traced : events)
+        origin = (origin == 0) ? traced.event.startNs : std::min(origin, traced.event.startNs);
+
+    // Événements complets ("ph": "X"), horodatés en microsecondes
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        const Event &event = events[i].event;
+        out << (i ? ",\n" : "\n")
+            << "{\"name\":\"" << event.name << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":" << events[i].tid
+            << ",\"ts\":" << (event.startNs - origin) * 1e-3
+            << ",\"dur\":" << (event.endNs - event.startNs) * 1e-3 << "}";
+    }
+    out << "\n]}\n";
+
+    std::cout << events.size() << " événements écrits dans " << path << std::endl;
+    return static_cast<bool>(out);
+}
+
+void Profiler::reset()
+{
+    {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+
+        for (std::unique_ptr<ThreadRing> &ring : gRings)
+        {
+            const uint64_t head = ring->head.load(std::memory_order_acquire);
+            ring->drained = head;
+            ring->exportFrom = head;
+        }
+    }
+
+    gPhases.clear();
+    gPhaseIndex.clear();
+    gFrameSums.clear();
+    gFrameStats = PhaseStats();
+    gFrameIndex = 0;
+    gLastFrameNs = 0;
+}
@@ -1,4 +1,5 @@
 #include "RendererManager.hpp"
+#include "Profiler.hpp"
 
 RendererManager::RendererManager(Terrain *terrain)
 {
@@ -32,13 +33,19 @@ void RendererManager::renderLod(const glm::vec3 &cameraPos, glm::mat4 &projectio
 
     if (mLodIsOn)
     {
-        int temp = 0;
-        for (int i = 0; i < patches.size(); ++i)
         {
-            temp = patches[i]->chooseLod(cameraPos, mFrustrum);
-            patches[i]->setLodLevel(temp);
+            PROFILE_SCOPE("chooseLod");
+
+            int temp = 0;
+            for (int i = 0; i < patches.size(); ++i)
+            {
+                temp = patches[i]->chooseLod(cameraPos, mFrustrum);
+                patches[i]->setLodLevel(temp);
+            }
         }
 
+        PROFILE_SCOPE("drawPatches");
+
         int patchRendered = 0;
         for (int i = 0; i < patches.size(); ++i)
         {
@@ -55,6 +62,8 @@ void RendererManager::renderLod(const glm::vec3 &cameraPos, glm::mat4 &projectio
     }
     else
     {
+        PROFILE_SCOPE("drawPatches");
+
         for (int i = 0; i < patches.size(); ++i)
         {
             patches[i]->setLodLevel(0);
@@ -65,6 +74,8 @@ void RendererManager::renderLod(const glm::vec3 &cameraPos, glm::mat4 &projectio
 
 void RendererManager::correctLod()
 {
+    PROFILE_SCOPE("correctLod");
+
     bool changed;
     int temp = 0;
     std::vector<std::unique_ptr<Patch>> &patches = mTerrain->getPatches();
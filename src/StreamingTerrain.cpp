@@ -0,0 +1,300 @@
+#include "StreamingTerrain.hpp"
+#include "RendererManager.hpp"
+#include "ThermalKernel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+int floorDiv(int a, int b)
+{
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+/**
+ * Un pas d'érosion thermique deux phases sur une fenêtre carrée : toutes
+ * les cellules lisent src. L'anneau externe ne sert que de voisinage.
+ */
+void erodeWindow(const std::vector<float> &src, std::vector<float> &dst, int size, const int *offsets,
+                 float talus, float transferRate)
+{
+    dst = src;
+
+    ThermalKernel::CellMove move;
+    for (int i = 1; i < size - 1; ++i)
+    {
+        for (int j = 1; j < size - 1; ++j)
+            ThermalKernel::erodeCell(src.data(), dst.data(), i * size + j, offsets, 8, talus, transferRate, move);
+    }
+}
+} // namespace
+
+StreamingTerrain::StreamingTerrain(TileGenerator generator, float minHeight, float maxHeight,
+                                   const StreamingConfig &config, float xzFactor)
+    : mGenerator(std::move(generator)), mConfig(config)
+{
+    this->mWidth = 0;
+    this->mHeight = 0;
+    this->mMinHeight = minHeight;
+    this->mMaxHeight = maxHeight;
+    this->mYFactor = 1.0f;
+    this->mXzFactor = xzFactor;
+    this->mBorderSize = 0;
+    this->mCellSpacing = 1;
+    this->mTexture = nullptr;
+
+    this->mRenderer = std::make_unique<RendererManager>(this);
+
+    const float PI = 3.14159265f;
+    mTalus = std::tan(mConfig.talusAngle * PI / 180.0f);
+    mConfig.erosionSteps = std::max(0, mConfig.erosionSteps);
+    mConfig.viewRadius = std::max(1, mConfig.viewRadius);
+    mConfig.uploadsPerFrame = std::max(1, mConfig.uploadsPerFrame);
+
+    const int R = mConfig.viewRadius;
+    for (int dz = -R; dz <= R; ++dz)
+    {
+        for (int dx = -R; dx <= R; ++dx)
+        {
+            if (dx * dx + dz * dz <= R * R)
+                mRingOffsets.emplace_back(dx, dz);
+        }
+    }
+
+    std::stable_sort(mRingOffsets.begin(), mRingOffsets.end(),
+                     [](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+                         return a.first * a.first + a.second * a.second < b.first * b.first + b.second * b.second;
+                     });
+
+    // Le disque de vue doit toujours tenir dans le cache
+    mConfig.cacheTiles = std::max(mConfig.cacheTiles, static_cast<int>(mRingOffsets.size()));
+
+    int workers = mConfig.workers;
+    if (workers <= 0)
+        workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+
+    for (int w = 0; w < workers; ++w)
+        mWorkers.emplace_back(&StreamingTerrain::workerLoop, this);
+}
+
+StreamingTerrain::~StreamingTerrain()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCondition.notify_all();
+
+    for (std::thread &worker : mWorkers)
+        worker.join();
+
+    // Seules les tuiles intégrées par update() ont des buffers OpenGL
+    for (std::unique_ptr<Patch> &patch : mPatches)
+        patch->deleteBuffersGL();
+}
+
+uint64_t StreamingTerrain::tileKey(int tx, int tz)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(tx)) << 32) | static_cast<uint32_t>(tz);
+}
+
+int StreamingTerrain::tileX(uint64_t key)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+}
+
+int StreamingTerrain::tileZ(uint64_t key)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(key));
+}
+
+void StreamingTerrain::generateTile(const TileGenerator &generator, int tx, int tz, int erosionSteps,
+                                    float talus, float transferRate, std::vector<float> &heights)
+{
+    const int halo = 2 * erosionSteps;
+    const int size = TILE_SAMPLES + 2 * halo;
+
+    std::vector<float> src(static_cast<size_t>(size) * size);
+    std::vector<float> dst(src.size());
+
+    generator(tx * PATCH_SIZE - halo, tz * PATCH_SIZE - halo, size, size, src.data());
+
+    int offsets[8];
+    ThermalKernel::indexOffsets(size, 8, offsets);
+
+    for (int s = 0; s < erosionSteps; ++s)
+    {
+        erodeWindow(src, dst, size, offsets, talus, transferRate);
+        std::swap(src, dst);
+    }
+
+    heights.resize(static_cast<size_t>(TILE_SAMPLES) * TILE_SAMPLES);
+    for (int z = 0; z < TILE_SAMPLES; ++z)
+    {
+        std::memcpy(&heights[z * TILE_SAMPLES], &src[(z + halo) * size + halo], TILE_SAMPLES * sizeof(float));
+    }
+}
+
+void StreamingTerrain::workerLoop()
+{
+#ifdef _OPENMP
+    // Déjà un worker par cœur : une source parallélisée avec OpenMP ne doit
+    // pas lancer une équipe complète dans chacun d'eux
+    omp_set_num_threads(1);
+#endif
+
+    std::vector<float> heights;
+
+    while (true)
+    {
+        uint64_t key;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this] { return mStop || !mQueue.empty(); });
+
+            if (mStop)
+                return;
+
+            key = mQueue.front();
+            mQueue.pop_front();
+        }
+
+        const int tx = tileX(key);
+        const int tz = tileZ(key);
+
+        generateTile(mGenerator, tx, tz, mConfig.erosionSteps, mTalus, mConfig.transferRate, heights);
+
+        // Le maillage CPU est fait ici : le thread de rendu ne fait que
+        // créer les buffers. mTexture est initialisée plus tard par le
+        // thread de rendu et n'est pas utilisée par Patch.
+        auto patch = std::make_unique<Patch>();
+        patch->setPatch(0, 0, mXzFactor, 1, 1, nullptr);
+        patch->setWorldOrigin(tx * PATCH_SIZE, tz * PATCH_SIZE, TEXTURE_EXTENT);
+        patch->generateLodIndices();
+        patch->generateLodVertices(heights, TILE_SAMPLES, TILE_SAMPLES);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mReady.push_back({key, std::move(patch)});
+    }
+}
+
+void StreamingTerrain::update(const glm::vec3 &cameraPos)
+{
+    ++mFrame;
+
+    std::vector<ReadyTile> ready;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        const int count = std::min(static_cast<int>(mReady.size()), mConfig.uploadsPerFrame);
+        for (int i = 0; i < count; ++i)
+            ready.push_back(std::move(mReady[i]));
+        mReady.erase(mReady.begin(), mReady.begin() + count);
+    }
+
+    for (ReadyTile &tile : ready)
+    {
+        mRequested.erase(tile.key);
+
+        tile.patch->createBuffersGL();
+        mResident[tile.key] = {tile.patch.get(), mFrame};
+        mPatches.push_back(std::move(tile.patch));
+    }
+
+    const int cameraTileX = floorDiv(static_cast<int>(std::floor(cameraPos.x * mXzFactor)), PATCH_SIZE);
+    const int cameraTileZ = floorDiv(static_cast<int>(std::floor(cameraPos.z * mXzFactor)), PATCH_SIZE);
+
+    if (!mHasCameraTile || cameraTileX != mCameraTileX || cameraTileZ != mCameraTileZ)
+    {
+        mHasCameraTile = true;
+        mCameraTileX = cameraTileX;
+        mCameraTileZ = cameraTileZ;
+        requestAround(cameraTileX, cameraTileZ);
+    }
+
+    touchVisible(cameraTileX, cameraTileZ);
+
+    if (static_cast<int>(mResident.size()) > mConfig.cacheTiles)
+        evict(cameraTileX, cameraTileZ);
+}
+
+void StreamingTerrain::requestAround(int cameraTileX, int cameraTileZ)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        // Les demandes encore en file concernent l'ancienne position : on
+        // repart de la nouvelle, les tuiles les plus proches en premier.
+        for (uint64_t key : mQueue)
+            mRequested.erase(key);
+        mQueue.clear();
+
+        for (const std::pair<int, int> &offset : mRingOffsets)
+        {
+            const uint64_t key = tileKey(cameraTileX + offset.first, cameraTileZ + offset.second);
+
+            if (mResident.count(key) != 0)
+                continue;
+
+            if (mRequested.insert(key).second)
+                mQueue.push_back(key);
+        }
+    }
+
+    mCondition.notify_all();
+}
+
+void StreamingTerrain::touchVisible(int cameraTileX, int cameraTileZ)
+{
+    // Une tuile restée dans le disque de vue pendant que la caméra se
+    // déplace à l'intérieur de sa tuile doit rester la plus récente.
+    for (const std::pair<int, int> &offset : mRingOffsets)
+    {
+        auto it = mResident.find(tileKey(cameraTileX + offset.first, cameraTileZ + offset.second));
+        if (it != mResident.end())
+            it->second.lastUse = mFrame;
+    }
+}
+
+void StreamingTerrain::evict(int cameraTileX, int cameraTileZ)
+{
+    const int R = mConfig.viewRadius;
+
+    while (static_cast<int>(mResident.size()) > mConfig.cacheTiles)
+    {
+        auto victim = mResident.end();
+
+        for (auto it = mResident.begin(); it != mResident.end(); ++it)
+        {
+            const int dx = tileX(it->first) - cameraTileX;
+            const int dz = tileZ(it->first) - cameraTileZ;
+            if (dx * dx + dz * dz <= R * R)
+                continue;
+
+            if (victim == mResident.end() || it->second.lastUse < victim->second.lastUse)
+                victim = it;
+        }
+
+        if (victim == mResident.end())
+            return;
+
+        Patch *patch = victim->second.patch;
+        patch->deleteBuffersGL();
+
+        auto owner = std::find_if(mPatches.begin(), mPatches.end(),
+                                  [patch](const std::unique_ptr<Patch> &p) { return p.get() == patch; });
+        if (owner != mPatches.end())
+        {
+            std::swap(*owner, mPatches.back());
+            mPatches.pop_back();
+        }
+
+        mResident.erase(victim);
+    }
+}
@@ -1,7 +1,10 @@
 #include "Terrain.hpp"
 
+#include "NumaPlacement.hpp"
+#include "Profiler.hpp"
 #include "RendererManager.hpp"
 #include "ThermalErosion.hpp"
+#include <cmath>
 #include <fstream>
 #include <omp.h>
 
@@ -21,6 +24,7 @@ void Terrain::loadTerrain(const char *imagePath, float yFactor, float xzFactor)
     }
 
     this->mData.resize(mHeight * mWidth);
+    NumaPlacement::place(mData);
 
     this->mBorderSize = 10;
     this->mCellSpacing = 1;
@@ -42,6 +46,38 @@ void Terrain::loadTerrain(const char *imagePath, float yFactor, float xzFactor)
     createPatches();
 }
 
+bool Terrain::saveSnapshot(const std::string &path, const SnapshotMetadata &metadata,
+                           const SnapshotOptions &options) const
+{
+    return TerrainSnapshot::save(path, mData.data(), mWidth, mHeight, metadata, options);
+}
+
+bool Terrain::loadSnapshot(const std::string &path, float yFactor, float xzFactor,
+                           SnapshotMetadata *metadata)
+{
+    if (!TerrainSnapshot::load(path, mData, mWidth, mHeight, metadata))
+        return false;
+
+    NumaPlacement::place(mData);
+
+    std::cout << "Loaded snapshot of size " << mHeight << " x " << mWidth << std::endl;
+
+    this->mBorderSize = 0;
+    this->mCellSpacing = 1;
+    this->mYFactor = yFactor;
+    this->mXzFactor = xzFactor;
+
+    this->mMaxHeight = *std::max_element(mData.begin(), mData.end());
+    this->mMinHeight = *std::min_element(mData.begin(), mData.end());
+
+    this->mRenderer = (std::make_unique<RendererManager>(this));
+
+    mPatches.clear();
+    createPatches();
+
+    return true;
+}
+
 void Terrain::createPatches()
 {
     int nbPatchX = std::ceil(mWidth / 32);
@@ -57,6 +93,26 @@ void Terrain::createPatches()
             this->mPatches.push_back(std::move(p));
         }
     }
+
+    rebuildHeightPyramid();
+}
+
+void Terrain::rebuildHeightPyramid()
+{
+    PROFILE_SCOPE("rebuildHeightPyramid");
+
+    mHeightPyramid.build(mData.data(), mWidth, mHeight);
+}
+
+void Terrain::updateHeightPyramid(const std::vector<int> &patchIndices)
+{
+    if (!mHeightPyramid.matches(mWidth, mHeight))
+    {
+        rebuildHeightPyramid();
+        return;
+    }
+
+    mHeightPyramid.updateTiles(mData.data(), patchIndices, PATCH_SIZE, mHeight / PATCH_SIZE);
 }
 
 bool Terrain::isInside(int i, int j) const
@@ -64,6 +120,30 @@ bool Terrain::isInside(int i, int j) const
     return (i >= 0 && i < mHeight && j >= 0 && j < mWidth);
 }
 
+void Terrain::normalizeHeights(float rawMin, float rawMax)
+{
+    const float rawDelta = rawMax - rawMin;
+    float *data = mData.data();
+    const int count = static_cast<int>(mData.size());
+
+    if (rawDelta == 0.0f)
+    {
+        std::fill(mData.begin(), mData.end(), mMinHeight);
+        return;
+    }
+
+    const float scale = (mMaxHeight - mMinHeight) / rawDelta;
+    const float minHeight = mMinHeight;
+    const float maxHeight = mMaxHeight;
+
+    #pragma omp parallel for simd schedule(static)
+    for (int i = 0; i < count; ++i)
+    {
+        // rawMax * scale peut dépasser maxHeight d'un arrondi
+        data[i] = std::min((data[i] - rawMin) * scale + minHeight, maxHeight);
+    }
+}
+
 void Terrain::setData(int i, float value)
 {
     this->mData[i] += value;
@@ -74,9 +154,138 @@ std::vector<float> *Terrain::getData()
     return &(this->mData);
 }
 
+CellRect Terrain::applyBrush(const BrushStroke &stroke)
+{
+    PROFILE_SCOPE("applyBrush");
+
+    CellRect rect;
+    if (stroke.radius <= 0.0f || mWidth < 2 || mHeight < 2)
+        return rect;
+
+    rect.xMin = std::max(0, static_cast<int>(std::ceil(stroke.centerX - stroke.radius)));
+    rect.xMax = std::min(mWidth - 1, static_cast<int>(std::floor(stroke.centerX + stroke.radius)));
+    rect.zMin = std::max(0, static_cast<int>(std::ceil(stroke.centerZ - stroke.radius)));
+    rect.zMax = std::min(mHeight - 1, static_cast<int>(std::floor(stroke.centerZ + stroke.radius)));
+
+    if (rect.empty())
+        return rect;
+
+    const float radius2 = stroke.radius * stroke.radius;
+    const float inner = stroke.radius * (1.0f - std::clamp(stroke.falloff, 0.0f, 1.0f));
+    const float ramp = std::max(stroke.radius - inner, 1e-6f);
+
+    // Le lissage lit les hauteurs d'avant le coup, bord d'une cellule compris
+    const CellRect source = rect.expanded(1, mWidth, mHeight);
+    const int sourceWidth = source.xMax - source.xMin + 1;
+    std::vector<float> before;
+    if (stroke.mode == BrushMode::Smooth)
+    {
+        before.resize(static_cast<std::size_t>(sourceWidth) * (source.zMax - source.zMin + 1));
+        for (int z = source.zMin; z <= source.zMax; ++z)
+            std::copy_n(mData.begin() + static_cast<std::size_t>(z) * mWidth + source.xMin, sourceWidth,
+                        before.begin() + static_cast<std::size_t>(z - source.zMin) * sourceWidth);
+    }
+
+    for (int z = rect.zMin; z <= rect.zMax; ++z)
+    {
+        const float dz = z - stroke.centerZ;
+        float *row = mData.data() + static_cast<std::size_t>(z) * mWidth;
+
+        for (int x = rect.xMin; x <= rect.xMax; ++x)
+        {
+            const float dx = x - stroke.centerX;
+            const float distance2 = dx * dx + dz * dz;
+            if (distance2 > radius2)
+                continue;
+
+            const float t = std::clamp((stroke.radius - std::sqrt(distance2)) / ramp, 0.0f, 1.0f);
+            const float weight = t * t * (3.0f - 2.0f * t);
+
+            switch (stroke.mode)
+            {
+            case BrushMode::Raise:
+                row[x] += stroke.strength * weight;
+                break;
+            case BrushMode::Lower:
+                // Jamais sous mMinHeight ; une cellule déjà plus basse n'est pas remontée
+                row[x] = std::max(row[x] - stroke.strength * weight, std::min(row[x], mMinHeight));
+                break;
+            case BrushMode::Smooth:
+            {
+                float sum = 0.0f;
+                int count = 0;
+                for (int nz = std::max(z - 1, source.zMin); nz <= std::min(z + 1, source.zMax); ++nz)
+                    for (int nx = std::max(x - 1, source.xMin); nx <= std::min(x + 1, source.xMax); ++nx)
+                    {
+                        sum += before[static_cast<std::size_t>(nz - source.zMin) * sourceWidth + (nx - source.xMin)];
+                        ++count;
+                    }
+                row[x] += (sum / count - row[x]) * std::clamp(stroke.strength, 0.0f, 1.0f) * weight;
+                break;
+            }
+            case BrushMode::Flatten:
+                row[x] += (stroke.targetHeight - row[x]) * std::clamp(stroke.strength, 0.0f, 1.0f) * weight;
+                break;
+            }
+        }
+    }
+
+    if (mHeightPyramid.matches(mWidth, mHeight))
+        mHeightPyramid.update(mData.data(), rect.xMin, rect.xMax, rect.zMin, rect.zMax);
+
+    return rect;
+}
+
+std::vector<int> Terrain::patchesInRect(const CellRect &rect) const
+{
+    // Même découpage que createPatches ; le patch p lit les cellules [32p, 32p + 32]
+    const int nbPatchX = mWidth / PATCH_SIZE;
+    const int nbPatchZ = mHeight / PATCH_SIZE;
+
+    std::vector<int> patches;
+    if (rect.empty() || nbPatchX == 0 || nbPatchZ == 0)
+        return patches;
+
+    const int pxMin = std::max(0, (rect.xMin - 1) / PATCH_SIZE);
+    const int pxMax = std::min(nbPatchX - 1, rect.xMax / PATCH_SIZE);
+    const int pzMin = std::max(0, (rect.zMin - 1) / PATCH_SIZE);
+    const int pzMax = std::min(nbPatchZ - 1, rect.zMax / PATCH_SIZE);
+
+    for (int px = pxMin; px <= pxMax; ++px)
+        for (int pz = pzMin; pz <= pzMax; ++pz)
+            patches.push_back(px * nbPatchZ + pz);
+
+    return patches;
+}
+
+bool Terrain::raycast(const glm::vec3 &origin, const glm::vec3 &direction, glm::vec3 &hit) const
+{
+    // createPatches() construit la pyramide, applyBrush() et
+    // updateHeightPyramid() la tiennent à jour : elle ne manque que si la
+    // génération a échoué avant, et le terrain n'a alors rien à toucher
+    if (mWidth < 2 || mHeight < 2 || !mHeightPyramid.matches(mWidth, mHeight))
+        return false;
+
+    // Repère des cellules : x et z multipliés par mXzFactor, y inchangé
+    const float o[3] = {origin.x * mXzFactor, origin.y, origin.z * mXzFactor};
+    const float d[3] = {direction.x * mXzFactor, direction.y, direction.z * mXzFactor};
+
+    float tHit = 0.0f;
+    if (!mHeightPyramid.raycast(mData.data(), o, d, tHit))
+        return false;
+
+    hit = origin + direction * tHit;
+    return true;
+}
+
 void Terrain::loadVerticesLod()
 {
-    for (int i = 0; i < mPatches.size(); ++i)
+    PROFILE_SCOPE("loadVerticesLod");
+
+    const int count = static_cast<int>(mPatches.size());
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; ++i)
     {
         mPatches[i]->generateLodVertices(mData, mWidth, mHeight);
     }
@@ -84,17 +293,25 @@ void Terrain::loadVerticesLod()
 
 void Terrain::loadIndicesLod()
 {
-    for (int i = 0; i < mPatches.size(); ++i)
+    PROFILE_SCOPE("loadIndicesLod");
+
+    const int count = static_cast<int>(mPatches.size());
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; ++i)
     {
-        mPatches[i]->generateLodIndices(mData, mWidth, mHeight);
+        mPatches[i]->generateLodIndices();
     }
 }
 
 void Terrain::setupTerrainLod(GLuint &VAO, GLuint &VBO, GLuint &EBO)
 {
+    PROFILE_SCOPE("setupTerrainLod");
+
     this->loadIndicesLod();
     this->loadVerticesLod();
 
+    // Les appels OpenGL restent sur le thread du contexte
     for (int i = 0; i < mPatches.size(); ++i)
     {
         mPatches[i]->createBuffersGL();
@@ -153,16 +370,24 @@ void Terrain::updateVerticesGpuLod(const std::vector<int>& dirtyPatchIndices)
 
     const int count = static_cast<int>(sortedDirty.size());
 
-    #pragma omp parallel for schedule(static)
-    for (int k = 0; k < count; ++k)
     {
-        int idx = sortedDirty[k];
-        if (idx >= 0 && idx < static_cast<int>(mPatches.size()))
+        PROFILE_SCOPE("generateLodVertices");
+
+        #pragma omp parallel for schedule(static)
+        for (int k = 0; k < count; ++k)
         {
-            mPatches[idx]->generateLodVertices(mData, mWidth, mHeight);
+            int idx = sortedDirty[k];
+            if (idx >= 0 && idx < static_cast<int>(mPatches.size()))
+            {
+                mPatches[idx]->generateLodVertices(mData, mWidth, mHeight);
+            }
         }
     }
 
+    updateHeightPyramid(sortedDirty);
+
+    PROFILE_SCOPE("uploadLodToGpu");
+
     for (int k = 0; k < count; ++k)
     {
         int idx = sortedDirty[k];
@@ -176,12 +401,20 @@ void Terrain::updateVerticesGpuLod()
 {
     const int count = static_cast<int>(mPatches.size());
 
-    #pragma omp parallel for schedule(static)
-    for (int i = 0; i < count; ++i)
     {
-        mPatches[i]->generateLodVertices(mData, mWidth, mHeight);
+        PROFILE_SCOPE("generateLodVertices");
+
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < count; ++i)
+        {
+            mPatches[i]->generateLodVertices(mData, mWidth, mHeight);
+        }
     }
 
+    rebuildHeightPyramid();
+
+    PROFILE_SCOPE("uploadLodToGpu");
+
     for (int i = 0; i < count; ++i)
     {
         mPatches[i]->uploadLodToGpu();
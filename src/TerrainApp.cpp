@@ -1,5 +1,11 @@
 #include "TerrainApp.hpp"
 #include "RendererManager.hpp"
+#include "Profiler.hpp"
+#include "TiledHeightField.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 void TerrainApp::setCameraSpeed(float value){
     mCameraSpeed = value;
@@ -14,7 +20,7 @@ TerrainApp::TerrainApp(unsigned int seed)
       hydraulicEnabled(false), hydraulicStarted(false),
       mShowMenu(true)
 {
-    std::srand(seed);
+    mGui.seed = static_cast<int>(seed);
 }
 
 TerrainApp::~TerrainApp()
@@ -24,6 +30,7 @@ TerrainApp::~TerrainApp()
     if (mIBO) glDeleteBuffers(1, &mIBO);
 
     mShader.reset();
+    mGpuTimer.release();
 
     if (mWindow)
         glfwDestroyWindow(mWindow);
@@ -148,14 +155,26 @@ void TerrainApp::Run()
         }
         else {
             UpdateTerrainGeneration();
+
+            StreamingTerrain *streaming = dynamic_cast<StreamingTerrain *>(mTerrain.get());
+            mGui.streamingActive = (streaming != nullptr);
+            if (streaming) {
+                streaming->update(mCamera.GetPosition());
+                mGui.streamResidentTiles = streaming->getResidentTiles();
+                mGui.streamPendingTiles = streaming->getPendingTiles();
+            }
+
+            mGpuTimer.begin("terrain");
             RenderScene();
+            mGpuTimer.end();
 
             mThermalErosion.setTalusAngle(mGui.talusAngle);
             mThermalErosion.setTransferRate(mGui.thermalK);
 
             thermalEnabled = mGui.thermalRunning;
 
-            if (thermalEnabled && mTerrain)
+            // Les tuiles du mode streaming sont érodées à leur génération
+            if (thermalEnabled && mTerrain && !streaming)
             {
                 int nbChanges = mThermalErosion.stepChunk(8000);
                 mGui.thermalCellsModified += nbChanges;
@@ -184,18 +203,32 @@ void TerrainApp::Run()
                 }
             }
 
+            if (mTerrain && !streaming) {
+                ApplyBrushFromMouse();
+            }
+
             mGui.cameraPos = glm::vec3(glm::inverse(mView)[3]);
             if (mShowMenu) {
+                mGpuTimer.begin("gui");
                 mGui.Render(mTerrain ? mTerrain.get() : nullptr);
+                mGpuTimer.end();
             }
         }
 
-        glfwSwapBuffers(mWindow);
+        {
+            PROFILE_SCOPE("swapBuffers");
+            glfwSwapBuffers(mWindow);
+        }
         glfwPollEvents();
+
+        mGpuTimer.collect();
+        Profiler::endFrame();
     }
 }
 void TerrainApp::RenderScene()
 {
+    PROFILE_SCOPE("renderScene");
+
     if (!mShader || !mTerrain || !mTerrain->getRendererManager() || !mTerrain->getTexture())
         return;
 
@@ -220,6 +253,78 @@ void TerrainApp::RenderScene()
     mTerrain->getRendererManager()->renderLod(mCamera.GetPosition(), mProjection, mView);
 }
 
+void TerrainApp::ApplyBrushFromMouse()
+{
+    const bool pressed = mGui.brushEnabled && mShowMenu
+                         && glfwGetMouseButton(mWindow, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS
+                         && !ImGui::GetIO().WantCaptureMouse;
+    if (!pressed) {
+        mBrushActive = false;
+        return;
+    }
+
+    const uint64_t startNs = Profiler::now();
+
+    // Rayon du curseur : points des plans proche et lointain en coordonnées monde
+    double cursorX = 0.0, cursorY = 0.0;
+    int windowWidth = 1, windowHeight = 1;
+    glfwGetCursorPos(mWindow, &cursorX, &cursorY);
+    glfwGetWindowSize(mWindow, &windowWidth, &windowHeight);
+
+    const float ndcX = 2.0f * static_cast<float>(cursorX) / std::max(windowWidth, 1) - 1.0f;
+    const float ndcY = 1.0f - 2.0f * static_cast<float>(cursorY) / std::max(windowHeight, 1);
+
+    const glm::mat4 inverseViewProjection = glm::inverse(mProjection * mView * mModel);
+    glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+    glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+    nearPoint = nearPoint / nearPoint.w;
+    farPoint = farPoint / farPoint.w;
+
+    const glm::vec3 origin(nearPoint);
+    const glm::vec3 direction = glm::vec3(farPoint) - origin;
+
+    glm::vec3 hit;
+    if (!mTerrain->raycast(origin, direction, hit)) {
+        mBrushActive = false;
+        return;
+    }
+
+    if (!mBrushActive) {
+        mBrushTarget = hit.y;
+        mBrushActive = true;
+    }
+
+    BrushStroke stroke;
+    stroke.mode = static_cast<BrushMode>(mGui.brushMode);
+    stroke.centerX = hit.x * mTerrain->getXzFactor();
+    stroke.centerZ = hit.z * mTerrain->getXzFactor();
+    stroke.radius = mGui.brushRadius;
+    stroke.strength = mGui.brushStrength;
+    stroke.falloff = mGui.brushFalloff;
+    stroke.targetHeight = mBrushTarget;
+
+    // L'itération d'érosion en cours est recopiée avant que le pinceau n'écrive
+    mThermalErosion.commitWorkingData();
+
+    const CellRect brushed = mTerrain->applyBrush(stroke);
+    if (brushed.empty())
+        return;
+
+    const CellRect relaxed = brushed.expanded(mGui.brushRelaxHalo, mTerrain->getTerrainWidth(),
+                                              mTerrain->getTerrainHeight());
+
+    mThermalErosion.relaxRegion(relaxed.zMin, relaxed.zMax, relaxed.xMin, relaxed.xMax,
+                                mGui.brushRelaxSteps);
+
+    // La détente dépose jusqu'à une cellule hors de la zone détendue
+    const std::vector<int> patches = mTerrain->patchesInRect(
+        relaxed.expanded(1, mTerrain->getTerrainWidth(), mTerrain->getTerrainHeight()));
+    mTerrain->updateVerticesGpuLod(patches);
+
+    mGui.brushLastPatches = static_cast<int>(patches.size());
+    mGui.brushLastMs = static_cast<float>((Profiler::now() - startNs) * 1e-6);
+}
+
 void TerrainApp::KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
     TerrainApp* app = (TerrainApp*)glfwGetWindowUserPointer(window);
@@ -245,6 +350,10 @@ void TerrainApp::KeyCallback(GLFWwindow* window, int key, int scancode, int acti
         switch (key)
         {
             case GLFW_KEY_ESCAPE: glfwSetWindowShouldClose(window, GLFW_TRUE); break;
+            case GLFW_KEY_F3:
+                if (action == GLFW_PRESS)
+                    app->mGui.showProfiler = !app->mGui.showProfiler;
+                break;
             case GLFW_KEY_W: app->mCamera.Move(app->mCamera.GetForward(), app->mCameraSpeed); break;
             case GLFW_KEY_S: app->mCamera.Move(-app->mCamera.GetForward(), app->mCameraSpeed); break;
             case GLFW_KEY_D: app->mCamera.Move(app->mCamera.GetRight(), app->mCameraSpeed); break;
@@ -342,7 +451,32 @@ std::unique_ptr<Terrain> TerrainApp::BuildTerrainFromGuiSelection() {
 
     std::cout << "Generation via GUI... Methode: " << nomMethode << std::endl;
 
-    if (mGui.selectedMethod == GEN_HEIGHTMAP) 
+    if (mGui.selectedMethod == GEN_HEIGHTMAP && mGui.tiledStreaming)
+    {
+        // Le fichier et son cache vivent aussi longtemps que la source du streaming
+        struct TiledSource
+        {
+            TiledHeightField field;
+            std::unique_ptr<TileCache> cache;
+        };
+
+        auto tiled = std::make_shared<TiledSource>();
+        if (!tiled->field.open(mGui.tiledFile, false))
+            return nullptr;
+
+        // Chaque worker n'épingle qu'une tuile à la fois
+        const int cacheTiles = std::max(64, static_cast<int>(std::thread::hardware_concurrency()));
+        tiled->cache = std::make_unique<TileCache>(tiled->field, cacheTiles);
+
+        const float minHeight = tiled->field.getMinHeight();
+        auto source = [tiled, minHeight](int x0, int z0, int width, int height, float *out) {
+            if (!tiled->cache->readRegion(x0, z0, width, height, out))
+                std::fill(out, out + width * height, minHeight);
+        };
+
+        return BuildStreamingTerrain(source, minHeight, tiled->field.getMaxHeight());
+    }
+    else if (mGui.selectedMethod == GEN_HEIGHTMAP) 
     {
         auto terrain = std::make_unique<Terrain>();
 
@@ -371,7 +505,11 @@ std::unique_ptr<Terrain> TerrainApp::BuildTerrainFromGuiSelection() {
         if (mGui.selectedMethod == GEN_FAULT_FORMATION) 
         {
             auto generator = std::make_unique<FaultFormationTerrain>();
+            generator->SetFaultMode(mGui.faultRowEvents
+                                    ? FaultFormationTerrain::FaultMode::RowEvents
+                                    : FaultFormationTerrain::FaultMode::FullSweep);
 
+            generator->setSeed(static_cast<uint32_t>(mGui.seed));
             generator->CreateFaultFormation(
                 mGui.faultWidth,
                 mGui.faultHeight,
@@ -387,10 +525,53 @@ std::unique_ptr<Terrain> TerrainApp::BuildTerrainFromGuiSelection() {
             generator->setRenderer(std::move(renderer));
             return generator;
         }
+        else if (mGui.selectedMethod == GEN_MIDPOINT_DISPLACEMENT && mGui.midpointStreaming)
+        {
+            const uint32_t seed = static_cast<uint32_t>(mGui.seed);
+            const int size = mGui.midpointSize;
+            const float roughness = mGui.midpointRoughness;
+            const float minHeight = mGui.midpointMinHeight;
+            const float maxHeight = mGui.midpointMaxHeight;
+
+            // Refusée ici plutôt qu'à chaque tuile par les workers
+            std::vector<float> probe;
+            if (!MidpointDisplacement::GenerateRegion(seed, size, roughness, 0, 0, 1, 1, probe))
+                return nullptr;
+
+            // Borne théorique, comme CreateMidpointDisplacementRegion : les tuiles se raccordent
+            const float bound = MidpointDisplacement::MaxDisplacement(size, roughness);
+
+            auto source = [=](int x0, int z0, int width, int height, float *out) {
+                // Terrain borné : hors de la grille, la cellule de bord la plus proche
+                const int cx0 = std::clamp(x0, 0, size - 1);
+                const int cz0 = std::clamp(z0, 0, size - 1);
+                const int cx1 = std::clamp(x0 + width - 1, 0, size - 1);
+                const int cz1 = std::clamp(z0 + height - 1, 0, size - 1);
+                const int regionWidth = cx1 - cx0 + 1;
+
+                std::vector<float> region;
+                MidpointDisplacement::GenerateRegion(seed, size, roughness, cx0, cz0,
+                                                     regionWidth, cz1 - cz0 + 1, region);
+
+                const float scale = (maxHeight - minHeight) / (2.0f * bound);
+                for (int z = 0; z < height; ++z)
+                {
+                    const int rz = std::clamp(z0 + z, cz0, cz1) - cz0;
+                    for (int x = 0; x < width; ++x)
+                    {
+                        const int rx = std::clamp(x0 + x, cx0, cx1) - cx0;
+                        out[z * width + x] = (region[rz * regionWidth + rx] + bound) * scale + minHeight;
+                    }
+                }
+            };
+
+            return BuildStreamingTerrain(source, minHeight, maxHeight);
+        }
         else if (mGui.selectedMethod == GEN_MIDPOINT_DISPLACEMENT) 
         {
             auto generator = std::make_unique<MidpointDisplacement>();
 
+            generator->setSeed(static_cast<uint32_t>(mGui.seed));
             generator->CreateMidpointDisplacement(
                 mGui.midpointSize,
                 mGui.midpointMinHeight,
@@ -403,10 +584,46 @@ std::unique_ptr<Terrain> TerrainApp::BuildTerrainFromGuiSelection() {
             generator->setRenderer(std::move(renderer));
             return generator;
         }
+        else if (mGui.selectedMethod == GEN_PERLIN_NOISE && mGui.perlinStreaming)
+        {
+            PerlinNoiseTerrain::NoiseParams params;
+            params.seed = static_cast<uint32_t>(mGui.seed);
+            params.frequency = mGui.perlinFrequency;
+            params.octaves = mGui.perlinOctaves;
+            params.persistence = mGui.perlinPersistence;
+            params.lacunarity = mGui.perlinLacunarity;
+            params.type = static_cast<PerlinNoiseTerrain::NoiseType>(mGui.perlinType);
+            params.offset = mGui.perlinOffset;
+            params.gain = mGui.perlinGain;
+            params.warp = mGui.perlinWarp;
+            params.warpStrength = mGui.perlinWarpStrength;
+
+            const float minHeight = mGui.perlinMinHeight;
+            const float maxHeight = mGui.perlinMaxHeight;
+            float low, high;
+            PerlinNoiseTerrain::OutputRange(params, low, high);
+
+            auto source = [=](int x0, int z0, int width, int height, float *out) {
+                PerlinNoiseTerrain::GenerateRegion(params, x0, z0, width, height, out);
+
+                const float scale = (maxHeight - minHeight) / (high - low);
+                for (int i = 0; i < width * height; ++i)
+                    out[i] = (out[i] - low) * scale + minHeight;
+            };
+
+            return BuildStreamingTerrain(source, minHeight, maxHeight);
+        }
         else if (mGui.selectedMethod == GEN_PERLIN_NOISE)
         {
             auto generator = std::make_unique<PerlinNoiseTerrain>();
-
+            generator->SetNoiseKernel(mGui.perlinVectorized
+                                      ? PerlinNoiseTerrain::NoiseKernel::Vectorized
+                                      : PerlinNoiseTerrain::NoiseKernel::Scalar);
+            generator->SetNoiseType(static_cast<PerlinNoiseTerrain::NoiseType>(mGui.perlinType),
+                                    mGui.perlinOffset, mGui.perlinGain);
+            generator->SetDomainWarp(mGui.perlinWarp, mGui.perlinWarpStrength);
+
+            generator->setSeed(static_cast<uint32_t>(mGui.seed));
             generator->CreatePerlinNoise(
                 mGui.perlinWidth,
                 mGui.perlinHeight,
@@ -428,6 +645,22 @@ std::unique_ptr<Terrain> TerrainApp::BuildTerrainFromGuiSelection() {
     return nullptr;
 }
 
+std::unique_ptr<Terrain> TerrainApp::BuildStreamingTerrain(StreamingTerrain::TileGenerator source,
+                                                           float minHeight, float maxHeight)
+{
+    StreamingConfig config;
+    config.viewRadius = mGui.streamRadius;
+    config.erosionSteps = mGui.streamErosionSteps;
+    config.talusAngle = mGui.talusAngle;
+    config.transferRate = mGui.thermalK;
+
+    auto terrain = std::make_unique<StreamingTerrain>(std::move(source), minHeight, maxHeight, config);
+
+    auto renderer = std::make_unique<RendererManager>(terrain.get());
+    terrain->setRenderer(std::move(renderer));
+    return terrain;
+}
+
 void TerrainApp::FinalizeTerrainAfterBuild()
 {
     mShader = std::make_unique<Shader>("../shaders/terrain.vs", "../shaders/terrain.fs");
@@ -0,0 +1,525 @@
+#include "TerrainSnapshot.hpp"
+#include "LzCompressor.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+constexpr char kSnapshotMagic[8] = {'E', 'R', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr uint32_t kCompressionNone = 0;
+constexpr uint32_t kCompressionLz = 1;
+constexpr uint64_t kRawBlockFlag = 1ull << 63;
+constexpr uint64_t kHeaderAlignment = 4096;
+
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t encoding;
+    uint32_t compression;
+    int32_t width;
+    int32_t height;
+    uint32_t reserved;
+    uint64_t blockCells;
+    uint64_t blockCount;
+    uint64_t dataOffset;
+    SnapshotMetadata metadata;
+};
+
+struct BlockEntry
+{
+    uint64_t offset; /**< Décalage relatif à dataOffset */
+    uint64_t size;   /**< Taille stockée, kRawBlockFlag si non compressé */
+};
+
+std::size_t bytesPerCell(SnapshotEncoding encoding)
+{
+    return encoding == SnapshotEncoding::Half ? sizeof(uint16_t) : sizeof(float);
+}
+
+void encodeCells(const float *src, std::size_t count, SnapshotEncoding encoding, uint8_t *dst)
+{
+    if (encoding == SnapshotEncoding::Float32)
+    {
+        std::memcpy(dst, src, count * sizeof(float));
+        return;
+    }
+
+    uint16_t *half = reinterpret_cast<uint16_t *>(dst);
+    for (std::size_t i = 0; i < count; ++i)
+        half[i] = TerrainSnapshot::floatToHalf(src[i]);
+}
+
+void decodeCells(const uint8_t *src, std::size_t count, SnapshotEncoding encoding, float *dst)
+{
+    if (encoding == SnapshotEncoding::Float32)
+    {
+        std::memcpy(dst, src, count * sizeof(float));
+        return;
+    }
+
+    const uint16_t *half = reinterpret_cast<const uint16_t *>(src);
+    for (std::size_t i = 0; i < count; ++i)
+        dst[i] = TerrainSnapshot::halfToFloat(half[i]);
+}
+} // namespace
+
+uint16_t TerrainSnapshot::floatToHalf(float value)
+{
+    uint32_t x;
+    std::memcpy(&x, &value, sizeof(x));
+
+    const uint32_t sign = (x >> 16) & 0x8000u;
+    uint32_t mantissa = x & 0x7FFFFFu;
+    const int exponent = static_cast<int>((x >> 23) & 0xFFu);
+
+    if (exponent == 255)
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+
+    const int halfExponent = exponent - 127 + 15;
+
+    if (halfExponent >= 31)
+        return static_cast<uint16_t>(sign | 0x7C00u);
+
+    if (halfExponent <= 0)
+    {
+        if (halfExponent < -10)
+            return static_cast<uint16_t>(sign);
+
+        mantissa |= 0x800000u;
+        const int shift = 14 - halfExponent;
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        const uint32_t halfway = 1u << (shift - 1);
+
+        if (remainder > halfway || (remainder == halfway && (half & 1u)))
+            ++half;
+
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    const uint32_t remainder = mantissa & 0x1FFFu;
+
+    // Arrondi au plus proche pair ; une retenue passe naturellement dans l'exposant
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+        ++half;
+
+    return static_cast<uint16_t>(sign | half);
+}
+
+float TerrainSnapshot::halfToFloat(uint16_t value)
+{
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1Fu;
+    uint32_t mantissa = value & 0x3FFu;
+    uint32_t bits;
+
+    if (exponent == 0)
+    {
+        if (mantissa == 0)
+        {
+            bits = sign;
+        }
+        else
+        {
+            int e = 1;
+            while (!(mantissa & 0x400u))
+            {
+                mantissa <<= 1;
+                --e;
+            }
+            mantissa &= 0x3FFu;
+            bits = sign | (static_cast<uint32_t>(e + 127 - 15) << 23) | (mantissa << 13);
+        }
+    }
+    else if (exponent == 31)
+    {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    }
+    else
+    {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+bool TerrainSnapshot::save(const std::string &path, const float *data, int width, int height,
+                           const SnapshotMetadata &metadata, const SnapshotOptions &options)
+{
+    if (!data || width <= 0 || height <= 0)
+    {
+        std::cerr << "Error: invalid terrain given to TerrainSnapshot::save.\n";
+        return false;
+    }
+
+    const uint64_t cellCount = static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+    const uint64_t blockCount = (cellCount + BLOCK_CELLS - 1) / BLOCK_CELLS;
+    const std::size_t cellBytes = bytesPerCell(options.encoding);
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = VERSION;
+    header.encoding = static_cast<uint32_t>(options.encoding);
+    header.compression = options.compress ? kCompressionLz : kCompressionNone;
+    header.width = width;
+    header.height = height;
+    header.blockCells = BLOCK_CELLS;
+    header.blockCount = blockCount;
+    header.metadata = metadata;
+
+    const uint64_t tableBytes = blockCount * sizeof(BlockEntry);
+    header.dataOffset = (sizeof(SnapshotHeader) + tableBytes + kHeaderAlignment - 1)
+                      / kHeaderAlignment * kHeaderAlignment;
+
+    std::vector<BlockEntry> table(blockCount);
+    std::vector<std::vector<uint8_t>> compressedBlocks;
+    const long long nbBlocks = static_cast<long long>(blockCount);
+
+#ifdef _OPENMP
+    const int threads = options.threads > 0 ? options.threads : omp_get_max_threads();
+#else
+    const int threads = 1;
+#endif
+
+    if (options.compress)
+    {
+        compressedBlocks.resize(blockCount);
+
+        #pragma omp parallel num_threads(threads)
+        {
+            std::vector<uint8_t> raw(BLOCK_CELLS * cellBytes);
+            std::vector<uint8_t> shuffled(BLOCK_CELLS * cellBytes);
+
+            #pragma omp for schedule(dynamic)
+            for (long long b = 0; b < nbBlocks; ++b)
+            {
+                const uint64_t first = static_cast<uint64_t>(b) * BLOCK_CELLS;
+                const std::size_t count = static_cast<std::size_t>(std::min(BLOCK_CELLS, cellCount - first));
+                const std::size_t rawBytes = count * cellBytes;
+
+                encodeCells(data + first, count, options.encoding, raw.data());
+                LzCompressor::shuffle(raw.data(), count, cellBytes, shuffled.data());
+
+                std::vector<uint8_t> &out = compressedBlocks[b];
+                out.resize(LzCompressor::maxCompressedSize(rawBytes));
+                const std::size_t compressedSize = LzCompressor::compress(shuffled.data(), rawBytes, out.data());
+
+                if (compressedSize < rawBytes)
+                {
+                    out.resize(compressedSize);
+                    table[b].size = compressedSize;
+                }
+                else
+                {
+                    out.assign(raw.begin(), raw.begin() + rawBytes);
+                    table[b].size = rawBytes | kRawBlockFlag;
+                }
+            }
+        }
+
+        uint64_t offset = 0;
+        for (uint64_t b = 0; b < blockCount; ++b)
+        {
+            table[b].offset = offset;
+            offset += compressedBlocks[b].size();
+        }
+    }
+    else
+    {
+        for (uint64_t b = 0; b < blockCount; ++b)
+        {
+            const uint64_t first = b * BLOCK_CELLS;
+            table[b].offset = first * cellBytes;
+            table[b].size = (std::min(BLOCK_CELLS, cellCount - first) * cellBytes) | kRawBlockFlag;
+        }
+    }
+
+    const BlockEntry &last = table.back();
+    const uint64_t fileSize = header.dataOffset + last.offset + (last.size & ~kRawBlockFlag);
+
+    // Écriture dans un fichier temporaire renommé à la fin : un snapshot
+    // existant n'est jamais laissé à moitié écrit.
+    const std::string tmpPath = path + ".tmp";
+    const int fd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "Error: cannot create snapshot " << tmpPath << "\n";
+        return false;
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(fileSize)) != 0)
+    {
+        std::cerr << "Error: cannot allocate snapshot " << tmpPath << "\n";
+        ::close(fd);
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+
+    void *mapping = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "Error: cannot map snapshot " << tmpPath << "\n";
+        ::close(fd);
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+
+    uint8_t *out = static_cast<uint8_t *>(mapping);
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + sizeof(header), table.data(), tableBytes);
+
+    uint8_t *blocks = out + header.dataOffset;
+
+    #pragma omp parallel for schedule(dynamic) num_threads(threads)
+    for (long long b = 0; b < nbBlocks; ++b)
+    {
+        if (options.compress)
+        {
+            std::memcpy(blocks + table[b].offset, compressedBlocks[b].data(), compressedBlocks[b].size());
+        }
+        else
+        {
+            const uint64_t first = static_cast<uint64_t>(b) * BLOCK_CELLS;
+            const std::size_t count = static_cast<std::size_t>(std::min(BLOCK_CELLS, cellCount - first));
+            encodeCells(data + first, count, options.encoding, blocks + table[b].offset);
+        }
+    }
+
+    // Le contenu doit être sur disque avant le renommage : sinon une coupure
+    // pourrait laisser sous le nom final un fichier de la bonne taille mais
+    // rempli de zéros.
+    const bool synced = msync(mapping, fileSize, MS_SYNC) == 0;
+    munmap(mapping, fileSize);
+
+    if (!synced || fsync(fd) != 0)
+    {
+        std::cerr << "Error: cannot write snapshot " << tmpPath << "\n";
+        ::close(fd);
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+
+    ::close(fd);
+
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        std::cerr << "Error: cannot rename snapshot to " << path << "\n";
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool TerrainSnapshot::load(const std::string &path, std::vector<float> &data, int &width, int &height,
+                           SnapshotMetadata *metadata)
+{
+    SnapshotView view;
+    if (!view.open(path))
+        return false;
+
+    width = view.getWidth();
+    height = view.getHeight();
+    data.resize(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+
+    if (!view.decode(data.data()))
+    {
+        std::cerr << "Error: corrupted snapshot " << path << "\n";
+        return false;
+    }
+
+    if (metadata)
+        *metadata = view.getMetadata();
+
+    return true;
+}
+
+SnapshotView::~SnapshotView()
+{
+    close();
+}
+
+bool SnapshotView::open(const std::string &path)
+{
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "Error: cannot open snapshot " << path << "\n";
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(SnapshotHeader))
+    {
+        std::cerr << "Error: " << path << " is not a snapshot file.\n";
+        ::close(fd);
+        return false;
+    }
+
+    mMappingSize = static_cast<std::size_t>(st.st_size);
+    void *mapping = mmap(nullptr, mMappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "Error: cannot map snapshot " << path << "\n";
+        mMappingSize = 0;
+        return false;
+    }
+
+    mMapping = static_cast<const unsigned char *>(mapping);
+    madvise(const_cast<unsigned char *>(mMapping), mMappingSize, MADV_SEQUENTIAL);
+
+    SnapshotHeader header;
+    std::memcpy(&header, mMapping, sizeof(header));
+
+    const uint64_t tableEnd = sizeof(SnapshotHeader) + header.blockCount * sizeof(BlockEntry);
+
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0
+        || header.version != TerrainSnapshot::VERSION
+        || header.width <= 0 || header.height <= 0 || header.blockCells == 0
+        || tableEnd > mMappingSize || header.dataOffset > mMappingSize)
+    {
+        std::cerr << "Error: " << path << " is not a valid snapshot (version "
+                  << header.version << ").\n";
+        close();
+        return false;
+    }
+
+    // Un encodage inconnu serait décodé comme du Float32 par decodeCells()
+    if (header.encoding != static_cast<uint32_t>(SnapshotEncoding::Float32)
+        && header.encoding != static_cast<uint32_t>(SnapshotEncoding::Half))
+    {
+        std::cerr << "Error: " << path << " uses an unknown encoding (" << header.encoding << ").\n";
+        close();
+        return false;
+    }
+
+    if (header.compression != kCompressionNone && header.compression != kCompressionLz)
+    {
+        std::cerr << "Error: " << path << " uses an unknown compression (" << header.compression << ").\n";
+        close();
+        return false;
+    }
+
+    mWidth = header.width;
+    mHeight = header.height;
+    mMetadata = header.metadata;
+    mEncoding = header.encoding;
+    mCompression = header.compression;
+    mBlockCells = header.blockCells;
+    mBlockCount = header.blockCount;
+    mDataOffset = header.dataOffset;
+
+    return true;
+}
+
+void SnapshotView::close()
+{
+    if (mMapping)
+    {
+        munmap(const_cast<unsigned char *>(mMapping), mMappingSize);
+        mMapping = nullptr;
+    }
+    mMappingSize = 0;
+}
+
+const float *SnapshotView::data() const
+{
+    if (!mMapping || mCompression != kCompressionNone
+        || static_cast<SnapshotEncoding>(mEncoding) != SnapshotEncoding::Float32)
+        return nullptr;
+
+    return reinterpret_cast<const float *>(mMapping + mDataOffset);
+}
+
+bool SnapshotView::decode(float *out) const
+{
+    if (!mMapping)
+        return false;
+
+    const SnapshotEncoding encoding = static_cast<SnapshotEncoding>(mEncoding);
+    const std::size_t cellBytes = bytesPerCell(encoding);
+    const uint64_t cellCount = static_cast<uint64_t>(mWidth) * static_cast<uint64_t>(mHeight);
+    const BlockEntry *table = reinterpret_cast<const BlockEntry *>(mMapping + sizeof(SnapshotHeader));
+    const uint8_t *blocks = mMapping + mDataOffset;
+    const uint64_t available = mMappingSize - mDataOffset;
+    const long long nbBlocks = static_cast<long long>(mBlockCount);
+
+    bool valid = true;
+    uint64_t decoded = 0;
+
+    #pragma omp parallel
+    {
+        std::vector<uint8_t> shuffled;
+        std::vector<uint8_t> raw;
+
+        #pragma omp for schedule(dynamic) reduction(&&:valid) reduction(+:decoded)
+        for (long long b = 0; b < nbBlocks; ++b)
+        {
+            const uint64_t first = static_cast<uint64_t>(b) * mBlockCells;
+            if (first >= cellCount)
+            {
+                valid = false;
+                continue;
+            }
+
+            const std::size_t count = static_cast<std::size_t>(std::min(mBlockCells, cellCount - first));
+            const std::size_t rawBytes = count * cellBytes;
+            const uint64_t storedSize = table[b].size & ~kRawBlockFlag;
+
+            if (table[b].offset + storedSize > available)
+            {
+                valid = false;
+                continue;
+            }
+
+            const uint8_t *block = blocks + table[b].offset;
+
+            if (table[b].size & kRawBlockFlag)
+            {
+                if (storedSize != rawBytes)
+                {
+                    valid = false;
+                    continue;
+                }
+                decodeCells(block, count, encoding, out + first);
+                decoded += count;
+                continue;
+            }
+
+            shuffled.resize(rawBytes);
+            raw.resize(rawBytes);
+
+            if (!LzCompressor::decompress(block, storedSize, shuffled.data(), rawBytes))
+            {
+                valid = false;
+                continue;
+            }
+
+            LzCompressor::unshuffle(shuffled.data(), count, cellBytes, raw.data());
+            decodeCells(raw.data(), count, encoding, out + first);
+            decoded += count;
+        }
+    }
+
+    // Une table trop courte laisserait la fin de la grille non écrite
+    return valid && decoded == cellCount;
+}
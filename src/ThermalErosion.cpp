@@ -1,41 +1,55 @@
 #include "ThermalErosion.hpp"
+#include "NumaPlacement.hpp"
+#include "Profiler.hpp"
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
-const ThermalErosion::NeighborOffset ThermalErosion::kNeighbors8[8] = {
-    {-1,  0},
-    { 1,  0},
-    { 0, -1},
-    { 0,  1},
-    {-1, -1},
-    {-1,  1},
-    { 1, -1},
-    { 1,  1}
-};
-
-const ThermalErosion::NeighborOffset ThermalErosion::kNeighbors4[4] = {
-    {-1,  0},
-    { 1,  0},
-    { 0, -1},
-    { 0,  1}
-};
-
 ThermalErosion::ThermalErosion()
 {
     useEightNeighbors();
 }
 
+void ThermalErosion::prepareTwoPhaseBuffers()
+{
+    const std::size_t size = m_data->size();
+
+    // Alloués au premier pas (ou après un changement de grille) puis
+    // réutilisés : le placement NUMA n'est fait qu'une fois
+    if (mSnapshot.size() != size) {
+        mSnapshot.assign(size, 0.0f);
+        mNextData.assign(size, 0.0f);
+        NumaPlacement::place(mSnapshot);
+        NumaPlacement::place(mNextData);
+    }
+
+    NumaPlacement::copy(m_data->data(), mSnapshot.data(), size);
+    NumaPlacement::copy(m_data->data(), mNextData.data(), size);
+}
+
+void ThermalErosion::prepareThreadBuffers(int numThreads)
+{
+    const std::size_t size = m_data->size();
+
+    if (static_cast<int>(mThreadDeltas.size()) != numThreads
+        || mThreadDeltas.empty() || mThreadDeltas[0].size() != size)
+    {
+        mThreadDeltas.assign(numThreads, std::vector<float>(size, 0.0f));
+        for (std::vector<float>& delta : mThreadDeltas)
+            NumaPlacement::place(delta);
+    }
+}
+
 void ThermalErosion::useEightNeighbors()
 {
-    mActiveNeighbors = kNeighbors8;
     mNeighborCount = 8;
+    ThermalKernel::indexOffsets(m_width, mNeighborCount, mNeighborIndexOffsets);
 }
 
 void ThermalErosion::useFourNeighbors()
 {
-    mActiveNeighbors = kNeighbors4;
     mNeighborCount = 4;
+    ThermalKernel::indexOffsets(m_width, mNeighborCount, mNeighborIndexOffsets);
 }
 
 int ThermalErosion::toIndex(int i, int j) const
@@ -49,210 +63,44 @@ void ThermalErosion::localIndexToCoords(int localIndex, int& i, int& j) const
     j = 1 + localIndex % (m_width - 2);
 }
 
-int ThermalErosion::patchIndexFromCell(int i, int j) const
+void ThermalErosion::recordMove(float slopeExcess, float materialToMove, float deposited)
 {
-    const int patchX = j / PATCH_SIZE;
-    const int patchZ = i / PATCH_SIZE;
-    return patchX * mNbPatchZ + patchZ;
+    mCurrentResidual.maxSlopeExcess = std::max(mCurrentResidual.maxSlopeExcess, slopeExcess);
+    mCurrentResidual.movedMass += materialToMove;
+    mCurrentResidual.depositedMass += deposited;
 }
 
-void ThermalErosion::markPatchDirtyFromCell(int i, int j)
+void ThermalErosion::publishResidual(int changes)
 {
-    const int patchIndex = patchIndexFromCell(i, j);
-
-    if (!mPatchMarked[patchIndex]) {
-        mPatchMarked[patchIndex] = true;
-        mDirtyPatchIndices.push_back(patchIndex);
-    }
-}
-
-void ThermalErosion::addMaterialToNeighbor(float* dst,
-                                           int neighborIndex,
-                                           float moveAmount,
-                                           int neighborI,
-                                           int neighborJ)
-{
-    dst[neighborIndex] += moveAmount;
-    markPatchDirtyFromCell(neighborI, neighborJ);
+    mCurrentResidual.cellsModified = changes;
+    mLastResidual = mCurrentResidual;
+    mCurrentResidual = StepResidual();
+    mHasResidual = true;
 }
 
 bool ThermalErosion::erodeCell(int i, int j, const float* src, float* dst)
 {
-    const int center = toIndex(i, j);
-    const float currentHeight = src[center];
-
-    float totalDiff = 0.0f;
-    int validNeighbors = 0;
-
-    float diffs[8] = {0.0f};
-    int neighborIndices[8] = {0};
-    int neighborI[8] = {0};
-    int neighborJ[8] = {0};
-
-    for (int k = 0; k < mNeighborCount; ++k)
-    {
-        const int ni = i + mActiveNeighbors[k].di;
-        const int nj = j + mActiveNeighbors[k].dj;
-        const int nIndex = toIndex(ni, nj);
-
-        const float diff = currentHeight - src[nIndex];
-
-        diffs[k] = diff;
-        neighborIndices[k] = nIndex;
-        neighborI[k] = ni;
-        neighborJ[k] = nj;
-
-        if (diff > talusAngle) {
-            totalDiff += diff;
-            ++validNeighbors;
-        }
-    }
-
-    if (totalDiff <= 0.0f || validNeighbors <= 0) {
+    ThermalKernel::CellMove move;
+    if (!ThermalKernel::erodeCell(src, dst, toIndex(i, j), mNeighborIndexOffsets, mNeighborCount,
+                                  talusAngle, transferRate, move)) {
         return false;
     }
 
-    markPatchDirtyFromCell(i, j);
-
-    float materialToMove = transferRate * (totalDiff / validNeighbors);
-    materialToMove = std::min(materialToMove, currentHeight * transferRate);
-
-    dst[center] -= materialToMove;
-
-    const float invTotalDiff = 1.0f / totalDiff;
-
-    for (int k = 0; k < mNeighborCount; ++k)
-    {
-        if (diffs[k] > talusAngle) {
-            const float moveAmount = materialToMove * (diffs[k] * invTotalDiff);
-            addMaterialToNeighbor(dst,
-                                  neighborIndices[k],
-                                  moveAmount,
-                                  neighborI[k],
-                                  neighborJ[k]);
-        }
-    }
-
+    recordMove(move.maxDiff - talusAngle, move.moved, move.deposited);
     return true;
 }
+
 bool ThermalErosion::erodeCellInPlace(int i, int j, float* data)
 {
-    const int center = toIndex(i, j);
-    const float currentHeight = data[center];
-
-    float totalDiff = 0.0f;
-    int validNeighbors = 0;
-
-    float diffs[8] = {0.0f};
-    int neighborIndices[8] = {0};
-    int neighborI[8] = {0};
-    int neighborJ[8] = {0};
-
-    for (int k = 0; k < mNeighborCount; ++k)
-    {
-        const int ni = i + mActiveNeighbors[k].di;
-        const int nj = j + mActiveNeighbors[k].dj;
-        const int nIndex = toIndex(ni, nj);
-
-        const float diff = currentHeight - data[nIndex];
-
-        diffs[k] = diff;
-        neighborIndices[k] = nIndex;
-        neighborI[k] = ni;
-        neighborJ[k] = nj;
-
-        if (diff > talusAngle) {
-            totalDiff += diff;
-            ++validNeighbors;
-        }
-    }
-
-    if (totalDiff <= 0.0f || validNeighbors <= 0) {
-        return false;
-    }
-
-    float materialToMove = transferRate * (totalDiff / validNeighbors);
-    materialToMove = std::min(materialToMove, currentHeight * transferRate);
-
-    data[center] -= materialToMove;
-    markPatchDirtyFromCell(i, j);
-
-    const float invTotalDiff = 1.0f / totalDiff;
-
-    for (int k = 0; k < mNeighborCount; ++k)
-    {
-        if (diffs[k] > talusAngle) {
-            const float moveAmount = materialToMove * (diffs[k] * invTotalDiff);
-            data[neighborIndices[k]] += moveAmount;
-            markPatchDirtyFromCell(neighborI[k], neighborJ[k]);
-        }
-    }
-
-    return true;
+    return erodeCell(i, j, data, data);
 }
+
 bool ThermalErosion::erodeCellToDeltaSerial(int i,
                                             int j,
                                             const float* src,
                                             float* delta)
 {
-    const int center = toIndex(i, j);
-    const float currentHeight = src[center];
-
-    float totalDiff = 0.0f;
-    int validNeighbors = 0;
-
-    float diffs[8] = {0.0f};
-    int neighborIndices[8] = {0};
-    int neighborI[8] = {0};
-    int neighborJ[8] = {0};
-
-    for (int k = 0; k < mNeighborCount; ++k)
-    {
-        const int ni = i + mActiveNeighbors[k].di;
-        const int nj = j + mActiveNeighbors[k].dj;
-        const int nIndex = toIndex(ni, nj);
-
-        const float diff = currentHeight - src[nIndex];
-
-        diffs[k] = diff;
-        neighborIndices[k] = nIndex;
-        neighborI[k] = ni;
-        neighborJ[k] = nj;
-
-        if (diff > talusAngle) {
-            totalDiff += diff;
-            ++validNeighbors;
-        }
-    }
-
-    if (totalDiff <= 0.0f || validNeighbors <= 0) {
-        return false;
-    }
-
-    float materialToMove = transferRate * (totalDiff / validNeighbors);
-    materialToMove = std::min(materialToMove, currentHeight * transferRate);
-
-    delta[center] -= materialToMove;
-
-    const float invTotalDiff = 1.0f / totalDiff;
-
-    for (int k = 0; k < mNeighborCount; ++k)
-    {
-        if (diffs[k] > talusAngle) {
-            const float moveAmount = materialToMove * (diffs[k] * invTotalDiff);
-            delta[neighborIndices[k]] += moveAmount;
-        }
-    }
-
-    markPatchDirtyFromCell(i, j);
-    for (int k = 0; k < mNeighborCount; ++k)
-    {
-        if (diffs[k] > talusAngle) {
-            markPatchDirtyFromCell(neighborI[k], neighborJ[k]);
-        }
-    }
-
-    return true;
+    return erodeCell(i, j, src, delta);
 }
 
 int ThermalErosion::applyErosionRange(const float* src,
@@ -262,16 +110,29 @@ int ThermalErosion::applyErosionRange(const float* src,
 {
     int changes = 0;
 
+    // Patches marqués une fois par ligne de la plage
+    DirtyTileSet::CellBounds rowBounds;
+    int rowI = -1;
+
     for (int localIndex = startIndex; localIndex < endIndex; ++localIndex)
     {
         int i, j;
         localIndexToCoords(localIndex, i, j);
 
+        if (i != rowI) {
+            mDirtyTiles.markAround(rowBounds);
+            rowBounds = DirtyTileSet::CellBounds();
+            rowI = i;
+        }
+
         if (erodeCell(i, j, src, dst)) {
+            rowBounds.add(i, j);
             ++changes;
         }
     }
 
+    mDirtyTiles.markAround(rowBounds);
+
     return changes;
 }
 
@@ -287,13 +148,22 @@ int ThermalErosion::applyBlockedErosionRange(const float* src,
 
     int changes = 0;
 
-    for (int blockI = 0; blockI < innerHeight; blockI += BLOCK_SIZE)
+    if (startIndex >= endIndex) {
+        return 0;
+    }
+
+    // Seules les bandes de blocs qui recoupent [startIndex, endIndex) sont parcourues
+    const int firstBlockI = (startIndex / innerWidth) / BLOCK_SIZE * BLOCK_SIZE;
+    const int lastInnerI = std::min(innerHeight - 1, (endIndex - 1) / innerWidth);
+
+    for (int blockI = firstBlockI; blockI <= lastInnerI; blockI += BLOCK_SIZE)
     {
         const int blockHeight = std::min(BLOCK_SIZE, innerHeight - blockI);
 
         for (int blockJ = 0; blockJ < innerWidth; blockJ += BLOCK_SIZE)
         {
             const int blockWidth = std::min(BLOCK_SIZE, innerWidth - blockJ);
+            DirtyTileSet::CellBounds blockBounds;
 
             for (int di = 0; di < blockHeight; ++di)
             {
@@ -312,10 +182,13 @@ int ThermalErosion::applyBlockedErosionRange(const float* src,
                     const int j = innerJ + 1;
 
                     if (erodeCell(i, j, src, dst)) {
+                        blockBounds.add(i, j);
                         ++changes;
                     }
                 }
             }
+
+            mDirtyTiles.markAround(blockBounds);
         }
     }
 
@@ -330,14 +203,24 @@ int ThermalErosion::applyBlockedParallelErosionToDelta(const float* src,
     const int innerHeight = H - 2;
 
     int changes = 0;
+    float maxExcess = 0.0f;
+    double movedMass = 0.0;
+    double depositedMass = 0.0;
 
-    #pragma omp parallel for collapse(2) schedule(static) reduction(+:changes)
+    // Les blocs voisins déposent dans les mêmes cellules de bord
+    auto addAtomic = [delta](int index, float amount) {
+        #pragma omp atomic update
+        delta[index] += amount;
+    };
+
+    #pragma omp parallel for collapse(2) schedule(static) reduction(+:changes, movedMass, depositedMass) reduction(max:maxExcess)
     for (int blockI = 0; blockI < innerHeight; blockI += BLOCK_SIZE)
     {
         for (int blockJ = 0; blockJ < innerWidth; blockJ += BLOCK_SIZE)
         {
             const int blockHeight = std::min(BLOCK_SIZE, innerHeight - blockI);
             const int blockWidth  = std::min(BLOCK_SIZE, innerWidth - blockJ);
+            DirtyTileSet::CellBounds blockBounds;
 
             for (int di = 0; di < blockHeight; ++di)
             {
@@ -349,75 +232,29 @@ int ThermalErosion::applyBlockedParallelErosionToDelta(const float* src,
                     const int innerJ = blockJ + dj;
                     const int j = innerJ + 1;
 
-                    const int center = toIndex(i, j);
-                    const float currentHeight = src[center];
-
-                    float totalDiff = 0.0f;
-                    int validNeighbors = 0;
-
-                    float diffs[8] = {0.0f};
-                    int neighborIndices[8] = {0};
-                    int neighborI[8] = {0};
-                    int neighborJ[8] = {0};
-
-                    for (int k = 0; k < mNeighborCount; ++k)
-                    {
-                        const int ni = i + mActiveNeighbors[k].di;
-                        const int nj = j + mActiveNeighbors[k].dj;
-                        const int nIndex = toIndex(ni, nj);
-
-                        const float diff = currentHeight - src[nIndex];
-
-                        diffs[k] = diff;
-                        neighborIndices[k] = nIndex;
-                        neighborI[k] = ni;
-                        neighborJ[k] = nj;
-
-                        if (diff > talusAngle) {
-                            totalDiff += diff;
-                            ++validNeighbors;
-                        }
-                    }
-
-                    if (totalDiff <= 0.0f || validNeighbors <= 0) {
+                    ThermalKernel::CellMove move;
+                    if (!ThermalKernel::erodeCellTo(src, toIndex(i, j), mNeighborIndexOffsets, mNeighborCount,
+                                                    talusAngle, transferRate, addAtomic, move)) {
                         continue;
                     }
 
-                    float materialToMove = transferRate * (totalDiff / validNeighbors);
-                    materialToMove = std::min(materialToMove, currentHeight * transferRate);
-
-                    #pragma omp atomic update
-                    delta[center] -= materialToMove;
-
-                    const float invTotalDiff = 1.0f / totalDiff;
-
-                    for (int k = 0; k < mNeighborCount; ++k)
-                    {
-                        if (diffs[k] > talusAngle) {
-                            const float moveAmount = materialToMove * (diffs[k] * invTotalDiff);
-
-                            #pragma omp atomic update
-                            delta[neighborIndices[k]] += moveAmount;
-                        }
-                    }
-
-                    #pragma omp critical
-                    {
-                        markPatchDirtyFromCell(i, j);
-                        for (int k = 0; k < mNeighborCount; ++k)
-                        {
-                            if (diffs[k] > talusAngle) {
-                                markPatchDirtyFromCell(neighborI[k], neighborJ[k]);
-                            }
-                        }
-                    }
+                    maxExcess = std::max(maxExcess, move.maxDiff - talusAngle);
+                    movedMass += move.moved;
+                    depositedMass += move.deposited;
+                    blockBounds.add(i, j);
 
                     ++changes;
                 }
             }
+
+            mDirtyTiles.markAround(blockBounds);
         }
     }
 
+    mCurrentResidual.maxSlopeExcess = std::max(mCurrentResidual.maxSlopeExcess, maxExcess);
+    mCurrentResidual.movedMass += movedMass;
+    mCurrentResidual.depositedMass += depositedMass;
+
     return changes;
 }
 int ThermalErosion::applyCheckerboardErosionRange(const float* src,
@@ -428,6 +265,8 @@ int ThermalErosion::applyCheckerboardErosionRange(const float* src,
 
     for (int i = 1; i < m_height - 1; ++i)
     {
+        DirtyTileSet::CellBounds rowBounds;
+
         for (int j = 1; j < m_width - 1; ++j)
         {
             if (((i + j) & 1) != color) {
@@ -435,9 +274,12 @@ int ThermalErosion::applyCheckerboardErosionRange(const float* src,
             }
 
             if (erodeCell(i, j, src, dst)) {
+                rowBounds.add(i, j);
                 ++changes;
             }
         }
+
+        mDirtyTiles.markAround(rowBounds);
     }
 
     return changes;
@@ -460,6 +302,7 @@ int ThermalErosion::applyBlockedCheckerboardErosionRange(const float* src,
         for (int blockJ = 0; blockJ < innerWidth; blockJ += BLOCK_SIZE)
         {
             const int blockWidth = std::min(BLOCK_SIZE, innerWidth - blockJ);
+            DirtyTileSet::CellBounds blockBounds;
 
             for (int di = 0; di < blockHeight; ++di)
             {
@@ -476,10 +319,13 @@ int ThermalErosion::applyBlockedCheckerboardErosionRange(const float* src,
                     }
 
                     if (erodeCell(i, j, src, dst)) {
+                        blockBounds.add(i, j);
                         ++changes;
                     }
                 }
             }
+
+            mDirtyTiles.markAround(blockBounds);
         }
     }
 
@@ -501,21 +347,26 @@ int ThermalErosion::stepCheckerboardPureTwoPhase()
     }
 
     clearDirtyPatchIndices();
+    mCurrentResidual = StepResidual();
 
-    std::vector<float> srcSnapshot = *m_data;
-    std::vector<float> dst = srcSnapshot;
+    prepareTwoPhaseBuffers();
+    const std::vector<float>& srcSnapshot = mSnapshot;
+    std::vector<float>& dst = mNextData;
 
     int changes = 0;
     changes += applyCheckerboardErosionRange(srcSnapshot.data(), dst.data(), 0);
     changes += applyCheckerboardErosionRange(srcSnapshot.data(), dst.data(), 1);
 
-    *m_data = std::move(dst);
+    m_data->swap(dst);
 
     mIterationFinished = true;
     mNeedsVisualUpdate = false;
     mCellsProcessedSinceLastCommit = 0;
     mCurrentIndex = 0;
 
+    mDirtyTiles.collect(mDirtyPatchIndices);
+    publishResidual(changes);
+
     return changes;
 }
 int ThermalErosion::stepBlockedCheckerboardPureTwoPhase()
@@ -534,27 +385,31 @@ int ThermalErosion::stepBlockedCheckerboardPureTwoPhase()
     }
 
     clearDirtyPatchIndices();
+    mCurrentResidual = StepResidual();
 
-    std::vector<float> srcSnapshot = *m_data;
-    std::vector<float> dst = srcSnapshot;
+    prepareTwoPhaseBuffers();
+    const std::vector<float>& srcSnapshot = mSnapshot;
+    std::vector<float>& dst = mNextData;
 
     int changes = 0;
     changes += applyBlockedCheckerboardErosionRange(srcSnapshot.data(), dst.data(), 0);
     changes += applyBlockedCheckerboardErosionRange(srcSnapshot.data(), dst.data(), 1);
 
-    *m_data = std::move(dst);
+    m_data->swap(dst);
 
     mIterationFinished = true;
     mNeedsVisualUpdate = false;
     mCellsProcessedSinceLastCommit = 0;
     mCurrentIndex = 0;
 
+    mDirtyTiles.collect(mDirtyPatchIndices);
+    publishResidual(changes);
+
     return changes;
 }
 int ThermalErosion::applyBlockedParallelErosionToThreadLocalBuffers(
     const float* src,
-    std::vector<std::vector<float>>& threadDeltas,
-    std::vector<std::vector<unsigned char>>& threadPatchMarked)
+    std::vector<std::vector<float>>& threadDeltas)
 {
     const int W = m_width;
     const int H = m_height;
@@ -562,8 +417,11 @@ int ThermalErosion::applyBlockedParallelErosionToThreadLocalBuffers(
     const int innerHeight = H - 2;
 
     int changes = 0;
+    float maxExcess = 0.0f;
+    double movedMass = 0.0;
+    double depositedMass = 0.0;
 
-    #pragma omp parallel for collapse(2) schedule(static) reduction(+:changes)
+    #pragma omp parallel for collapse(2) schedule(static) reduction(+:changes, movedMass, depositedMass) reduction(max:maxExcess)
     for (int blockI = 0; blockI < innerHeight; blockI += BLOCK_SIZE)
     {
         for (int blockJ = 0; blockJ < innerWidth; blockJ += BLOCK_SIZE)
@@ -575,10 +433,10 @@ int ThermalErosion::applyBlockedParallelErosionToThreadLocalBuffers(
 #endif
 
             std::vector<float>& localDelta = threadDeltas[tid];
-            std::vector<unsigned char>& localPatchMask = threadPatchMarked[tid];
 
             const int blockHeight = std::min(BLOCK_SIZE, innerHeight - blockI);
             const int blockWidth  = std::min(BLOCK_SIZE, innerWidth - blockJ);
+            DirtyTileSet::CellBounds blockBounds;
 
             for (int di = 0; di < blockHeight; ++di)
             {
@@ -590,72 +448,29 @@ int ThermalErosion::applyBlockedParallelErosionToThreadLocalBuffers(
                     const int innerJ = blockJ + dj;
                     const int j = innerJ + 1;
 
-                    const int center = toIndex(i, j);
-                    const float currentHeight = src[center];
-
-                    float totalDiff = 0.0f;
-                    int validNeighbors = 0;
-
-                    float diffs[8] = {0.0f};
-                    int neighborIndices[8] = {0};
-                    int neighborI[8] = {0};
-                    int neighborJ[8] = {0};
-
-                    for (int k = 0; k < mNeighborCount; ++k)
-                    {
-                        const int ni = i + mActiveNeighbors[k].di;
-                        const int nj = j + mActiveNeighbors[k].dj;
-                        const int nIndex = toIndex(ni, nj);
-
-                        const float diff = currentHeight - src[nIndex];
-
-                        diffs[k] = diff;
-                        neighborIndices[k] = nIndex;
-                        neighborI[k] = ni;
-                        neighborJ[k] = nj;
-
-                        if (diff > talusAngle) {
-                            totalDiff += diff;
-                            ++validNeighbors;
-                        }
-                    }
-
-                    if (totalDiff <= 0.0f || validNeighbors <= 0) {
+                    ThermalKernel::CellMove move;
+                    if (!ThermalKernel::erodeCell(src, localDelta.data(), toIndex(i, j), mNeighborIndexOffsets,
+                                                  mNeighborCount, talusAngle, transferRate, move)) {
                         continue;
                     }
 
-                    float materialToMove = transferRate * (totalDiff / validNeighbors);
-                    materialToMove = std::min(materialToMove, currentHeight * transferRate);
-
-                    localDelta[center] -= materialToMove;
-
-                    const float invTotalDiff = 1.0f / totalDiff;
-
-                    for (int k = 0; k < mNeighborCount; ++k)
-                    {
-                        if (diffs[k] > talusAngle) {
-                            const float moveAmount = materialToMove * (diffs[k] * invTotalDiff);
-                            localDelta[neighborIndices[k]] += moveAmount;
-                        }
-                    }
-
-                    const int centerPatch = patchIndexFromCell(i, j);
-                    localPatchMask[centerPatch] = 1;
-
-                    for (int k = 0; k < mNeighborCount; ++k)
-                    {
-                        if (diffs[k] > talusAngle) {
-                            const int patchIdx = patchIndexFromCell(neighborI[k], neighborJ[k]);
-                            localPatchMask[patchIdx] = 1;
-                        }
-                    }
+                    maxExcess = std::max(maxExcess, move.maxDiff - talusAngle);
+                    movedMass += move.moved;
+                    depositedMass += move.deposited;
+                    blockBounds.add(i, j);
 
                     ++changes;
                 }
             }
+
+            mDirtyTiles.markAround(blockBounds);
         }
     }
 
+    mCurrentResidual.maxSlopeExcess = std::max(mCurrentResidual.maxSlopeExcess, maxExcess);
+    mCurrentResidual.movedMass += movedMass;
+    mCurrentResidual.depositedMass += depositedMass;
+
     return changes;
 }
 int ThermalErosion::applyCheckerboardInPlaceColor(float* data, int color)
@@ -664,6 +479,8 @@ int ThermalErosion::applyCheckerboardInPlaceColor(float* data, int color)
 
     for (int i = 1; i < m_height - 1; ++i)
     {
+        DirtyTileSet::CellBounds rowBounds;
+
         for (int j = 1; j < m_width - 1; ++j)
         {
             if (((i + j) & 1) != color) {
@@ -671,9 +488,12 @@ int ThermalErosion::applyCheckerboardInPlaceColor(float* data, int color)
             }
 
             if (erodeCellInPlace(i, j, data)) {
+                rowBounds.add(i, j);
                 ++changes;
             }
         }
+
+        mDirtyTiles.markAround(rowBounds);
     }
 
     return changes;
@@ -694,6 +514,7 @@ int ThermalErosion::stepCheckerboardInPlace()
     }
 
     clearDirtyPatchIndices();
+    mCurrentResidual = StepResidual();
 
     float* data = m_data->data();
 
@@ -706,28 +527,126 @@ int ThermalErosion::stepCheckerboardInPlace()
     mCellsProcessedSinceLastCommit = 0;
     mCurrentIndex = 0;
 
+    mDirtyTiles.collect(mDirtyPatchIndices);
+    publishResidual(changes);
+
     return changes;
 }
 void ThermalErosion::resetProgress()
 {
-    m_workingData.clear();
+    mWorkingActive = false;
+    mDirtyRowBegin = 0;
+    mDirtyRowEnd = 0;
     mCurrentIndex = 0;
     mIterationFinished = false;
     mCellsProcessedSinceLastCommit = 0;
     mNeedsVisualUpdate = false;
-    mDirtyPatchIndices.clear();
+    clearDirtyPatchIndices();
+    mCurrentResidual = StepResidual();
+}
+
+int ThermalErosion::relaxRegion(int rowMin, int rowMax, int colMin, int colMax, int maxSteps)
+{
+    PROFILE_SCOPE("relaxRegion");
+
+    if (!m_data || m_width < 3 || m_height < 3) {
+        return 0;
+    }
+
+    // Les cellules du bord ne sont jamais érodées
+    const int iMin = std::max(rowMin, 1);
+    const int iMax = std::min(rowMax, m_height - 2);
+    const int jMin = std::max(colMin, 1);
+    const int jMax = std::min(colMax, m_width - 2);
+
+    if (iMin > iMax || jMin > jMax) {
+        return 0;
+    }
+
+    // erodeCellInPlace alimente le résidu : celui du pas en cours est préservé
+    const StepResidual residual = mCurrentResidual;
+    float* data = m_data->data();
+    int changes = 0;
+
+    for (int s = 0; s < maxSteps; ++s)
+    {
+        int stepChanges = 0;
+
+        for (int color = 0; color < 2; ++color)
+        {
+            for (int i = iMin; i <= iMax; ++i)
+            {
+                for (int j = jMin + ((i + jMin + color) & 1); j <= jMax; j += 2)
+                {
+                    if (erodeCellInPlace(i, j, data)) {
+                        ++stepChanges;
+                    }
+                }
+            }
+        }
+
+        changes += stepChanges;
+        if (stepChanges == 0) {
+            break;
+        }
+    }
+
+    mCurrentResidual = residual;
+
+    // Lignes éditées ou détendues, voisins compris : remises dans l'itération découpée
+    if (mWorkingActive) {
+        const std::size_t begin = static_cast<std::size_t>(std::max(std::min(rowMin, iMin) - 1, 0)) * m_width;
+        const std::size_t end = static_cast<std::size_t>(std::min(std::max(rowMax, iMax) + 2, m_height)) * m_width;
+        std::copy(m_data->begin() + begin, m_data->begin() + end, m_workingData.begin() + begin);
+    }
+
+    return changes;
 }
 
 void ThermalErosion::commitWorkingData()
 {
-    if (!m_data || m_workingData.empty())
+    PROFILE_SCOPE("commitWorkingData");
+
+    if (!m_data || !mWorkingActive)
         return;
 
-    *m_data = m_workingData;
+    copyDirtyRows();
     mCellsProcessedSinceLastCommit = 0;
     mNeedsVisualUpdate = false;
 }
 
+void ThermalErosion::markRowsDirty(int startIndex, int endIndex)
+{
+    // erodeCell écrit aussi dans les voisins : une ligne de halo de chaque côté
+    const int innerWidth = m_width - 2;
+    const int firstRow = startIndex / innerWidth;
+    const int lastRow = (endIndex - 1) / innerWidth + 2;
+
+    if (mDirtyRowBegin >= mDirtyRowEnd) {
+        mDirtyRowBegin = firstRow;
+        mDirtyRowEnd = lastRow + 1;
+    } else {
+        mDirtyRowBegin = std::min(mDirtyRowBegin, firstRow);
+        mDirtyRowEnd = std::max(mDirtyRowEnd, lastRow + 1);
+    }
+
+    mDirtyRowEnd = std::min(mDirtyRowEnd, m_height);
+}
+
+void ThermalErosion::copyDirtyRows()
+{
+    if (mDirtyRowBegin >= mDirtyRowEnd)
+        return;
+
+    const std::size_t begin = static_cast<std::size_t>(mDirtyRowBegin) * m_width;
+    const std::size_t end = static_cast<std::size_t>(mDirtyRowEnd) * m_width;
+
+    std::copy(m_workingData.begin() + begin, m_workingData.begin() + end, m_data->begin() + begin);
+
+    mDirtyRowBegin = 0;
+    mDirtyRowEnd = 0;
+}
+
 bool ThermalErosion::needsVisualUpdate() const
 {
     return mNeedsVisualUpdate;
@@ -751,6 +670,8 @@ int ThermalErosion::step()
 
 int ThermalErosion::stepChunk(int maxCells)
 {
+    PROFILE_SCOPE("stepChunk");
+
     const int W = m_width;
     const int H = m_height;
 
@@ -765,9 +686,14 @@ int ThermalErosion::stepChunk(int maxCells)
 
     const int totalInnerCells = (H - 2) * (W - 2);
 
-    if (m_workingData.empty() || static_cast<int>(m_workingData.size()) != W * H) {
-        m_workingData = *m_data;
+    // Début d'itération : seule copie complète, le tampon garde sa capacité
+    if (!mWorkingActive || static_cast<int>(m_workingData.size()) != W * H) {
+        m_workingData.assign(m_data->begin(), m_data->end());
+        mWorkingActive = true;
+        mDirtyRowBegin = 0;
+        mDirtyRowEnd = 0;
         mCurrentIndex = 0;
+        mCurrentResidual = StepResidual();
     }
 
     const float* src = m_data->data();
@@ -784,12 +710,20 @@ int ThermalErosion::stepChunk(int maxCells)
     }
 
     const int changes = applyBlockedErosionRange(src, dst, startIndex, endIndex);
+    if (endIndex > startIndex) {
+        markRowsDirty(startIndex, endIndex);
+    }
+    mDirtyTiles.collect(mDirtyPatchIndices);
 
     mCurrentIndex = endIndex;
+    mCurrentResidual.cellsModified += changes;
 
     if (mCurrentIndex >= totalInnerCells) {
-        *m_data = m_workingData;
-        m_workingData.clear();
+        // Le résidu couvre toute l'itération, pas seulement le dernier bloc
+        publishResidual(mCurrentResidual.cellsModified);
+
+        copyDirtyRows();
+        mWorkingActive = false;
         mCurrentIndex = 0;
         mIterationFinished = true;
         mCellsProcessedSinceLastCommit = 0;
@@ -811,24 +745,29 @@ int ThermalErosion::stepPureTwoPhase()
     }
 
     clearDirtyPatchIndices();
+    mCurrentResidual = StepResidual();
 
     const int totalInnerCells = (m_height - 2) * (m_width - 2);
 
-    std::vector<float> srcSnapshot = *m_data;
-    std::vector<float> dst = srcSnapshot;
+    prepareTwoPhaseBuffers();
+    const std::vector<float>& srcSnapshot = mSnapshot;
+    std::vector<float>& dst = mNextData;
 
     const int changes = applyErosionRange(srcSnapshot.data(),
                                           dst.data(),
                                           0,
                                           totalInnerCells);
 
-    *m_data = std::move(dst);
+    m_data->swap(dst);
 
     mIterationFinished = true;
     mNeedsVisualUpdate = false;
     mCellsProcessedSinceLastCommit = 0;
     mCurrentIndex = 0;
 
+    mDirtyTiles.collect(mDirtyPatchIndices);
+    publishResidual(changes);
+
     return changes;
 }
 
@@ -844,24 +783,29 @@ int ThermalErosion::stepBlockedPureTwoPhase()
     }
 
     clearDirtyPatchIndices();
+    mCurrentResidual = StepResidual();
 
     const int totalInnerCells = (m_height - 2) * (m_width - 2);
 
-    std::vector<float> srcSnapshot = *m_data;
-    std::vector<float> dst = srcSnapshot;
+    prepareTwoPhaseBuffers();
+    const std::vector<float>& srcSnapshot = mSnapshot;
+    std::vector<float>& dst = mNextData;
 
     const int changes = applyBlockedErosionRange(srcSnapshot.data(),
                                                  dst.data(),
                                                  0,
                                                  totalInnerCells);
 
-    *m_data = std::move(dst);
+    m_data->swap(dst);
 
     mIterationFinished = true;
     mNeedsVisualUpdate = false;
     mCellsProcessedSinceLastCommit = 0;
     mCurrentIndex = 0;
 
+    mDirtyTiles.collect(mDirtyPatchIndices);
+    publishResidual(changes);
+
     return changes;
 }
 int ThermalErosion::stepBlockedParallelPureTwoPhase()
@@ -876,9 +820,11 @@ int ThermalErosion::stepBlockedParallelPureTwoPhase()
     }
 
     clearDirtyPatchIndices();
+    mCurrentResidual = StepResidual();
 
-    std::vector<float> srcSnapshot = *m_data;
-    std::vector<float> dst = srcSnapshot;
+    prepareTwoPhaseBuffers();
+    const std::vector<float>& srcSnapshot = mSnapshot;
+    std::vector<float>& dst = mNextData;
 
 #ifdef _OPENMP
     const int numThreads = omp_get_max_threads();
@@ -886,56 +832,36 @@ int ThermalErosion::stepBlockedParallelPureTwoPhase()
     const int numThreads = 1;
 #endif
 
-    std::vector<std::vector<float>> threadDeltas(
-        numThreads,
-        std::vector<float>(srcSnapshot.size(), 0.0f)
-    );
-
-    std::vector<std::vector<unsigned char>> threadPatchMarked(
-        numThreads,
-        std::vector<unsigned char>(mNbPatchX * mNbPatchZ, 0)
-    );
+    prepareThreadBuffers(numThreads);
+    std::vector<std::vector<float>>& threadDeltas = mThreadDeltas;
 
     const int changes = applyBlockedParallelErosionToThreadLocalBuffers(
         srcSnapshot.data(),
-        threadDeltas,
-        threadPatchMarked
+        threadDeltas
     );
 
+    // Les deltas sont remis à zéro au passage pour le pas suivant
     #pragma omp parallel for schedule(static)
     for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t>(dst.size()); ++idx)
     {
         float sum = 0.0f;
         for (int t = 0; t < numThreads; ++t) {
             sum += threadDeltas[t][idx];
+            threadDeltas[t][idx] = 0.0f;
         }
         dst[idx] += sum;
     }
 
-    for (int patchIdx = 0; patchIdx < mNbPatchX * mNbPatchZ; ++patchIdx)
-    {
-        bool dirty = false;
-        for (int t = 0; t < numThreads; ++t)
-        {
-            if (threadPatchMarked[t][patchIdx]) {
-                dirty = true;
-                break;
-            }
-        }
-
-        if (dirty) {
-            mPatchMarked[patchIdx] = true;
-            mDirtyPatchIndices.push_back(patchIdx);
-        }
-    }
-
-    *m_data = std::move(dst);
+    m_data->swap(dst);
 
     mIterationFinished = true;
     mNeedsVisualUpdate = false;
     mCellsProcessedSinceLastCommit = 0;
     mCurrentIndex = 0;
 
+    mDirtyTiles.collect(mDirtyPatchIndices);
+    publishResidual(changes);
+
     return changes;
 }
 
@@ -952,21 +878,16 @@ int ThermalErosion::applyCheckerboardInPlaceColorParallelBuffered(float* data, i
 #endif
 
     const std::size_t dataSize = static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height);
-    const int numPatches = mNbPatchX * mNbPatchZ;
 
-    std::vector<std::vector<float>> threadDeltas(
-        numThreads,
-        std::vector<float>(dataSize, 0.0f)
-    );
-
-    std::vector<std::vector<unsigned char>> threadPatchMasks(
-        numThreads,
-        std::vector<unsigned char>(numPatches, 0)
-    );
+    prepareThreadBuffers(numThreads);
+    std::vector<std::vector<float>>& threadDeltas = mThreadDeltas;
 
     int changes = 0;
+    float maxExcess = 0.0f;
+    double movedMass = 0.0;
+    double depositedMass = 0.0;
 
-    #pragma omp parallel for reduction(+:changes) schedule(static)
+    #pragma omp parallel for reduction(+:changes, movedMass, depositedMass) reduction(max:maxExcess) schedule(static)
     for (int i = 1; i < m_height - 1; ++i)
     {
 #ifdef _OPENMP
@@ -976,7 +897,7 @@ int ThermalErosion::applyCheckerboardInPlaceColorParallelBuffered(float* data, i
 #endif
 
         std::vector<float>& localDelta = threadDeltas[tid];
-        std::vector<unsigned char>& localPatchMask = threadPatchMasks[tid];
+        DirtyTileSet::CellBounds rowBounds;
 
         for (int j = 1; j < m_width - 1; ++j)
         {
@@ -984,61 +905,27 @@ int ThermalErosion::applyCheckerboardInPlaceColorParallelBuffered(float* data, i
                 continue;
             }
 
-            const int center = toIndex(i, j);
-            const float currentHeight = data[center];
-
-            float totalDiff = 0.0f;
-            int validNeighbors = 0;
-
-            float diffs[8] = {0.0f};
-            int neighborIndices[8] = {0};
-            int neighborI[8] = {0};
-            int neighborJ[8] = {0};
-
-            for (int k = 0; k < mNeighborCount; ++k)
-            {
-                const int ni = i + mActiveNeighbors[k].di;
-                const int nj = j + mActiveNeighbors[k].dj;
-                const int nIndex = toIndex(ni, nj);
-
-                const float diff = currentHeight - data[nIndex];
-
-                diffs[k] = diff;
-                neighborIndices[k] = nIndex;
-                neighborI[k] = ni;
-                neighborJ[k] = nj;
-
-                if (diff > talusAngle) {
-                    totalDiff += diff;
-                    ++validNeighbors;
-                }
-            }
-
-            if (totalDiff <= 0.0f || validNeighbors <= 0) {
+            ThermalKernel::CellMove move;
+            if (!ThermalKernel::erodeCell(data, localDelta.data(), toIndex(i, j), mNeighborIndexOffsets,
+                                          mNeighborCount, talusAngle, transferRate, move)) {
                 continue;
             }
 
-            float materialToMove = transferRate * (totalDiff / validNeighbors);
-            materialToMove = std::min(materialToMove, currentHeight * transferRate);
-
-            localDelta[center] -= materialToMove;
-            localPatchMask[patchIndexFromCell(i, j)] = 1;
-
-            const float invTotalDiff = 1.0f / totalDiff;
-
-            for (int k = 0; k < mNeighborCount; ++k)
-            {
-                if (diffs[k] > talusAngle) {
-                    const float moveAmount = materialToMove * (diffs[k] * invTotalDiff);
-                    localDelta[neighborIndices[k]] += moveAmount;
-                    localPatchMask[patchIndexFromCell(neighborI[k], neighborJ[k])] = 1;
-                }
-            }
+            maxExcess = std::max(maxExcess, move.maxDiff - talusAngle);
+            movedMass += move.moved;
+            depositedMass += move.deposited;
+            rowBounds.add(i, j);
 
             ++changes;
         }
+
+        mDirtyTiles.markAround(rowBounds);
     }
 
+    mCurrentResidual.maxSlopeExcess = std::max(mCurrentResidual.maxSlopeExcess, maxExcess);
+    mCurrentResidual.movedMass += movedMass;
+    mCurrentResidual.depositedMass += depositedMass;
+
     // Réduction parallèle des contributions vers data
     #pragma omp parallel for schedule(static)
     for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t>(dataSize); ++idx)
@@ -1046,28 +933,11 @@ int ThermalErosion::applyCheckerboardInPlaceColorParallelBuffered(float* data, i
         float sum = 0.0f;
         for (int t = 0; t < numThreads; ++t) {
             sum += threadDeltas[t][idx];
+            threadDeltas[t][idx] = 0.0f;
         }
         data[idx] += sum;
     }
 
-    // Fusion des patches sales
-    for (int patchIdx = 0; patchIdx < numPatches; ++patchIdx)
-    {
-        bool dirty = false;
-        for (int t = 0; t < numThreads; ++t)
-        {
-            if (threadPatchMasks[t][patchIdx]) {
-                dirty = true;
-                break;
-            }
-        }
-
-        if (dirty && !mPatchMarked[patchIdx]) {
-            mPatchMarked[patchIdx] = true;
-            mDirtyPatchIndices.push_back(patchIdx);
-        }
-    }
-
     return changes;
 }
 int ThermalErosion::stepCheckerboardInPlaceParallel()
@@ -1086,6 +956,7 @@ int ThermalErosion::stepCheckerboardInPlaceParallel()
     }
 
     clearDirtyPatchIndices();
+    mCurrentResidual = StepResidual();
 
     float* data = m_data->data();
 
@@ -1098,5 +969,8 @@ int ThermalErosion::stepCheckerboardInPlaceParallel()
     mCellsProcessedSinceLastCommit = 0;
     mCurrentIndex = 0;
 
+    mDirtyTiles.collect(mDirtyPatchIndices);
+    publishResidual(changes);
+
     return changes;
 }
\ No newline at end of file
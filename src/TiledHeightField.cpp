@@ -0,0 +1,505 @@
+#include "TiledHeightField.hpp"
+#include "stb_image.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr char kTiledMagic[8] = {'E', 'R', 'T', 'I', 'L', 'E', 'S', '\0'};
+
+uint64_t alignToPage(uint64_t size)
+{
+    const uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    return (size + page - 1) / page * page;
+}
+
+std::size_t bytesPerSample(TileFormat format)
+{
+    return format == TileFormat::UInt16 ? sizeof(uint16_t) : sizeof(float);
+}
+} // namespace
+
+TiledHeightField::~TiledHeightField()
+{
+    close();
+}
+
+bool TiledHeightField::create(const std::string &path, int width, int height, int tileSize,
+                              TileFormat format, float minHeight, float maxHeight)
+{
+    close();
+
+    if (width <= 0 || height <= 0 || tileSize <= 0)
+    {
+        std::cerr << "Error: invalid tiled terrain dimensions.\n";
+        return false;
+    }
+
+    std::memset(&mHeader, 0, sizeof(mHeader));
+    std::memcpy(mHeader.magic, kTiledMagic, sizeof(kTiledMagic));
+    mHeader.version = VERSION;
+    mHeader.format = static_cast<uint32_t>(format);
+    mHeader.width = width;
+    mHeader.height = height;
+    mHeader.tileSize = tileSize;
+    mHeader.nbTileX = (width + tileSize - 1) / tileSize;
+    mHeader.nbTileZ = (height + tileSize - 1) / tileSize;
+    mHeader.minHeight = minHeight;
+    mHeader.maxHeight = maxHeight;
+    mHeader.tileStride = alignToPage(static_cast<uint64_t>(tileSize) * tileSize * bytesPerSample(format));
+    mHeader.dataOffset = alignToPage(sizeof(TiledHeader));
+
+    mFd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (mFd < 0)
+    {
+        std::cerr << "Error: cannot create tiled terrain " << path << "\n";
+        return false;
+    }
+
+    mMappingSize = mHeader.dataOffset
+                 + mHeader.tileStride * static_cast<uint64_t>(mHeader.nbTileX) * mHeader.nbTileZ;
+
+    // Fichier creux : les tuiles ne consomment de l'espace qu'une fois écrites
+    mWritable = true;
+    if (ftruncate(mFd, static_cast<off_t>(mMappingSize)) != 0 || !mapFile(true))
+    {
+        std::cerr << "Error: cannot allocate tiled terrain " << path << "\n";
+        close();
+        return false;
+    }
+
+    std::memcpy(mMapping, &mHeader, sizeof(mHeader));
+
+    // Un fichier creux se lit comme des zéros, c'est-à-dire minHeight en UInt16
+    if (format == TileFormat::Float32 && minHeight != 0.0f)
+    {
+        std::vector<float> fill(static_cast<std::size_t>(tileSize) * tileSize, minHeight);
+        for (int tz = 0; tz < mHeader.nbTileZ; ++tz)
+            for (int tx = 0; tx < mHeader.nbTileX; ++tx)
+                writeTile(tx, tz, fill.data());
+    }
+
+    return true;
+}
+
+bool TiledHeightField::open(const std::string &path, bool writable)
+{
+    close();
+
+    mFd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+    if (mFd < 0)
+    {
+        std::cerr << "Error: cannot open tiled terrain " << path << "\n";
+        return false;
+    }
+
+    if (::pread(mFd, &mHeader, sizeof(mHeader), 0) != static_cast<ssize_t>(sizeof(mHeader))
+        || std::memcmp(mHeader.magic, kTiledMagic, sizeof(kTiledMagic)) != 0
+        || mHeader.version != VERSION)
+    {
+        std::cerr << "Error: " << path << " is not a tiled terrain file.\n";
+        close();
+        return false;
+    }
+
+    const bool validFormat = mHeader.format == static_cast<uint32_t>(TileFormat::Float32)
+                          || mHeader.format == static_cast<uint32_t>(TileFormat::UInt16);
+
+    if (!validFormat || mHeader.width <= 0 || mHeader.height <= 0 || mHeader.tileSize <= 0
+        || mHeader.nbTileX != (mHeader.width + mHeader.tileSize - 1) / mHeader.tileSize
+        || mHeader.nbTileZ != (mHeader.height + mHeader.tileSize - 1) / mHeader.tileSize
+        || mHeader.tileStride < static_cast<uint64_t>(mHeader.tileSize) * mHeader.tileSize
+                                    * bytesPerSample(static_cast<TileFormat>(mHeader.format))
+        || mHeader.dataOffset < sizeof(TiledHeader))
+    {
+        std::cerr << "Error: corrupted header in tiled terrain " << path << "\n";
+        close();
+        return false;
+    }
+
+    mMappingSize = mHeader.dataOffset
+                 + mHeader.tileStride * static_cast<uint64_t>(mHeader.nbTileX) * mHeader.nbTileZ;
+
+    // Un accès au-delà de la fin d'un fichier tronqué lèverait SIGBUS
+    struct stat st {};
+    if (fstat(mFd, &st) != 0 || static_cast<uint64_t>(st.st_size) < mMappingSize)
+    {
+        std::cerr << "Error: tiled terrain " << path << " is truncated (" << st.st_size
+                  << " bytes, " << mMappingSize << " expected).\n";
+        close();
+        return false;
+    }
+
+    if (!mapFile(writable))
+    {
+        std::cerr << "Error: cannot map tiled terrain " << path << "\n";
+        close();
+        return false;
+    }
+
+    mWritable = writable;
+
+    return true;
+}
+
+bool TiledHeightField::mapFile(bool writable)
+{
+    const int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void *mapping = mmap(nullptr, mMappingSize, prot, MAP_SHARED, mFd, 0);
+
+    if (mapping == MAP_FAILED)
+    {
+        mMapping = nullptr;
+        return false;
+    }
+
+    mMapping = static_cast<unsigned char *>(mapping);
+    madvise(mMapping, mMappingSize, MADV_RANDOM);
+    return true;
+}
+
+void TiledHeightField::close()
+{
+    if (mMapping)
+    {
+        msync(mMapping, mMappingSize, MS_SYNC);
+        munmap(mMapping, mMappingSize);
+        mMapping = nullptr;
+    }
+
+    if (mFd >= 0)
+    {
+        ::close(mFd);
+        mFd = -1;
+    }
+
+    mMappingSize = 0;
+    mWritable = false;
+}
+
+unsigned char *TiledHeightField::tilePtr(int tx, int tz) const
+{
+    const uint64_t tileIndex = static_cast<uint64_t>(tz) * mHeader.nbTileX + tx;
+    return mMapping + mHeader.dataOffset + tileIndex * mHeader.tileStride;
+}
+
+void TiledHeightField::readTile(int tx, int tz, float *out) const
+{
+    const std::size_t count = static_cast<std::size_t>(mHeader.tileSize) * mHeader.tileSize;
+    const unsigned char *src = tilePtr(tx, tz);
+
+    if (getFormat() == TileFormat::Float32)
+    {
+        std::memcpy(out, src, count * sizeof(float));
+        return;
+    }
+
+    const uint16_t *quantized = reinterpret_cast<const uint16_t *>(src);
+    const float scale = (mHeader.maxHeight - mHeader.minHeight) / 65535.0f;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        out[i] = mHeader.minHeight + static_cast<float>(quantized[i]) * scale;
+    }
+}
+
+bool TiledHeightField::writeTile(int tx, int tz, const float *in)
+{
+    // Les pages d'un fichier ouvert en lecture seule sont projetées PROT_READ
+    if (!mWritable)
+    {
+        std::cerr << "Error: cannot write tile (" << tx << ", " << tz << "), the tiled terrain is read-only.\n";
+        return false;
+    }
+
+    const std::size_t count = static_cast<std::size_t>(mHeader.tileSize) * mHeader.tileSize;
+    unsigned char *dst = tilePtr(tx, tz);
+
+    if (getFormat() == TileFormat::Float32)
+    {
+        std::memcpy(dst, in, count * sizeof(float));
+        return true;
+    }
+
+    uint16_t *quantized = reinterpret_cast<uint16_t *>(dst);
+    const float range = mHeader.maxHeight - mHeader.minHeight;
+    const float invScale = range > 0.0f ? 65535.0f / range : 0.0f;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const float q = (in[i] - mHeader.minHeight) * invScale + 0.5f;
+        quantized[i] = static_cast<uint16_t>(std::clamp(q, 0.0f, 65535.0f));
+    }
+
+    return true;
+}
+
+void TiledHeightField::adviseTile(int tx, int tz, bool willNeed) const
+{
+    madvise(tilePtr(tx, tz), mHeader.tileStride, willNeed ? MADV_WILLNEED : MADV_DONTNEED);
+}
+
+void TiledHeightField::syncTile(int tx, int tz) const
+{
+    msync(tilePtr(tx, tz), mHeader.tileStride, MS_ASYNC);
+}
+
+bool TiledHeightField::convertFromPng(const char *pngPath, const std::string &outPath,
+                                      int tileSize, TileFormat format)
+{
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+
+    // Le PNG n'est pas adressable par blocs : il est décodé une seule fois
+    // puis redistribué tuile par tuile.
+    std::vector<float> samples;
+    float maxValue = 255.0f;
+
+    if (stbi_is_16_bit(pngPath))
+    {
+        stbi_us *image = stbi_load_16(pngPath, &width, &height, &channels, 1);
+        if (!image)
+        {
+            std::cerr << "Failed to load heightmap " << pngPath << "\n";
+            return false;
+        }
+        samples.assign(image, image + static_cast<std::size_t>(width) * height);
+        stbi_image_free(image);
+        maxValue = 65535.0f;
+    }
+    else
+    {
+        stbi_uc *image = stbi_load(pngPath, &width, &height, &channels, 1);
+        if (!image)
+        {
+            std::cerr << "Failed to load heightmap " << pngPath << "\n";
+            return false;
+        }
+        samples.assign(image, image + static_cast<std::size_t>(width) * height);
+        stbi_image_free(image);
+    }
+
+    TiledHeightField field;
+    if (!field.create(outPath, width, height, tileSize, format, 0.0f, maxValue))
+        return false;
+
+    std::vector<float> tile(static_cast<std::size_t>(tileSize) * tileSize);
+
+    for (int tz = 0; tz < field.getNbTileZ(); ++tz)
+    {
+        for (int tx = 0; tx < field.getNbTileX(); ++tx)
+        {
+            for (int z = 0; z < tileSize; ++z)
+            {
+                const int srcZ = std::min(tz * tileSize + z, height - 1);
+                for (int x = 0; x < tileSize; ++x)
+                {
+                    const int srcX = std::min(tx * tileSize + x, width - 1);
+                    tile[z * tileSize + x] = samples[static_cast<std::size_t>(srcZ) * width + srcX];
+                }
+            }
+
+            field.writeTile(tx, tz, tile.data());
+        }
+    }
+
+    std::cout << "Converted " << pngPath << " (" << width << " x " << height << ") into "
+              << field.getNbTileX() * field.getNbTileZ() << " tiles of " << tileSize
+              << " x " << tileSize << " -> " << outPath << std::endl;
+
+    return true;
+}
+
+TileCache::TileCache(TiledHeightField &field, int capacity) : mField(field)
+{
+    mSlots.resize(std::max(1, capacity));
+}
+
+TileCache::~TileCache()
+{
+    flush();
+}
+
+int TileCache::findVictim() const
+{
+    int victim = -1;
+    unsigned long long oldest = std::numeric_limits<unsigned long long>::max();
+
+    for (int s = 0; s < static_cast<int>(mSlots.size()); ++s)
+    {
+        const Slot &slot = mSlots[s];
+
+        if (slot.tileIndex < 0)
+            return s;
+
+        if (slot.pins == 0 && slot.lastUse < oldest)
+        {
+            oldest = slot.lastUse;
+            victim = s;
+        }
+    }
+
+    return victim;
+}
+
+bool TileCache::writeBack(Slot &slot)
+{
+    const int tx = slot.tileIndex % mField.getNbTileX();
+    const int tz = slot.tileIndex / mField.getNbTileX();
+
+    if (!slot.dirty)
+        return true;
+
+    // Refusée sur un fichier en lecture seule : la modification est perdue
+    slot.dirty = false;
+    if (!mField.writeTile(tx, tz, slot.data.data()))
+        return false;
+
+    mField.syncTile(tx, tz);
+    return true;
+}
+
+float *TileCache::acquire(int tx, int tz)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    const int tileIndex = tz * mField.getNbTileX() + tx;
+    auto it = mSlotOfTile.find(tileIndex);
+
+    if (it != mSlotOfTile.end())
+    {
+        Slot &slot = mSlots[it->second];
+        ++slot.pins;
+        slot.lastUse = ++mClock;
+        ++mHits;
+        return slot.data.data();
+    }
+
+    const int victim = findVictim();
+    if (victim < 0)
+    {
+        std::cerr << "Error: tile cache exhausted (all " << mSlots.size() << " tiles pinned).\n";
+        return nullptr;
+    }
+
+    Slot &slot = mSlots[victim];
+
+    if (slot.tileIndex >= 0)
+    {
+        writeBack(slot);
+        mField.adviseTile(slot.tileIndex % mField.getNbTileX(),
+                          slot.tileIndex / mField.getNbTileX(),
+                          false);
+        mSlotOfTile.erase(slot.tileIndex);
+    }
+
+    const std::size_t tileCells = static_cast<std::size_t>(mField.getTileSize()) * mField.getTileSize();
+    slot.data.resize(tileCells);
+    mField.readTile(tx, tz, slot.data.data());
+
+    slot.tileIndex = tileIndex;
+    slot.pins = 1;
+    slot.dirty = false;
+    slot.lastUse = ++mClock;
+    mSlotOfTile[tileIndex] = victim;
+    ++mMisses;
+
+    return slot.data.data();
+}
+
+void TileCache::release(int tx, int tz, bool dirty)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto it = mSlotOfTile.find(tz * mField.getNbTileX() + tx);
+    if (it == mSlotOfTile.end())
+        return;
+
+    Slot &slot = mSlots[it->second];
+    slot.pins = std::max(0, slot.pins - 1);
+    slot.dirty = slot.dirty || dirty;
+}
+
+void TileCache::prefetchAround(int cellX, int cellZ, int radiusTiles)
+{
+    const int centerTx = cellX / mField.getTileSize();
+    const int centerTz = cellZ / mField.getTileSize();
+
+    for (int tz = std::max(0, centerTz - radiusTiles);
+         tz <= std::min(mField.getNbTileZ() - 1, centerTz + radiusTiles); ++tz)
+    {
+        for (int tx = std::max(0, centerTx - radiusTiles);
+             tx <= std::min(mField.getNbTileX() - 1, centerTx + radiusTiles); ++tx)
+        {
+            mField.adviseTile(tx, tz, true);
+        }
+    }
+}
+
+bool TileCache::readRegion(int x0, int z0, int width, int height, float *out)
+{
+    const int T = mField.getTileSize();
+    const int lastX = mField.getWidth() - 1;
+    const int lastZ = mField.getHeight() - 1;
+
+    const int xMin = std::clamp(x0, 0, lastX);
+    const int xMax = std::clamp(x0 + width - 1, 0, lastX);
+    const int zMin = std::clamp(z0, 0, lastZ);
+    const int zMax = std::clamp(z0 + height - 1, 0, lastZ);
+
+    prefetchAround((xMin + xMax) / 2, (zMin + zMax) / 2, (std::max(xMax - xMin, zMax - zMin) / T + 1) / 2 + 1);
+
+    for (int tz = zMin / T; tz <= zMax / T; ++tz)
+    {
+        for (int tx = xMin / T; tx <= xMax / T; ++tx)
+        {
+            const float *tile = acquire(tx, tz);
+            if (!tile)
+                return false;
+
+            // Les cellules hors terrain reprennent la cellule de bord la plus proche
+            for (int z = 0; z < height; ++z)
+            {
+                const int cellZ = std::clamp(z0 + z, 0, lastZ);
+                if (cellZ / T != tz)
+                    continue;
+
+                const float *row = tile + static_cast<std::size_t>(cellZ - tz * T) * T;
+                float *dst = out + static_cast<std::size_t>(z) * width;
+
+                for (int x = 0; x < width; ++x)
+                {
+                    const int cellX = std::clamp(x0 + x, 0, lastX);
+                    if (cellX / T == tx)
+                        dst[x] = row[cellX - tx * T];
+                }
+            }
+
+            release(tx, tz);
+        }
+    }
+
+    return true;
+}
+
+bool TileCache::flush()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    bool written = true;
+    for (Slot &slot : mSlots)
+    {
+        if (slot.tileIndex >= 0)
+            written = writeBack(slot) && written;
+    }
+
+    return written;
+}
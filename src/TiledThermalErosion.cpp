@@ -0,0 +1,210 @@
+#include "TiledThermalErosion.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+TiledThermalErosion::TiledThermalErosion(TiledHeightField &field, TileCache &cache)
+    : mField(field), mCache(cache)
+{
+    useEightNeighbors();
+}
+
+void TiledThermalErosion::setTalusAngle(float angle)
+{
+    const float PI = 3.14159265f;
+    mTalusAngle = std::tan(angle * PI / 180.0f);
+}
+
+void TiledThermalErosion::useEightNeighbors()
+{
+    mNeighborCount = 8;
+}
+
+void TiledThermalErosion::useFourNeighbors()
+{
+    mNeighborCount = 4;
+}
+
+bool TiledThermalErosion::gatherWindow(int tx, int tz, std::vector<float> &window) const
+{
+    const int T = mField.getTileSize();
+    const int windowSize = T + 2 * HALO;
+    const int originX = tx * T - HALO;
+    const int originZ = tz * T - HALO;
+
+    std::fill(window.begin(), window.end(), 0.0f);
+
+    // La fenêtre recouvre au plus 3x3 tuiles ; chacune n'est épinglée
+    // que le temps de copier sa contribution.
+    for (int ntz = std::max(0, tz - 1); ntz <= std::min(mField.getNbTileZ() - 1, tz + 1); ++ntz)
+    {
+        for (int ntx = std::max(0, tx - 1); ntx <= std::min(mField.getNbTileX() - 1, tx + 1); ++ntx)
+        {
+            const int z0 = std::max(ntz * T, originZ);
+            const int z1 = std::min({(ntz + 1) * T, originZ + windowSize, mField.getHeight()});
+            const int x0 = std::max(ntx * T, originX);
+            const int x1 = std::min({(ntx + 1) * T, originX + windowSize, mField.getWidth()});
+
+            if (z0 >= z1 || x0 >= x1)
+                continue;
+
+            const float *tile = mCache.acquire(ntx, ntz);
+            if (!tile)
+                return false;
+
+            for (int z = z0; z < z1; ++z)
+            {
+                std::memcpy(&window[(z - originZ) * windowSize + (x0 - originX)],
+                            &tile[(z - ntz * T) * T + (x0 - ntx * T)],
+                            static_cast<std::size_t>(x1 - x0) * sizeof(float));
+            }
+
+            mCache.release(ntx, ntz);
+        }
+    }
+
+    return true;
+}
+
+int TiledThermalErosion::erodeWindow(int tx, int tz, const std::vector<float> &src, std::vector<float> &dst) const
+{
+    const int T = mField.getTileSize();
+    const int windowSize = T + 2 * HALO;
+    const int originX = tx * T - HALO;
+    const int originZ = tz * T - HALO;
+    const int W = mField.getWidth();
+    const int H = mField.getHeight();
+
+    dst = src;
+
+    int offsets[8];
+    ThermalKernel::indexOffsets(windowSize, mNeighborCount, offsets);
+
+    int changes = 0;
+
+    // L'anneau externe du halo ne sert que de voisinage : seules les cellules
+    // dont tous les voisins sont dans la fenêtre sont érodées, et les bords
+    // du terrain global restent fixes comme dans ThermalErosion.
+    for (int i = 1; i < windowSize - 1; ++i)
+    {
+        const int globalI = originZ + i;
+        if (globalI < 1 || globalI > H - 2)
+            continue;
+
+        for (int j = 1; j < windowSize - 1; ++j)
+        {
+            const int globalJ = originX + j;
+            if (globalJ < 1 || globalJ > W - 2)
+                continue;
+
+            ThermalKernel::CellMove move;
+            if (!ThermalKernel::erodeCell(src.data(), dst.data(), i * windowSize + j, offsets, mNeighborCount,
+                                          mTalusAngle, mTransferRate, move)) {
+                continue;
+            }
+
+            if (i >= HALO && i < HALO + T && j >= HALO && j < HALO + T) {
+                ++changes;
+            }
+        }
+    }
+
+    return changes;
+}
+
+bool TiledThermalErosion::storeTile(int tx, int tz, const std::vector<float> &tile)
+{
+    float *data = mCache.acquire(tx, tz);
+    if (!data)
+        return false;
+
+    std::memcpy(data, tile.data(), tile.size() * sizeof(float));
+    mCache.release(tx, tz, true);
+    return true;
+}
+
+long long TiledThermalErosion::step()
+{
+    if (!mField.isOpen()) {
+        std::cerr << "Error: tiled terrain not opened in TiledThermalErosion.\n";
+        return -1;
+    }
+
+    if (!mField.isWritable()) {
+        std::cerr << "Error: tiled terrain opened read-only, cannot erode it in place.\n";
+        return -1;
+    }
+
+    const int T = mField.getTileSize();
+    const int windowSize = T + 2 * HALO;
+    const int nbTileX = mField.getNbTileX();
+    const int nbTileZ = mField.getNbTileZ();
+
+    // Chaque thread n'épingle qu'une tuile à la fois : avec au plus
+    // getCapacity() threads, le cache ne peut pas être entièrement épinglé.
+    int threads = 1;
+#ifdef _OPENMP
+    threads = std::max(1, std::min({omp_get_max_threads(), nbTileX, mCache.getCapacity()}));
+#endif
+
+    std::vector<std::vector<float>> pendingRow(nbTileX, std::vector<float>(T * T));
+    std::vector<std::vector<float>> currentRow(nbTileX, std::vector<float>(T * T));
+
+    long long changes = 0;
+    bool failed = false;
+
+    for (int tz = 0; tz < nbTileZ && !failed; ++tz)
+    {
+        #pragma omp parallel num_threads(threads) reduction(+:changes)
+        {
+            std::vector<float> src(windowSize * windowSize);
+            std::vector<float> dst(windowSize * windowSize);
+
+            #pragma omp for schedule(dynamic)
+            for (int tx = 0; tx < nbTileX; ++tx)
+            {
+                if (!gatherWindow(tx, tz, src))
+                {
+                    #pragma omp atomic write
+                    failed = true;
+                    continue;
+                }
+
+                changes += erodeWindow(tx, tz, src, dst);
+
+                std::vector<float> &out = currentRow[tx];
+                for (int z = 0; z < T; ++z)
+                {
+                    std::memcpy(&out[z * T], &dst[(z + HALO) * windowSize + HALO], T * sizeof(float));
+                }
+            }
+        }
+
+        // La rangée précédente n'est plus lue comme halo : on peut l'écrire
+        if (tz > 0)
+        {
+            for (int tx = 0; tx < nbTileX && !failed; ++tx)
+                failed = !storeTile(tx, tz - 1, pendingRow[tx]);
+        }
+
+        std::swap(pendingRow, currentRow);
+    }
+
+    for (int tx = 0; tx < nbTileX && !failed; ++tx)
+        failed = !storeTile(tx, nbTileZ - 1, pendingRow[tx]);
+
+    if (!mCache.flush())
+        failed = true;
+
+    if (failed) {
+        std::cerr << "Error: tiled erosion step aborted, the tile cache could not provide a tile.\n";
+        return -1;
+    }
+
+    return changes;
+}
@@ -1,24 +1,63 @@
 #include "ValidationTest.hpp"
+#include "MassReduction.hpp"
+#include "NumaPlacement.hpp"
+#include "RendererManager.hpp"
 
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <numeric>
+#include <sstream>
 #include <vector>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 std::vector<float> ValidationTest::initialData;
+bool ValidationTest::perfCountersEnabled = false;
+double ValidationTest::machineBandwidth = 0.0;
+
+namespace
+{
+// Champ CSV vide quand le compteur n'est pas disponible
+void write_optional(std::ofstream& out, bool available, double value)
+{
+    if (available)
+        out << value;
+}
+
+// Variable d'environnement telle quelle, "unset" si absente (les listes
+// OMP_PLACES contiennent des virgules : le champ CSV est mis entre guillemets)
+std::string env_or_unset(const char* name)
+{
+    const char* value = std::getenv(name);
+    return value ? value : "unset";
+}
+
+void set_omp_threads(int threads)
+{
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#else
+    (void)threads;
+#endif
+}
+} // namespace
 
 float ValidationTest::test_mass_conservation(std::vector<float>& finalData)
 {
-    float mass_before = calculate_total_mass(initialData);
-    float mass_after = calculate_total_mass(finalData);
+    const double mass_before = calculate_total_mass(initialData);
+    const double mass_after = calculate_total_mass(finalData);
 
-    float error = std::abs(mass_after - mass_before) / mass_before;
-    return error;
+    return static_cast<float>(MassReduction::relativeError(mass_before, mass_after));
 }
 
 bool ValidationTest::test_height_limits(std::vector<float>& finalData)
@@ -35,13 +74,9 @@ bool ValidationTest::test_height_limits(std::vector<float>& finalData)
     return true;
 }
 
-float ValidationTest::calculate_total_mass(const std::vector<float>& data)
+double ValidationTest::calculate_total_mass(const std::vector<float>& data)
 {
-    float total = 0.0f;
-    for (float h : data) {
-        total += h;
-    }
-    return total;
+    return MassReduction::sum(data);
 }
 
 std::string ValidationTest::variant_to_string(ThermalVariant variant)
@@ -65,6 +100,28 @@ std::string ValidationTest::variant_to_string(ThermalVariant variant)
     return "unknown";
 }
 
+bool ValidationTest::variant_from_string(const std::string& name, ThermalVariant& variant)
+{
+    const ThermalVariant variants[] = {
+        ThermalVariant::PureTwoPhase,
+        ThermalVariant::BlockedPureTwoPhase,
+        ThermalVariant::BlockedParallelPureTwoPhase,
+        ThermalVariant::CheckerboardPureTwoPhase,
+        ThermalVariant::BlockedCheckerboardPureTwoPhase,
+        ThermalVariant::CheckerboardInPlace,
+        ThermalVariant::CheckerboardInPlaceParallel
+    };
+
+    for (ThermalVariant v : variants) {
+        if (variant_to_string(v) == name) {
+            variant = v;
+            return true;
+        }
+    }
+
+    return false;
+}
+
 std::string ValidationTest::neighborhood_to_string(NeighborhoodMode mode)
 {
     switch (mode) {
@@ -150,14 +207,31 @@ void ValidationTest::write_raw_runs_csv(const std::string& filepath,
                                         const std::vector<RunMetrics>& runs)
 {
     std::ofstream out(filepath);
-    out << "run_id,total_time_ms,avg_time_per_step_ms,final_mass_error,last_cells_modified\n";
+    out << "run_id,total_time_ms,avg_time_per_step_ms,final_mass_error,last_cells_modified,steps_run,final_max_slope_excess,kernel_mass_error";
+    for (int e = 0; e < PerfCounters::EventCount; ++e)
+        out << "," << PerfCounters::eventName(static_cast<PerfCounters::Event>(e));
+    out << ",ipc\n";
 
     for (std::size_t i = 0; i < runs.size(); ++i) {
         out << (i + 1) << ","
             << runs[i].totalTimeMs << ","
             << runs[i].avgTimePerStepMs << ","
             << runs[i].finalMassError << ","
-            << runs[i].lastCellsModified << "\n";
+            << runs[i].lastCellsModified << ","
+            << runs[i].stepsRun << ","
+            << runs[i].finalMaxSlopeExcess << ","
+            << runs[i].kernelMassError;
+
+        const PerfCounters::Sample& counters = runs[i].counters;
+        for (int e = 0; e < PerfCounters::EventCount; ++e) {
+            const PerfCounters::Event event = static_cast<PerfCounters::Event>(e);
+            out << ",";
+            write_optional(out, counters.has(event), counters.get(event));
+        }
+
+        out << ",";
+        write_optional(out, counters.ipc() >= 0.0, counters.ipc());
+        out << "\n";
     }
 }
 
@@ -165,7 +239,9 @@ void ValidationTest::write_summary_csv(const std::string& filepath,
                                        const SummaryStats& totalStats,
                                        const SummaryStats& avgStepStats,
                                        const SummaryStats& massErrorStats,
-                                       const SummaryStats& lastCellsStats)
+                                       const SummaryStats& lastCellsStats,
+                                       const SummaryStats& stepsRunStats,
+                                       const std::vector<std::pair<std::string, SummaryStats>>& counterStats)
 {
     std::ofstream out(filepath);
     out << "metric,n,mean,median,stddev,min,max,ci95_low,ci95_high\n";
@@ -209,9 +285,140 @@ void ValidationTest::write_summary_csv(const std::string& filepath,
         << lastCellsStats.max << ","
         << lastCellsStats.ci95Low << ","
         << lastCellsStats.ci95High << "\n";
+
+    out << "steps_run,"
+        << stepsRunStats.n << ","
+        << stepsRunStats.mean << ","
+        << stepsRunStats.median << ","
+        << stepsRunStats.stddev << ","
+        << stepsRunStats.min << ","
+        << stepsRunStats.max << ","
+        << stepsRunStats.ci95Low << ","
+        << stepsRunStats.ci95High << "\n";
+
+    for (const auto& [name, stats] : counterStats) {
+        out << name << ","
+            << stats.n << ","
+            << stats.mean << ","
+            << stats.median << ","
+            << stats.stddev << ","
+            << stats.min << ","
+            << stats.max << ","
+            << stats.ci95Low << ","
+            << stats.ci95High << "\n";
+    }
+}
+
+void ValidationTest::write_roofline_csv(const std::string& filepath,
+                                        const std::string& variantName,
+                                        const std::vector<RunMetrics>& runs,
+                                        double innerCells)
+{
+    // Octets lus en mémoire : un défaut de cache de dernier niveau par ligne de 64 octets
+    constexpr double cacheLineBytes = 64.0;
+
+    std::vector<double> ipc;
+    std::vector<double> bytesPerCell;
+    std::vector<double> intensity;
+    std::vector<double> gips;
+    std::vector<double> gbps;
+    std::vector<double> peakGips;
+
+    for (const RunMetrics& m : runs) {
+        const PerfCounters::Sample& c = m.counters;
+        const double seconds = m.totalTimeMs * 1e-3;
+
+        if (!c.has(PerfCounters::Cycles) || !c.has(PerfCounters::Instructions)
+            || !c.has(PerfCounters::LlcMisses) || seconds <= 0.0)
+            continue;
+
+        const double dramBytes = std::max(1.0, c.get(PerfCounters::LlcMisses) * cacheLineBytes);
+        const double instructions = c.get(PerfCounters::Instructions);
+
+        ipc.push_back(c.ipc());
+        bytesPerCell.push_back(dramBytes / (innerCells * m.stepsRun));
+        intensity.push_back(instructions / dramBytes);
+        gips.push_back(instructions / seconds * 1e-9);
+        gbps.push_back(dramBytes / seconds * 1e-9);
+        peakGips.push_back(NOMINAL_ISSUE_WIDTH * c.get(PerfCounters::Cycles) / seconds * 1e-9);
+    }
+
+    std::ofstream out(filepath);
+    out << "variant,runs,ipc,dram_bytes_per_cell,instructions_per_byte,achieved_gips,achieved_gbps,"
+           "peak_gips,stream_gbps,ridge_instructions_per_byte,bound\n";
+
+    out << variantName << "," << ipc.size() << ",";
+
+    if (ipc.empty() || machineBandwidth <= 0.0) {
+        out << ",,,,,," << machineBandwidth * 1e-9 << ",,unknown\n";
+        return;
+    }
+
+    // Médianes des runs mesurés ; le coude du roofline est le rapport
+    // entre le plafond de calcul et la bande passante mesurée
+    const double medianIntensity = compute_summary_stats(intensity).median;
+    const double medianPeak = compute_summary_stats(peakGips).median;
+    const double ridge = medianPeak * 1e9 / machineBandwidth;
+
+    out << compute_summary_stats(ipc).median << ","
+        << compute_summary_stats(bytesPerCell).median << ","
+        << medianIntensity << ","
+        << compute_summary_stats(gips).median << ","
+        << compute_summary_stats(gbps).median << ","
+        << medianPeak << ","
+        << machineBandwidth * 1e-9 << ","
+        << ridge << ","
+        << (medianIntensity < ridge ? "memory" : "compute") << "\n";
+}
+
+double ValidationTest::measure_memory_bandwidth()
+{
+    // Copie parallèle entre deux tampons de 128 Mo, plus grands que le
+    // dernier niveau de cache : meilleur débit lecture + écriture sur 3 essais
+    const std::ptrdiff_t n = static_cast<std::ptrdiff_t>(32) << 20;
+    std::vector<float> src(n, 1.0f);
+    std::vector<float> dst(n, 0.0f);
+
+    double best = 0.0;
+
+    for (int r = 0; r < 3; ++r) {
+        const auto t0 = std::chrono::high_resolution_clock::now();
+
+        #pragma omp parallel for schedule(static)
+        for (std::ptrdiff_t i = 0; i < n; ++i)
+            dst[i] = src[i];
+
+        const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t0).count();
+        if (seconds > 0.0)
+            best = std::max(best, 2.0 * sizeof(float) * static_cast<double>(n) / seconds);
+    }
+
+    return best;
+}
+
+std::string ValidationTest::thread_cpu_list(int threads)
+{
+    std::vector<int> cpus(threads, -1);
+
+    #pragma omp parallel num_threads(threads)
+    {
+#ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+#else
+        const int tid = 0;
+#endif
+#ifdef __linux__
+        cpus[tid] = sched_getcpu();
+#endif
+    }
+
+    std::ostringstream out;
+    for (int t = 0; t < threads; ++t)
+        out << (t ? ";" : "") << cpus[t];
+    return out.str();
 }
 
-void ValidationTest::run_variant_tests(std::unique_ptr<Terrain>& terrain,
+bool ValidationTest::run_variant_tests(std::unique_ptr<Terrain>& terrain,
                                        const std::vector<float>& referenceData,
                                        const std::string& terrainType,
                                        int steps,
@@ -241,6 +448,10 @@ void ValidationTest::run_variant_tests(std::unique_ptr<Terrain>& terrain,
 
     fs::path errorEvolutionFile = baseDir / "error_evolution_last_run.csv";
 
+    PerfCounters counters;
+    if (perfCountersEnabled && !counters.open())
+        std::cerr << "Compteurs matériels indisponibles (perf_event_open)\n";
+
     for (int run = 0; run < warmupRuns + measuredRuns; ++run)
     {
         const bool isWarmup = (run < warmupRuns);
@@ -267,27 +478,64 @@ void ValidationTest::run_variant_tests(std::unique_ptr<Terrain>& terrain,
             errorEvolutionOut << "step,error\n";
         }
 
+        const double initialMass = calculate_total_mass(initialData);
+
         using clock = std::chrono::high_resolution_clock;
+        counters.start();
         auto t0 = clock::now();
 
         float errorStep1 = 0.0f;
+        int stepsRun = 0;
+
+        // Bilan cumulé des noyaux (matière reçue - matière retirée) : total
+        // du run, et part accumulée depuis la dernière resommation
+        double kernelDriftTotal = 0.0;
+        double kernelDrift = 0.0;
+        double driftBaseline = initialMass;
 
         for (int i = 0; i < steps; ++i)
         {
             cellsModified[i] = run_one_step(erosion, variant);
-
-            const float currentError = test_mass_conservation(*terrain->getData());
-
-            if (i == 0) {
-                errorStep1 = currentError;
+            stepsRun = i + 1;
+
+            // Le noyau fournit son résidu : arrêt dès qu'il est sous le seuil
+            const bool converged = erosion.isConverged();
+
+            // Contrôle en O(1) à chaque pas ; la grille n'est resommée que
+            // tous les MASS_CHECK_INTERVAL pas ou si le bilan dérive
+            const double balance = erosion.getLastResidual().massBalance();
+            kernelDriftTotal += balance;
+            kernelDrift += balance;
+            const bool driftExceeded = std::abs(kernelDrift) >= TOLERANCE * driftBaseline;
+
+            if (i == 0 || i % MASS_CHECK_INTERVAL == 0 || i == steps - 1 || converged || driftExceeded) {
+                const double currentMass = calculate_total_mass(*terrain->getData());
+                const float currentError = static_cast<float>(MassReduction::relativeError(initialMass, currentMass));
+
+                // La somme complète devient la nouvelle référence : sans
+                // remise à zéro, chaque pas suivant déclencherait une
+                // resommation une fois le seuil franchi
+                if (driftExceeded) {
+                    kernelDrift = 0.0;
+                    driftBaseline = currentMass;
+                }
+
+                if (i == 0) {
+                    errorStep1 = currentError;
+                }
+
+                if (errorEvolutionOut.is_open()) {
+                    errorEvolutionOut << (i + 1) << "," << currentError << "\n";
+                }
             }
 
-            if (errorEvolutionOut.is_open() && (i % 100 == 0 || i == steps - 1)) {
-                errorEvolutionOut << (i + 1) << "," << currentError << "\n";
+            if (converged) {
+                break;
             }
         }
 
         auto t1 = clock::now();
+        const PerfCounters::Sample sample = counters.stop();
         const double totalMs =
             std::chrono::duration<double, std::milli>(t1 - t0).count();
 
@@ -296,9 +544,13 @@ void ValidationTest::run_variant_tests(std::unique_ptr<Terrain>& terrain,
         if (!isWarmup) {
             RunMetrics m;
             m.totalTimeMs = totalMs;
-            m.avgTimePerStepMs = totalMs / static_cast<double>(steps);
+            m.avgTimePerStepMs = totalMs / static_cast<double>(stepsRun);
             m.finalMassError = finalError;
-            m.lastCellsModified = cellsModified.back();
+            m.lastCellsModified = cellsModified[stepsRun - 1];
+            m.stepsRun = stepsRun;
+            m.finalMaxSlopeExcess = erosion.getLastResidual().maxSlopeExcess;
+            m.kernelMassError = static_cast<float>(std::abs(kernelDriftTotal) / initialMass);
+            m.counters = sample;
             measured.push_back(m);
 
             if (measured.size() == 1) {
@@ -318,30 +570,70 @@ void ValidationTest::run_variant_tests(std::unique_ptr<Terrain>& terrain,
     std::vector<double> avgStepTimes;
     std::vector<double> finalMassErrors;
     std::vector<double> lastCells;
+    std::vector<double> stepsRun;
 
     totalTimes.reserve(measured.size());
     avgStepTimes.reserve(measured.size());
     finalMassErrors.reserve(measured.size());
     lastCells.reserve(measured.size());
+    stepsRun.reserve(measured.size());
+
+    bool converged = !measured.empty();
+    float maxKernelMassError = 0.0f;
 
     for (const RunMetrics& m : measured) {
         totalTimes.push_back(m.totalTimeMs);
         avgStepTimes.push_back(m.avgTimePerStepMs);
         finalMassErrors.push_back(static_cast<double>(m.finalMassError));
         lastCells.push_back(static_cast<double>(m.lastCellsModified));
+        stepsRun.push_back(static_cast<double>(m.stepsRun));
+        maxKernelMassError = std::max(maxKernelMassError, m.kernelMassError);
+
+        if (m.stepsRun == steps && m.lastCellsModified != 0)
+            converged = false;
     }
 
     const SummaryStats totalStats = compute_summary_stats(totalTimes);
     const SummaryStats avgStepStats = compute_summary_stats(avgStepTimes);
     const SummaryStats massErrorStats = compute_summary_stats(finalMassErrors);
     const SummaryStats lastCellsStats = compute_summary_stats(lastCells);
+    const SummaryStats stepsRunStats = compute_summary_stats(stepsRun);
+
+    // Une ligne par compteur disponible, plus l'IPC
+    std::vector<std::pair<std::string, SummaryStats>> counterStats;
+    for (int e = 0; e < PerfCounters::EventCount; ++e) {
+        const PerfCounters::Event event = static_cast<PerfCounters::Event>(e);
+        std::vector<double> values;
+        for (const RunMetrics& m : measured) {
+            if (m.counters.has(event))
+                values.push_back(m.counters.get(event));
+        }
+        if (!values.empty())
+            counterStats.emplace_back(PerfCounters::eventName(event), compute_summary_stats(values));
+    }
+
+    std::vector<double> ipcValues;
+    for (const RunMetrics& m : measured) {
+        if (m.counters.ipc() >= 0.0)
+            ipcValues.push_back(m.counters.ipc());
+    }
+    if (!ipcValues.empty())
+        counterStats.emplace_back("ipc", compute_summary_stats(ipcValues));
 
     write_raw_runs_csv((baseDir / "raw_runs.csv").string(), measured);
     write_summary_csv((baseDir / "summary_stats.csv").string(),
                       totalStats,
                       avgStepStats,
                       massErrorStats,
-                      lastCellsStats);
+                      lastCellsStats,
+                      stepsRunStats,
+                      counterStats);
+
+    if (counters.isOpen()) {
+        const double innerCells = static_cast<double>(terrain->getTerrainWidth() - 2)
+                                * (terrain->getTerrainHeight() - 2);
+        write_roofline_csv((baseDir / "roofline.csv").string(), variantName, measured, innerCells);
+    }
 
     std::cout << "========================================\n";
     std::cout << "VARIANTE : " << variantName << "\n";
@@ -360,11 +652,18 @@ void ValidationTest::run_variant_tests(std::unique_ptr<Terrain>& terrain,
               << ", " << totalStats.ci95High << "]\n";
     std::cout << "Mean time / step (ms)      : " << avgStepStats.mean << "\n";
     std::cout << "Mean final mass error      : " << massErrorStats.mean << "\n";
+    std::cout << "Max kernel mass balance    : " << maxKernelMassError << "\n";
+    if (!ipcValues.empty())
+        std::cout << "Median IPC                 : " << compute_summary_stats(ipcValues).median << "\n";
     std::cout << "Conservation error step 1  : " << referenceErrorStep1 << "\n";
     std::cout << "Cells modified step 1      : " << referenceCellsStep1 << "\n";
     std::cout << "Mean last cells modified   : " << lastCellsStats.mean << "\n";
+    std::cout << "Mean steps run             : " << stepsRunStats.mean
+              << (converged ? " (convergé)" : "") << "\n";
     std::cout << "Dossier sortie             : " << baseDir << "\n";
     std::cout << "========================================\n";
+
+    return converged;
 }
 
 void ValidationTest::run_all_tests(std::unique_ptr<Terrain>& terrain,
@@ -378,15 +677,22 @@ void ValidationTest::run_all_tests(std::unique_ptr<Terrain>& terrain,
 
     const std::vector<float> referenceData = *terrain->getData();
 
+    if (perfCountersEnabled) {
+        machineBandwidth = measure_memory_bandwidth();
+        std::cout << "Bande passante mémoire mesurée : " << machineBandwidth * 1e-9 << " Go/s\n";
+    }
+
     const ThermalVariant baseVariants[] = {
         ThermalVariant::PureTwoPhase,
         ThermalVariant::BlockedPureTwoPhase,
         ThermalVariant::BlockedParallelPureTwoPhase
     };
 
+    bool allConverged = true;
+
     for (ThermalVariant variant : baseVariants) {
-        run_variant_tests(terrain, referenceData, terrainType, steps,
-                          variant, NeighborhoodMode::EightNeighbors);
+        allConverged &= run_variant_tests(terrain, referenceData, terrainType, steps,
+                                          variant, NeighborhoodMode::EightNeighbors);
     }
 
     const ThermalVariant fourNeighborVariants[] = {
@@ -400,7 +706,261 @@ void ValidationTest::run_all_tests(std::unique_ptr<Terrain>& terrain,
     };
 
     for (ThermalVariant variant : fourNeighborVariants) {
-        run_variant_tests(terrain, referenceData, terrainType, steps,
-                          variant, NeighborhoodMode::FourNeighbors);
+        allConverged &= run_variant_tests(terrain, referenceData, terrainType, steps,
+                                          variant, NeighborhoodMode::FourNeighbors);
+    }
+
+    run_multigrid_test(terrain, referenceData, terrainType, steps);
+
+    // Repère lu par validation/validation.sh : des steps plus grands
+    // donneraient le même résultat
+    if (allConverged)
+        std::cout << "Convergence atteinte en au plus " << steps << " pas pour toutes les variantes\n";
+}
+
+void ValidationTest::run_multigrid_test(std::unique_ptr<Terrain>& terrain,
+                                        const std::vector<float>& referenceData,
+                                        const std::string& terrainType,
+                                        int steps)
+{
+    namespace fs = std::filesystem;
+
+    fs::path baseDir = fs::path("./resultat")
+                     / terrainType
+                     / neighborhood_to_string(NeighborhoodMode::EightNeighbors)
+                     / "multigrid";
+    fs::create_directories(baseDir);
+
+    const int width = terrain->getTerrainWidth();
+    const int height = terrain->getTerrainHeight();
+
+    using clock = std::chrono::high_resolution_clock;
+
+    // Référence : pas deux phases sur la grille fine seule
+    *terrain->getData() = referenceData;
+    initialData = *terrain->getData();
+
+    ThermalErosion erosion;
+    erosion.loadTerrainInfo(terrain);
+    erosion.setTalusAngle(25.f);
+    erosion.setTransferRate(0.1f);
+    erosion.useEightNeighbors();
+
+    int plainCells = 0;
+    auto t0 = clock::now();
+    for (int i = 0; i < steps; ++i)
+        plainCells = erosion.stepBlockedParallelPureTwoPhase();
+    const double plainMs = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+    const float plainError = test_mass_conservation(*terrain->getData());
+
+    // Solveur multigrille
+    *terrain->getData() = referenceData;
+
+    MultigridThermalErosion solver;
+    solver.setTalusAngle(25.f);
+    solver.setTransferRate(0.1f);
+    solver.useEightNeighbors();
+
+    t0 = clock::now();
+    const int multigridCells = solver.solve(*terrain->getData(), width, height, MultigridSettings());
+    const double multigridMs = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+    const float multigridError = test_mass_conservation(*terrain->getData());
+
+    int validationPassed = 0;
+    if (multigridError < TOLERANCE)
+        ++validationPassed;
+    if (test_height_limits(*terrain->getData()))
+        ++validationPassed;
+
+    const std::vector<int>& levelSteps = solver.getLevelSteps();
+
+    std::ofstream out(baseDir / "comparison.csv");
+    out << "solver,total_time_ms,fine_steps,last_cells_modified,final_mass_error\n";
+    out << "blockedParallelPureTwoPhase," << plainMs << "," << steps << "," << plainCells << "," << plainError << "\n";
+    out << "multigrid," << multigridMs << "," << (levelSteps.empty() ? 0 : levelSteps[0]) << ","
+        << multigridCells << "," << multigridError << "\n";
+
+    std::cout << "========================================\n";
+    std::cout << "VARIANTE : multigrid\n";
+    std::cout << "Terrain  : " << terrainType << "\n";
+    std::cout << "Tests    : Passed " << validationPassed << " / 2\n";
+    std::cout << "Pas par niveau (fin -> grossier) :";
+    for (int levelStep : levelSteps)
+        std::cout << " " << levelStep;
+    std::cout << "\n";
+    std::cout << "Two-phase " << steps << " pas (ms)     : " << plainMs
+              << ", cells modified " << plainCells << ", mass error " << plainError << "\n";
+    std::cout << "Multigrid (ms)             : " << multigridMs
+              << ", cells modified " << multigridCells << ", mass error " << multigridError << "\n";
+    std::cout << "Dossier sortie             : " << baseDir << "\n";
+    std::cout << "========================================\n";
+
+    *terrain->getData() = referenceData;
+}
+void ValidationTest::run_scaling_tests(const std::function<std::unique_ptr<Terrain>(int)>& makeTerrain,
+                                       const std::string& terrainType,
+                                       int steps,
+                                       ScalingMode mode,
+                                       int size)
+{
+    namespace fs = std::filesystem;
+
+    const bool weak = (mode == ScalingMode::Weak);
+
+    // Côté par thread par défaut en mode faible : 512² cellules par thread
+    if (weak && size <= 0)
+        size = 512;
+
+#ifdef _OPENMP
+    const int maxThreads = omp_get_max_threads();
+#else
+    const int maxThreads = 1;
+#endif
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2)
+        threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    fs::path baseDir = fs::path("./resultat") / terrainType / "scaling";
+    fs::create_directories(baseDir);
+    const fs::path csvPath = baseDir / (weak ? "weak.csv" : "strong.csv");
+
+    const std::string procBind = env_or_unset("OMP_PROC_BIND");
+    const std::string places = env_or_unset("OMP_PLACES");
+    const int numaNodes = NumaPlacement::nodeCount();
+    const char* numaPolicy = NumaPlacement::policyName(NumaPlacement::getPolicy());
+
+    std::cout << "========================================\n";
+    std::cout << "PASSAGE A L'ECHELLE " << (weak ? "FAIBLE" : "FORT") << "\n";
+    std::cout << "Terrain        : " << terrainType << "\n";
+    std::cout << "Threads        : 1 -> " << maxThreads << "\n";
+    std::cout << "OMP_PROC_BIND  : " << procBind << "\n";
+    std::cout << "OMP_PLACES     : " << places << "\n";
+    std::cout << "Noeuds NUMA    : " << numaNodes << " (" << numaPolicy << ")\n";
+
+    struct ScaledVariant {
+        ThermalVariant variant;
+        NeighborhoodMode neighborhood;
+    };
+
+    const ScaledVariant variants[] = {
+        {ThermalVariant::BlockedParallelPureTwoPhase, NeighborhoodMode::EightNeighbors},
+        {ThermalVariant::BlockedParallelPureTwoPhase, NeighborhoodMode::FourNeighbors},
+        {ThermalVariant::CheckerboardInPlaceParallel, NeighborhoodMode::FourNeighbors}
+    };
+
+    // Les pas sont tous exécutés (pas d'arrêt sur convergence) pour que
+    // chaque nombre de threads fasse exactement le même travail
+    constexpr int warmupRuns = 1;
+    constexpr int measuredRuns = 5;
+
+    std::ofstream out(csvPath);
+    out << "variant,neighborhood,threads,width,height,cells,steps,median_time_ms,min_time_ms,"
+           "cells_per_s,speedup,efficiency,proc_bind,places,numa_nodes,numa_policy,thread_cpus\n";
+
+    std::unique_ptr<Terrain> terrain;
+    std::vector<float> referenceData;
+
+    if (!weak) {
+        terrain = makeTerrain(size);
+        if (!terrain || !terrain->getData() || terrain->getData()->empty()) {
+            std::cerr << "Erreur : terrain invalide dans run_scaling_tests.\n";
+            return;
+        }
+        referenceData = *terrain->getData();
     }
-}
\ No newline at end of file
+
+    for (const ScaledVariant& scaled : variants) {
+        const std::string variantName = variant_to_string(scaled.variant);
+        const std::string neighborhoodName = neighborhood_to_string(scaled.neighborhood);
+
+        double baseCellsPerSecond = 0.0;
+
+        for (int threads : threadCounts) {
+            if (weak) {
+                const int side = static_cast<int>(std::lround(size * std::sqrt(static_cast<double>(threads))));
+                terrain = makeTerrain(side);
+                if (!terrain || !terrain->getData() || terrain->getData()->empty()) {
+                    std::cerr << "Erreur : terrain invalide dans run_scaling_tests.\n";
+                    return;
+                }
+                referenceData = *terrain->getData();
+            }
+
+            // Certains générateurs arrondissent le côté demandé (2^n + 1) :
+            // le débit est rapporté aux cellules réellement traitées
+            const int width = terrain->getTerrainWidth();
+            const int height = terrain->getTerrainHeight();
+            const double innerCells = static_cast<double>(width - 2) * (height - 2);
+
+            set_omp_threads(threads);
+            const std::string cpus = thread_cpu_list(threads);
+
+            std::vector<double> times;
+            times.reserve(measuredRuns);
+
+            for (int run = 0; run < warmupRuns + measuredRuns; ++run) {
+                *terrain->getData() = referenceData;
+
+                ThermalErosion erosion;
+                erosion.loadTerrainInfo(terrain);
+                erosion.setTalusAngle(25.f);
+                erosion.setTransferRate(0.1f);
+
+                if (scaled.neighborhood == NeighborhoodMode::FourNeighbors)
+                    erosion.useFourNeighbors();
+                else
+                    erosion.useEightNeighbors();
+
+                const auto t0 = std::chrono::high_resolution_clock::now();
+                for (int i = 0; i < steps; ++i)
+                    run_one_step(erosion, scaled.variant);
+                const double ms =
+                    std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+
+                if (run >= warmupRuns)
+                    times.push_back(ms);
+            }
+
+            const SummaryStats stats = compute_summary_stats(times);
+            const double cellsPerSecond = (stats.median > 0.0)
+                                        ? innerCells * steps / (stats.median * 1e-3)
+                                        : 0.0;
+
+            // Fort : accélération classique T1 / Tn. Faible : accélération
+            // à taille croissante, même rapport de débits (cellules/s)
+            if (threads == 1)
+                baseCellsPerSecond = cellsPerSecond;
+            const double speedup = (baseCellsPerSecond > 0.0) ? cellsPerSecond / baseCellsPerSecond : 0.0;
+            const double efficiency = speedup / threads;
+
+            out << variantName << ","
+                << neighborhoodName << ","
+                << threads << ","
+                << width << ","
+                << height << ","
+                << innerCells << ","
+                << steps << ","
+                << stats.median << ","
+                << stats.min << ","
+                << cellsPerSecond << ","
+                << speedup << ","
+                << efficiency << ","
+                << "\"" << procBind << "\","
+                << "\"" << places << "\","
+                << numaNodes << ","
+                << numaPolicy << ","
+                << cpus << "\n";
+
+            std::cout << variantName << " (" << neighborhoodName << "), " << threads << " thread(s), "
+                      << width << "x" << height << " : " << stats.median << " ms, x" << speedup
+                      << ", efficacité " << efficiency << "\n";
+        }
+    }
+
+    set_omp_threads(maxThreads);
+
+    std::cout << "Fichier sortie : " << csvPath << "\n";
+    std::cout << "========================================\n";
+}
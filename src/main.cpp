@@ -3,6 +3,11 @@
 #include "TerrainApp.hpp"
 #include "ValidationTest.hpp"
 #include "ThermalErosion.hpp"
+#include "TiledHeightField.hpp"
+#include "TiledThermalErosion.hpp"
+#include "BatchRunner.hpp"
+#include "PerlinNoiseTerrain.hpp"
+#include <algorithm>
 #include <map>
 #include <string>
 #include <memory>
@@ -13,25 +18,21 @@
 enum class State{
     Render,
     Test,
-};
-
-enum class Heightmap{
-    LoadHeightmap, 
-    FaultFormation, 
-    MidpointDisplacement, 
-    PerlinNoise
+    Convert,
+    Tiled,
+    Run,
+    NoiseBench,
+    Scaling,
 };
 
 std::map<std::string, State> dicState{
     {"render", State::Render},
-    {"test", State::Test}
-};
-
-std::map<std::string, Heightmap> dicHeightmap{
-    {"loadHeightmap", Heightmap::LoadHeightmap},
-    {"faultFormation", Heightmap::FaultFormation},
-    {"midpointDisplacement", Heightmap::MidpointDisplacement},
-    {"perlinNoise", Heightmap::PerlinNoise}
+    {"test", State::Test},
+    {"convert", State::Convert},
+    {"tiled", State::Tiled},
+    {"run", State::Run},
+    {"noisebench", State::NoiseBench},
+    {"scaling", State::Scaling}
 };
 
 int main(int argc, char const *argv[])
@@ -47,60 +48,183 @@ int main(int argc, char const *argv[])
 
         if (argc < 4) {
             std::cerr << "Usage: " << argv[0]
-                      << " test <typeTerrain> <steps>\n";
+                      << " test <typeTerrain> <steps> [seed] [perf]\n";
             std::cerr << "<typeTerrain> : loadHeightmap | faultFormation | midpointDisplacement | perlinNoise\n";
             return 1;
         }
 
         std::string terrainType = argv[2];
         int steps = std::atoi(argv[3]);
+        uint32_t seed = 1;
+
+        // Arguments optionnels : graine et/ou "perf" (compteurs matériels)
+        for (int a = 4; a < argc; ++a) {
+            if (std::string(argv[a]) == "perf")
+                ValidationTest::enable_perf_counters(true);
+            else
+                seed = static_cast<uint32_t>(std::strtoul(argv[a], nullptr, 10));
+        }
 
         if (steps <= 0) {
             std::cerr << "Erreur: steps doit être strictement positif\n";
             return 1;
         }
 
-        switch (dicHeightmap[terrainType])
-        {
-        case Heightmap::LoadHeightmap:
-            terrain = std::make_unique<Terrain>();
-            terrain->loadTerrain("../src/heightmap/iceland_heightmap.png", 1.0f, 100.0f);
-            break;
-
-        case Heightmap::FaultFormation:
-        {
-            auto generator = std::make_unique<FaultFormationTerrain>();
-            generator->CreateFaultFormation(2048, 2048, 1000, 0, 255, 1);
-            terrain = std::move(generator);
-            break;
+        terrain = BatchRunner::createTerrain(terrainType, 0, seed);
+        if (!terrain)
+            return 1;
+
+        ValidationTest::run_all_tests(terrain, terrainType, steps);
+    }
+    else if (State::Scaling == dicState[argv[1]]) {
+
+        const std::string mode = (argc > 2) ? argv[2] : "";
+
+        if (argc < 5 || (mode != "strong" && mode != "weak")) {
+            std::cerr << "Usage: " << argv[0]
+                      << " scaling <strong|weak> <typeTerrain> <steps> [taille] [seed]\n";
+            std::cerr << "[taille] : côté du terrain (strong) ou côté par thread (weak)\n";
+            return 1;
         }
 
-        case Heightmap::MidpointDisplacement:
-        {
-            auto generator = std::make_unique<MidpointDisplacement>();
-            generator->CreateMidpointDisplacement(std::pow(2, 11) + 1, 0, 255, 1, 0.5);
-            terrain = std::move(generator);
-            break;
+        const std::string terrainType = argv[3];
+        const int steps = std::atoi(argv[4]);
+        const int size = (argc > 5) ? std::atoi(argv[5]) : 0;
+        const uint32_t seed = (argc > 6) ? static_cast<uint32_t>(std::strtoul(argv[6], nullptr, 10)) : 1;
+
+        if (steps <= 0) {
+            std::cerr << "Erreur: steps doit être strictement positif\n";
+            return 1;
         }
 
-        case Heightmap::PerlinNoise:
-        {
-            auto generator = std::make_unique<PerlinNoiseTerrain>();
-            generator->CreatePerlinNoise(5000, 5000, 0, 255, 1, 0.005);
-            terrain = std::move(generator);
-            break;
+        auto makeTerrain = [&](int side) {
+            return BatchRunner::createTerrain(terrainType, side, seed);
+        };
+
+        ValidationTest::run_scaling_tests(makeTerrain, terrainType, steps,
+                                          mode == "weak" ? ValidationTest::ScalingMode::Weak
+                                                         : ValidationTest::ScalingMode::Strong,
+                                          size);
+    }
+    else if (State::Convert == dicState[argv[1]]) {
+
+        if (argc < 4) {
+            std::cerr << "Usage: " << argv[0]
+                      << " convert <heightmap.png> <sortie.tiles> [tileSize] [float|uint16]\n";
+            return 1;
         }
 
-        default:
-            std::cerr << "Heightmap non prise en charge" << std::endl;
+        const int tileSize = (argc > 4) ? std::atoi(argv[4]) : 256;
+        const TileFormat format = (argc > 5 && std::string(argv[5]) == "uint16")
+                                ? TileFormat::UInt16
+                                : TileFormat::Float32;
+
+        if (!TiledHeightField::convertFromPng(argv[2], argv[3], tileSize, format))
+            return 1;
+    }
+    else if (State::Tiled == dicState[argv[1]]) {
+
+        if (argc < 4) {
+            std::cerr << "Usage: " << argv[0] << " tiled <terrain.tiles> <steps> [cacheTiles]\n";
             return 1;
         }
 
-        ValidationTest::run_all_tests(terrain, terrainType, steps);
+        const int steps = std::atoi(argv[3]);
+        const int cacheTiles = (argc > 4) ? std::atoi(argv[4]) : 256;
+
+        TiledHeightField field;
+        if (!field.open(argv[2]))
+            return 1;
+
+        TileCache cache(field, cacheTiles);
+        TiledThermalErosion erosion(field, cache);
+        erosion.setTalusAngle(25.f);
+        erosion.setTransferRate(0.1f);
+
+        for (int i = 0; i < steps; ++i) {
+            const long long changes = erosion.step();
+            if (changes < 0)
+                return 1;
+            std::cout << "step " << (i + 1) << " : " << changes << " cellules modifiees\n";
+        }
+
+        std::cout << "Cache : " << cache.getHits() << " hits, " << cache.getMisses() << " misses\n";
+    }
+    else if (State::Run == dicState[argv[1]]) {
+
+        std::vector<BatchConfig> jobs;
+        int concurrentJobs = 1;
+
+        if (!BatchRunner::parseArguments(std::vector<std::string>(argv + 2, argv + argc), jobs, concurrentJobs)) {
+            BatchRunner::printUsage(argv[0]);
+            return 1;
+        }
+
+        if (!BatchRunner::runAll(jobs, concurrentJobs))
+            return 1;
+    }
+    else if (State::NoiseBench == dicState[argv[1]]) {
+
+        // Configuration par défaut du générateur perlinNoise (BatchRunner::createTerrain)
+        const int size = (argc > 2) ? std::atoi(argv[2]) : 5000;
+        const int octaves = (argc > 3) ? std::atoi(argv[3]) : 4;
+        const int repeats = (argc > 4) ? std::max(1, std::atoi(argv[4])) : 5;
+
+        if (size <= 0 || octaves <= 0) {
+            std::cerr << "Usage: " << argv[0] << " noisebench [taille] [octaves] [repetitions]\n";
+            return 1;
+        }
+
+        struct Variant {
+            const char *name;
+            PerlinNoiseTerrain::NoiseKernel kernel;
+            PerlinNoiseTerrain::NoiseType type;
+            bool warp;
+        };
+
+        const Variant variants[] = {
+            {"fBm scalaire", PerlinNoiseTerrain::NoiseKernel::Scalar, PerlinNoiseTerrain::NoiseType::FBm, false},
+            {"fBm vectoriel", PerlinNoiseTerrain::NoiseKernel::Vectorized, PerlinNoiseTerrain::NoiseType::FBm, false},
+            {"ridged", PerlinNoiseTerrain::NoiseKernel::Vectorized, PerlinNoiseTerrain::NoiseType::Ridged, false},
+            {"hybride", PerlinNoiseTerrain::NoiseKernel::Vectorized, PerlinNoiseTerrain::NoiseType::Hybrid, false},
+            {"fBm + warp", PerlinNoiseTerrain::NoiseKernel::Vectorized, PerlinNoiseTerrain::NoiseType::FBm, true},
+            {"ridged + warp", PerlinNoiseTerrain::NoiseKernel::Vectorized, PerlinNoiseTerrain::NoiseType::Ridged, true}
+        };
+
+        double scalarBest = 0.0;
+
+        for (const Variant &variant : variants) {
+            double sum = 0.0;
+            double best = 0.0;
+
+            for (int r = 0; r < repeats; ++r) {
+                PerlinNoiseTerrain perlin;
+                perlin.SetNoiseKernel(variant.kernel);
+                perlin.SetNoiseType(variant.type);
+                perlin.SetDomainWarp(variant.warp);
+                perlin.CreatePerlinNoise(size, size, 0, 255, 1, 0.005f, octaves);
+
+                const double ms = perlin.GetNoiseTimeMs();
+                sum += ms;
+                best = (r == 0) ? ms : std::min(best, ms);
+            }
+
+            if (variant.kernel == PerlinNoiseTerrain::NoiseKernel::Scalar)
+                scalarBest = best;
+
+            const double samples = static_cast<double>(size) * size * octaves;
+            std::cout << variant.name << " : min " << best << " ms, moyenne " << sum / repeats << " ms, "
+                      << samples / (best * 1e3) << " Méch/s, x" << scalarBest / best << " / fBm scalaire\n";
+        }
     }
     else {
         std::cout << "Usage: " << argv[0] << " render\n";
-        std::cout << "Usage: " << argv[0] << " test <typeTerrain> <steps>\n";
+        std::cout << "Usage: " << argv[0] << " test <typeTerrain> <steps> [seed] [perf]\n";
+        std::cout << "Usage: " << argv[0] << " scaling <strong|weak> <typeTerrain> <steps> [taille] [seed]\n";
+        std::cout << "Usage: " << argv[0] << " convert <heightmap.png> <sortie.tiles> [tileSize] [float|uint16]\n";
+        std::cout << "Usage: " << argv[0] << " tiled <terrain.tiles> <steps> [cacheTiles]\n";
+        std::cout << "Usage: " << argv[0] << " run [--config <fichier>] [--<clé> <valeur> ...]\n";
+        std::cout << "Usage: " << argv[0] << " noisebench [taille] [octaves] [repetitions]\n";
         std::cout << "<typeTerrain> : loadHeightmap | faultFormation | midpointDisplacement | perlinNoise\n";
     }
 
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "BatchRunner.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+TEST(BatchRunnerTest, SweepExpandsIntoCartesianProduct) {
+    std::vector<BatchConfig> jobs;
+    int concurrentJobs = 0;
+
+    ASSERT_TRUE(BatchRunner::parseArguments({"--steps", "10", "--size", "64, 128", "--talus", "20,30",
+                                             "--jobs", "2", "--threads", "3", "--output", "out"},
+                                            jobs, concurrentJobs));
+
+    ASSERT_EQ(jobs.size(), 4u);
+    EXPECT_EQ(concurrentJobs, 2);
+
+    // Les clés sont développées dans l'ordre où elles apparaissent : size puis talus
+    const int sizes[] = {64, 64, 128, 128};
+    const float taluses[] = {20.f, 30.f, 20.f, 30.f};
+    const char* labels[] = {"job000_size64_talus20", "job001_size64_talus30",
+                            "job002_size128_talus20", "job003_size128_talus30"};
+
+    for (std::size_t j = 0; j < jobs.size(); ++j) {
+        EXPECT_EQ(jobs[j].steps, 10);
+        EXPECT_EQ(jobs[j].size, sizes[j]);
+        EXPECT_FLOAT_EQ(jobs[j].talusAngle, taluses[j]);
+        EXPECT_EQ(jobs[j].threads, 3);
+        EXPECT_EQ(jobs[j].label, labels[j]);
+
+        // Un dossier par job, checkpoints activés par défaut avec --output
+        EXPECT_EQ(jobs[j].outputDir, (std::filesystem::path("out") / labels[j]).string());
+        EXPECT_EQ(jobs[j].checkpointInterval, 100);
+        EXPECT_EQ(jobs[j].checkpointDir, (std::filesystem::path(jobs[j].outputDir) / "checkpoints").string());
+    }
+}
+
+TEST(BatchRunnerTest, SingleValueListsKeepOneJob) {
+    std::vector<BatchConfig> jobs;
+    int concurrentJobs = 0;
+
+    ASSERT_TRUE(BatchRunner::parseArguments({"--steps", "5", "--generator", "faultFormation", "--seed", "7,"},
+                                            jobs, concurrentJobs));
+
+    ASSERT_EQ(jobs.size(), 1u);
+    EXPECT_EQ(concurrentJobs, 1);
+    EXPECT_EQ(jobs[0].label, "run");
+    EXPECT_EQ(jobs[0].seed, 7u);
+    EXPECT_EQ(jobs[0].metadata.generator, 1u);
+    EXPECT_EQ(jobs[0].metadata.seed, 7u);
+    EXPECT_EQ(jobs[0].checkpointInterval, 0);
+    EXPECT_TRUE(jobs[0].outputDir.empty());
+    EXPECT_GE(jobs[0].threads, 1);
+}
+
+TEST(BatchRunnerTest, RejectsInvalidSweepSpecs) {
+    std::vector<BatchConfig> jobs;
+    int concurrentJobs = 0;
+
+    // --steps manquant ou nul
+    EXPECT_FALSE(BatchRunner::parseArguments({"--size", "64"}, jobs, concurrentJobs));
+    EXPECT_FALSE(BatchRunner::parseArguments({"--steps", "0"}, jobs, concurrentJobs));
+    // Une valeur invalide dans une liste rejette tout le balayage
+    EXPECT_FALSE(BatchRunner::parseArguments({"--steps", "10", "--neighbors", "4,5"}, jobs, concurrentJobs));
+    EXPECT_FALSE(BatchRunner::parseArguments({"--steps", "10", "--rate", "0.1,abc"}, jobs, concurrentJobs));
+    EXPECT_FALSE(BatchRunner::parseArguments({"--steps", "10", "--generator", "unknown"}, jobs, concurrentJobs));
+    // Liste vide, option sans valeur, option inconnue
+    EXPECT_FALSE(BatchRunner::parseArguments({"--steps", "10", "--size", ","}, jobs, concurrentJobs));
+    EXPECT_FALSE(BatchRunner::parseArguments({"--steps"}, jobs, concurrentJobs));
+    EXPECT_FALSE(BatchRunner::parseArguments({"--steps", "10", "--colour", "red"}, jobs, concurrentJobs));
+    // threads n'est pas une clé de balayage
+    EXPECT_FALSE(BatchRunner::parseArguments({"--steps", "10", "--threads", "1,2"}, jobs, concurrentJobs));
+}
+
+TEST(BatchRunnerTest, CommandLineOverridesConfigFile) {
+    const std::string path = "test_batch_config.txt";
+    {
+        std::ofstream out(path);
+        out << "# balayage de base\n";
+        out << "steps = 20\n";
+        out << "size = 32, 64   # deux tailles\n";
+        out << "neighbors = 4\n";
+    }
+
+    std::vector<BatchConfig> jobs;
+    int concurrentJobs = 0;
+
+    ASSERT_TRUE(BatchRunner::parseArguments({"--config", path}, jobs, concurrentJobs));
+    ASSERT_EQ(jobs.size(), 2u);
+    EXPECT_EQ(jobs[1].size, 64);
+    EXPECT_EQ(jobs[1].neighborCount, 4);
+
+    ASSERT_TRUE(BatchRunner::parseArguments({"--config", path, "--size", "16", "--steps", "3"}, jobs, concurrentJobs));
+    ASSERT_EQ(jobs.size(), 1u);
+    EXPECT_EQ(jobs[0].size, 16);
+    EXPECT_EQ(jobs[0].steps, 3);
+    EXPECT_EQ(jobs[0].neighborCount, 4);
+
+    std::remove(path.c_str());
+}
+
+TEST(BatchRunnerTest, LabelsStaySortedPastThreeDigits) {
+    std::vector<BatchConfig> jobs;
+    int concurrentJobs = 0;
+
+    // 2 x 3 x 4 x 50 = 1200 jobs
+    std::string seeds;
+    for (int s = 1; s <= 50; ++s)
+        seeds += std::to_string(s) + ",";
+
+    ASSERT_TRUE(BatchRunner::parseArguments({"--steps", "1", "--neighbors", "4,8", "--talus", "20,25,30",
+                                             "--rate", "0.1,0.2,0.3,0.4", "--seed", seeds},
+                                            jobs, concurrentJobs));
+
+    ASSERT_EQ(jobs.size(), 1200u);
+    EXPECT_EQ(jobs[7].label.substr(0, 7), "job007_");
+    EXPECT_EQ(jobs[999].label.substr(0, 7), "job999_");
+    EXPECT_EQ(jobs[1000].label.substr(0, 8), "job1000_");
+}
@@ -0,0 +1,374 @@
+#include <gtest/gtest.h>
+#include "FaultFormationTerrain.hpp"
+#include "MidpointDisplacement.hpp"
+#include "PerlinNoiseTerrain.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST(FaultFormationTest, RowEventsMatchFullSweep) {
+    const int width = 157;
+    const int height = 93;
+    const float minHeight = 0.0f;
+    const float maxHeight = 255.0f;
+
+    for (uint32_t seed : {1u, 42u}) {
+        FaultFormationTerrain sweep;
+        sweep.setSeed(seed);
+        sweep.SetFaultMode(FaultFormationTerrain::FaultMode::FullSweep);
+        sweep.CreateFaultFormation(width, height, 300, minHeight, maxHeight);
+
+        FaultFormationTerrain events;
+        events.setSeed(seed);
+        events.SetFaultMode(FaultFormationTerrain::FaultMode::RowEvents);
+        events.CreateFaultFormation(width, height, 300, minHeight, maxHeight);
+
+        const std::vector<float>& expected = *sweep.getData();
+        const std::vector<float>& actual = *events.getData();
+        ASSERT_EQ(actual.size(), expected.size());
+
+        // Mêmes cellules déplacées ; RowEvents cumule en double, seuls les
+        // derniers bits des hauteurs normalisées peuvent différer
+        for (std::size_t i = 0; i < expected.size(); ++i)
+            ASSERT_NEAR(actual[i], expected[i], 1e-5f * (maxHeight - minHeight)) << "graine " << seed << ", cellule " << i;
+
+        EXPECT_FLOAT_EQ(*std::min_element(actual.begin(), actual.end()), minHeight);
+        EXPECT_FLOAT_EQ(*std::max_element(actual.begin(), actual.end()), maxHeight);
+    }
+}
+
+namespace
+{
+// Filtre FIR d'origine : quatre passes séquentielles en place, lignes puis colonnes
+void referenceFIR(std::vector<float>& data, int width, int height, float filter)
+{
+    for (int z = 0; z < height; ++z) {
+        float* row = &data[static_cast<std::size_t>(z) * width];
+
+        float prev = row[0];
+        for (int x = 1; x < width; ++x) {
+            row[x] = filter * prev + (1.0f - filter) * row[x];
+            prev = row[x];
+        }
+
+        prev = row[width - 1];
+        for (int x = width - 2; x >= 0; --x) {
+            row[x] = filter * prev + (1.0f - filter) * row[x];
+            prev = row[x];
+        }
+    }
+
+    for (int x = 0; x < width; ++x) {
+        float prev = data[x];
+        for (int z = 1; z < height; ++z) {
+            float& cell = data[static_cast<std::size_t>(z) * width + x];
+            cell = filter * prev + (1.0f - filter) * cell;
+            prev = cell;
+        }
+
+        prev = data[static_cast<std::size_t>(height - 1) * width + x];
+        for (int z = height - 2; z >= 0; --z) {
+            float& cell = data[static_cast<std::size_t>(z) * width + x];
+            cell = filter * prev + (1.0f - filter) * cell;
+            prev = cell;
+        }
+    }
+}
+} // namespace
+
+TEST(FaultFormationTest, StripFilterMatchesBaselinePassOrder) {
+    // Largeur hors multiple de FIR_STRIP_WIDTH : la dernière bande est partielle
+    const int width = 300;
+    const int height = 70;
+    const float minHeight = 0.0f;
+    const float maxHeight = 255.0f;
+    const float filter = 0.6f;
+
+    FaultFormationTerrain raw;
+    raw.setSeed(11);
+    raw.CreateFaultFormation(width, height, 150, minHeight, maxHeight);
+
+    FaultFormationTerrain filtered;
+    filtered.setSeed(11);
+    filtered.CreateFaultFormation(width, height, 150, minHeight, maxHeight, 1.0f, true, filter);
+
+    // Le filtre conserve les transformations affines : filtrer la grille
+    // normalisée puis la renormaliser donne la grille filtrée normalisée
+    std::vector<float> expected = *raw.getData();
+    referenceFIR(expected, width, height, filter);
+
+    const auto [lo, hi] = std::minmax_element(expected.begin(), expected.end());
+    const float low = *lo;
+    const float scale = (maxHeight - minHeight) / (*hi - low);
+    for (float& h : expected)
+        h = (h - low) * scale + minHeight;
+
+    const std::vector<float>& actual = *filtered.getData();
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+        ASSERT_NEAR(actual[i], expected[i], 1e-4f * (maxHeight - minHeight)) << "cellule " << i;
+}
+
+TEST(MidpointDisplacementTest, RegionsMatchFullGeneration) {
+    const int size = 129;
+    const float roughness = 1.0f;
+    const uint32_t seed = 5;
+
+    // Terrain complet par l'algorithme récursif, normalisé par ses extrêmes
+    MidpointDisplacement terrain;
+    terrain.setSeed(seed);
+    terrain.CreateMidpointDisplacement(size, 0.0f, 255.0f, 1.0f, roughness);
+    const std::vector<float>& full = *terrain.getData();
+
+    std::vector<float> raw;
+    ASSERT_TRUE(MidpointDisplacement::GenerateRegion(seed, size, roughness, 0, 0, size, size, raw));
+    ASSERT_EQ(raw.size(), full.size());
+
+    const auto [lo, hi] = std::minmax_element(raw.begin(), raw.end());
+    const float rawMin = *lo;
+    const float scale = 255.0f / (*hi - rawMin);
+    for (std::size_t i = 0; i < raw.size(); ++i)
+        ASSERT_NEAR((raw[i] - rawMin) * scale, full[i], 1e-3f) << "cellule " << i;
+
+    // Sous-régions aléatoires de plusieurs tailles, bords compris
+    std::mt19937 rng(1234);
+    const int extents[][2] = {{1, 1}, {7, 13}, {32, 32}, {33, 5}, {64, 64}, {129, 17}};
+    for (const auto& extent : extents) {
+        const int w = extent[0];
+        const int h = extent[1];
+        for (int trial = 0; trial < 4; ++trial) {
+            const int x0 = std::uniform_int_distribution<int>(0, size - w)(rng);
+            const int z0 = std::uniform_int_distribution<int>(0, size - h)(rng);
+
+            std::vector<float> region;
+            ASSERT_TRUE(MidpointDisplacement::GenerateRegion(seed, size, roughness, x0, z0, w, h, region));
+            ASSERT_EQ(region.size(), static_cast<std::size_t>(w) * h);
+
+            for (int z = 0; z < h; ++z)
+                for (int x = 0; x < w; ++x)
+                    ASSERT_EQ(region[z * w + x], raw[(z0 + z) * size + x0 + x])
+                        << w << "x" << h << " en (" << x0 << ", " << z0 << "), cellule (" << x << ", " << z << ")";
+        }
+    }
+
+    std::vector<float> region;
+    EXPECT_FALSE(MidpointDisplacement::GenerateRegion(seed, size, roughness, size - 4, 0, 8, 8, region));
+    EXPECT_FALSE(MidpointDisplacement::GenerateRegion(seed, 100, roughness, 0, 0, 8, 8, region));
+}
+
+TEST(MidpointDisplacementTest, RegionTerrainUsesTheoreticalBound) {
+    const int size = 65;
+    const float roughness = 0.8f;
+
+    std::vector<float> raw;
+    ASSERT_TRUE(MidpointDisplacement::GenerateRegion(9, size, roughness, 16, 8, 40, 24, raw));
+
+    MidpointDisplacement tile;
+    tile.setSeed(9);
+    tile.CreateMidpointDisplacementRegion(size, 16, 8, 40, 24, 10.0f, 90.0f, 1.0f, roughness);
+    ASSERT_EQ(tile.getData()->size(), raw.size());
+
+    const float bound = MidpointDisplacement::MaxDisplacement(size, roughness);
+    for (std::size_t i = 0; i < raw.size(); ++i) {
+        const float h = (*tile.getData())[i];
+        ASSERT_NEAR(h, (raw[i] + bound) / (2.0f * bound) * 80.0f + 10.0f, 1e-3f) << "cellule " << i;
+        ASSERT_GE(h, 10.0f);
+        ASSERT_LE(h, 90.0f);
+    }
+}
+
+namespace
+{
+// Variantes couvertes par GenerateRegion : fBm, multifractales et domaine déformé
+std::vector<PerlinNoiseTerrain::NoiseParams> noiseVariants()
+{
+    PerlinNoiseTerrain::NoiseParams fbm;
+    fbm.seed = 3;
+    fbm.frequency = 0.02f;
+    fbm.octaves = 5;
+
+    PerlinNoiseTerrain::NoiseParams ridged = fbm;
+    ridged.type = PerlinNoiseTerrain::NoiseType::Ridged;
+
+    PerlinNoiseTerrain::NoiseParams hybrid = fbm;
+    hybrid.type = PerlinNoiseTerrain::NoiseType::Hybrid;
+    hybrid.offset = 0.7f;
+
+    PerlinNoiseTerrain::NoiseParams warped = fbm;
+    warped.warp = true;
+    warped.warpStrength = 2.0f;
+
+    return {fbm, ridged, hybrid, warped};
+}
+} // namespace
+
+TEST(PerlinNoiseTest, RegionsMatchFullGeneration) {
+    const int width = 150;
+    const int height = 90;
+
+    for (const PerlinNoiseTerrain::NoiseParams& params : noiseVariants()) {
+        PerlinNoiseTerrain terrain;
+        terrain.setSeed(params.seed);
+        terrain.SetNoiseType(params.type, params.offset, params.gain);
+        terrain.SetDomainWarp(params.warp, params.warpStrength);
+        terrain.CreatePerlinNoise(width, height, 0.0f, 255.0f, 1.0f,
+                                  params.frequency, params.octaves, params.persistence, params.lacunarity);
+        const std::vector<float>& full = *terrain.getData();
+
+        std::vector<float> raw(static_cast<std::size_t>(width) * height);
+        PerlinNoiseTerrain::GenerateRegion(params, 0, 0, width, height, raw.data());
+
+        // Le terrain complet est normalisé par ses extrêmes observés
+        const auto [lo, hi] = std::minmax_element(raw.begin(), raw.end());
+        const float rawMin = *lo;
+        const float scale = 255.0f / (*hi - rawMin);
+        for (std::size_t i = 0; i < raw.size(); ++i)
+            ASSERT_NEAR((raw[i] - rawMin) * scale, full[i], 1e-3f) << "type " << static_cast<int>(params.type) << ", cellule " << i;
+
+        // Fenêtres de largeurs hors multiple de NOISE_BATCH : les lots ne
+        // commencent pas aux mêmes colonnes que dans la grille complète
+        const int windows[][4] = {{0, 0, 1, 1}, {5, 3, 17, 9}, {37, 50, 64, 40}, {149, 0, 1, 90}, {100, 71, 50, 19}};
+        for (const auto& window : windows) {
+            const int x0 = window[0];
+            const int z0 = window[1];
+            const int w = window[2];
+            const int h = window[3];
+
+            std::vector<float> region(static_cast<std::size_t>(w) * h);
+            PerlinNoiseTerrain::GenerateRegion(params, x0, z0, w, h, region.data());
+
+            for (int z = 0; z < h; ++z)
+                for (int x = 0; x < w; ++x)
+                    ASSERT_NEAR(region[z * w + x], raw[(z0 + z) * width + x0 + x], 1e-6f)
+                        << "fenêtre (" << x0 << ", " << z0 << "), cellule (" << x << ", " << z << ")";
+        }
+    }
+}
+
+TEST(PerlinNoiseTest, RegionsStayWithinOutputRange) {
+    for (const PerlinNoiseTerrain::NoiseParams& params : noiseVariants()) {
+        float low = 0.0f;
+        float high = 0.0f;
+        PerlinNoiseTerrain::OutputRange(params, low, high);
+        ASSERT_LT(low, high);
+
+        // Régions éloignées de l'origine, coordonnées négatives comprises
+        const int origins[][2] = {{0, 0}, {-300, -170}, {5000, -4000}, {-70000, 90000}};
+        for (const auto& origin : origins) {
+            std::vector<float> region(64 * 64);
+            PerlinNoiseTerrain::GenerateRegion(params, origin[0], origin[1], 64, 64, region.data());
+
+            for (std::size_t i = 0; i < region.size(); ++i) {
+                ASSERT_GE(region[i], low) << "type " << static_cast<int>(params.type) << ", cellule " << i;
+                ASSERT_LE(region[i], high) << "type " << static_cast<int>(params.type) << ", cellule " << i;
+            }
+        }
+    }
+}
+
+namespace
+{
+// Pipeline fBm d'avant les variantes templatées : octaves à l'extérieur,
+// accumulées ligne par ligne dans la sortie
+float fade(float t)
+{
+    return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+uint32_t hashCorner(int x, int y, uint32_t seed)
+{
+    uint32_t h = (static_cast<uint32_t>(x) * 0x8DA6B343u) ^ (static_cast<uint32_t>(y) * 0xD8163841u) ^ seed;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+float gradientDot(uint32_t h, float dx, float dy)
+{
+    const float sx = (h & 1u) ? -dx : dx;
+    const float sy = (h & 2u) ? -dy : dy;
+    const float axis = (h & 8u) ? sy : sx;
+    return (h & 4u) ? axis : sx + sy;
+}
+
+int floorToInt(float v)
+{
+    const int t = static_cast<int>(v);
+    return t - (v < static_cast<float>(t) ? 1 : 0);
+}
+
+void referenceFBm(const PerlinNoiseTerrain::NoiseParams& p, int x0, int z0, int width, int height, float* out)
+{
+    std::fill(out, out + static_cast<std::size_t>(width) * height, 0.0f);
+
+    for (int z = 0; z < height; ++z) {
+        float* row = out + static_cast<std::size_t>(z) * width;
+        const float yf = static_cast<float>(z0 + z) * p.frequency;
+
+        float amplitude = 1.0f;
+        float freq = 1.0f;
+
+        for (int o = 0; o < p.octaves; ++o) {
+            const uint32_t seed = p.seed + 0x9E3779B9u * static_cast<uint32_t>(o);
+            const float y = yf * freq;
+            const int cy = floorToInt(y);
+            const float fy = y - static_cast<float>(cy);
+            const float v = fade(fy);
+
+            for (int x = 0; x < width; ++x) {
+                const float sx = static_cast<float>(x0 + x) * p.frequency * freq;
+                const int cx = floorToInt(sx);
+                const float fx = sx - static_cast<float>(cx);
+
+                const float tl = gradientDot(hashCorner(cx,     cy,     seed), fx,     fy);
+                const float tr = gradientDot(hashCorner(cx + 1, cy,     seed), fx - 1, fy);
+                const float bl = gradientDot(hashCorner(cx,     cy + 1, seed), fx,     fy - 1);
+                const float br = gradientDot(hashCorner(cx + 1, cy + 1, seed), fx - 1, fy - 1);
+
+                const float u = fade(fx);
+                const float top = tl + u * (tr - tl);
+                const float bottom = bl + u * (br - bl);
+
+                row[x] += amplitude * (top + v * (bottom - top));
+            }
+
+            amplitude *= p.persistence;
+            freq *= p.lacunarity;
+        }
+    }
+}
+} // namespace
+
+TEST(PerlinNoiseTest, TemplatedFBmMatchesPreviousPipeline) {
+    PerlinNoiseTerrain::NoiseParams params;
+    params.frequency = 0.013f;
+
+    const int windows[][4] = {{0, 0, 100, 30}, {-77, -41, 33, 20}, {1000, 5000, 16, 8}};
+    for (uint32_t seed : {1u, 0xDEADBEEFu}) {
+        for (int octaves : {1, 6}) {
+            params.seed = seed;
+            params.octaves = octaves;
+            params.lacunarity = (octaves == 1) ? 2.0f : 2.13f;
+            params.persistence = (octaves == 1) ? 0.5f : 0.47f;
+
+            for (const auto& window : windows) {
+                const std::size_t count = static_cast<std::size_t>(window[2]) * window[3];
+                std::vector<float> expected(count);
+                std::vector<float> actual(count);
+
+                referenceFBm(params, window[0], window[1], window[2], window[3], expected.data());
+                PerlinNoiseTerrain::GenerateRegion(params, window[0], window[1], window[2], window[3], actual.data());
+
+                // Mêmes opérations dans le même ordre ; seule une contraction
+                // en FMA différente peut toucher le dernier bit
+                for (std::size_t i = 0; i < count; ++i)
+                    ASSERT_NEAR(actual[i], expected[i], 1e-5f)
+                        << "graine " << seed << ", " << octaves << " octaves, fenêtre (" << window[0] << ", " << window[1] << "), cellule " << i;
+            }
+        }
+    }
+}
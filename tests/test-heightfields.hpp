@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Grilles analytiques partagées par les tests et les benchmarks.
+ */
+namespace testdata
+{
+/**
+ * @brief Relief base + amplitude * sin(freqX * x) * cos(freqZ * z)
+ *
+ * L'ondulation oblique (ripple) et la pente le long de x (tilt) sont
+ * nulles par défaut. Chaque appelant règle la raideur par rapport au
+ * talus qu'il teste.
+ */
+struct Waves
+{
+    float base = 100.0f;
+    float amplitude = 50.0f;
+    float freqX = 0.23f;
+    float freqZ = 0.19f;
+    float ripple = 0.0f;  /**< Amplitude de sin(rippleX * x + rippleZ * z) */
+    float rippleX = 0.0f;
+    float rippleZ = 0.0f;
+    float tilt = 0.0f;    /**< Pente ajoutée par cellule le long de x */
+};
+
+/**
+ * @brief Grille width x height, ligne par ligne (data[z * width + x])
+ */
+inline std::vector<float> makeWaves(int width, int height, const Waves &shape)
+{
+    std::vector<float> data(static_cast<std::size_t>(width) * height);
+
+    #pragma omp parallel for schedule(static)
+    for (int z = 0; z < height; ++z)
+        for (int x = 0; x < width; ++x)
+            data[static_cast<std::size_t>(z) * width + x] =
+                shape.base + shape.amplitude * std::sin(shape.freqX * x) * std::cos(shape.freqZ * z)
+                + shape.ripple * std::sin(shape.rippleX * x + shape.rippleZ * z) + shape.tilt * x;
+
+    return data;
+}
+} // namespace testdata
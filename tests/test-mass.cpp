@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include "MassReduction.hpp"
+#include "ThermalErosion.hpp"
+#include "test-heightfields.hpp"
+
+#include <cmath>
+#include <vector>
+
+TEST(MassReductionTest, MatchesLongDoubleSum) {
+    // Grandes valeurs et petites variations mêlées, taille non multiple d'un bloc
+    std::vector<float> data(3 * MassReduction::BLOCK_SIZE + 517);
+    long double reference = 0.0L;
+
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = (i % 7 == 0) ? 1.0e6f : 1.0e-3f * static_cast<float>(i % 13);
+        reference += data[i];
+    }
+
+    EXPECT_NEAR(MassReduction::sum(data), static_cast<double>(reference), 1e-6);
+    EXPECT_DOUBLE_EQ(MassReduction::sum(data.data(), 0), 0.0);
+}
+
+TEST(MassReductionTest, KernelBalanceMatchesGridMass) {
+    const int width = 97;
+    const int height = 83;
+    std::vector<float> data = testdata::makeWaves(width, height, {100.0f, 40.0f, 0.2f, 0.15f});
+
+    const double massBefore = MassReduction::sum(data);
+
+    ThermalErosion erosion;
+    erosion.loadGrid(&data, width, height);
+    erosion.setTalusAngle(25.f);
+    erosion.setTransferRate(0.1f);
+
+    ASSERT_GT(erosion.stepBlockedParallelPureTwoPhase(), 0);
+
+    const ThermalErosion::StepResidual &residual = erosion.getLastResidual();
+    EXPECT_GT(residual.movedMass, 0.0);
+    EXPECT_GT(residual.maxSlopeExcess, 0.0f);
+
+    // Le bilan du noyau suffit à vérifier la conservation sans relire la grille
+    EXPECT_LT(std::abs(residual.massBalance()), 1e-6 * residual.movedMass);
+    EXPECT_NEAR(MassReduction::sum(data), massBefore + residual.massBalance(), 1e-6 * massBefore);
+}
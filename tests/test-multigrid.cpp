@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "MassReduction.hpp"
+#include "MultigridThermalErosion.hpp"
+#include "test-heightfields.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// Relief plus raide que le talus à toutes les échelles
+std::vector<float> makeSteepTerrain(int width, int height)
+{
+    return testdata::makeWaves(width, height, {120.0f, 60.0f, 0.07f, 0.05f, 20.0f, 0.31f, 0.17f});
+}
+
+// Plus grande différence centre - voisin (8 voisins) sur les cellules intérieures
+float maxInnerDrop(const std::vector<float>& data, int width, int height)
+{
+    float drop = 0.0f;
+    for (int i = 1; i < height - 1; ++i)
+        for (int j = 1; j < width - 1; ++j)
+            for (int di = -1; di <= 1; ++di)
+                for (int dj = -1; dj <= 1; ++dj)
+                    drop = std::max(drop, data[i * width + j] - data[(i + di) * width + j + dj]);
+    return drop;
+}
+} // namespace
+
+TEST(MultigridThermalErosionTest, ConservesMassOnOddDimensions) {
+    const int width = 203;
+    const int height = 157;
+    std::vector<float> data = makeSteepTerrain(width, height);
+    const double massBefore = MassReduction::sum(data);
+
+    MultigridThermalErosion solver;
+    solver.setTalusAngle(25.f);
+    solver.setTransferRate(0.1f);
+
+    MultigridSettings settings;
+    settings.fineSteps = 20;
+    solver.solve(data, width, height, settings);
+
+    EXPECT_LT(std::abs(MassReduction::sum(data) - massBefore) / massBefore, 1e-4);
+
+    for (float h : data)
+        EXPECT_GE(h, 0.0f);
+}
+
+TEST(MultigridThermalErosionTest, KeepsHeightsBelowZero) {
+    const int width = 203;
+    const int height = 157;
+    const float plateau = -50.0f;
+    std::vector<float> data = makeSteepTerrain(width, height);
+
+    // Tiers gauche : plateau sous 0
+    for (int i = 0; i < height; ++i)
+        for (int j = 0; j < width / 3; ++j)
+            data[i * width + j] = plateau;
+
+    const double massBefore = MassReduction::sum(data);
+
+    MultigridThermalErosion solver;
+    solver.setTalusAngle(25.f);
+    solver.setTransferRate(0.1f);
+
+    MultigridSettings settings;
+    settings.fineSteps = 20;
+    solver.solve(data, width, height, settings);
+
+    EXPECT_LT(std::abs(MassReduction::sum(data) - massBefore) / massBefore, 1e-4);
+
+    // Le plateau se comble en partie ; bornées à 0, ses cellules ne
+    // pourraient que remonter au-dessus
+    double plateauSum = 0.0;
+    for (int i = 0; i < height; ++i)
+        for (int j = 0; j < width / 6; ++j)
+            plateauSum += data[i * width + j];
+    EXPECT_LT(plateauSum / (height * (width / 6)), 0.0);
+}
+
+TEST(MultigridThermalErosionTest, RelaxesSlopesToTalus) {
+    const int width = 129;
+    const int height = 129;
+    std::vector<float> data = makeSteepTerrain(width, height);
+
+    MultigridThermalErosion solver;
+    solver.setTalusAngle(25.f);
+    solver.setTransferRate(0.1f);
+
+    const int changes = solver.solve(data, width, height, MultigridSettings());
+    const float talus = std::tan(25.f * 3.14159265f / 180.0f);
+
+    EXPECT_EQ(changes, 0);
+    EXPECT_LE(maxInnerDrop(data, width, height), talus);
+    ASSERT_GT(solver.getLevelSteps().size(), 1u);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "Patch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+struct PatchPlacement
+{
+    unsigned int patchX;
+    unsigned int patchZ;
+    int originX;
+    int originZ;
+    float textureExtent;
+};
+
+/**
+ * Émetteur de sommets d'avant la version sans branchement : un clamp et un
+ * test de jupe par sommet. Sert de référence au générateur actuel.
+ */
+std::vector<Vertex> referenceLodVertices(const PatchPlacement &placement, int step, float xzFactor,
+                                         const std::vector<float> &heights, unsigned int width, unsigned int height)
+{
+    const float skirtDepth = 0.01f;
+    const float textureScale = 20.0f;
+
+    const int basePatchX = static_cast<int>(placement.patchX) * PATCH_SIZE;
+    const int basePatchZ = static_cast<int>(placement.patchZ) * PATCH_SIZE;
+
+    const float invXzFactor = 1.0f / xzFactor;
+    const float texWidth = (placement.textureExtent > 0.f) ? placement.textureExtent : static_cast<float>(width);
+    const float texHeight = (placement.textureExtent > 0.f) ? placement.textureExtent : static_cast<float>(height);
+    const float invTexWidth = textureScale / (texWidth * xzFactor);
+    const float invTexHeight = textureScale / (texHeight * xzFactor);
+
+    const int innerResolution = (PATCH_SIZE / step) + 1;
+    const int resolution = innerResolution + 2;
+
+    std::vector<Vertex> vertices(resolution * resolution);
+    int outIndex = 0;
+
+    for (int localY = 0; localY < resolution; ++localY)
+    {
+        const int innerY = localY - 1;
+        const int clampedY = std::clamp(innerY, 0, innerResolution - 1);
+
+        const int worldZ = placement.originZ + basePatchZ + innerY * step;
+        int sampleZ = basePatchZ + clampedY * step;
+        sampleZ = std::clamp(sampleZ, 0, static_cast<int>(height) - 1);
+
+        const bool borderY = (localY == 0 || localY == resolution - 1);
+
+        for (int localX = 0; localX < resolution; ++localX, ++outIndex)
+        {
+            const int innerX = localX - 1;
+            const int clampedX = std::clamp(innerX, 0, innerResolution - 1);
+
+            const int worldX = placement.originX + basePatchX + innerX * step;
+            int sampleX = basePatchX + clampedX * step;
+            sampleX = std::clamp(sampleX, 0, static_cast<int>(width) - 1);
+
+            float heightValue = heights[sampleZ * static_cast<int>(width) + sampleX];
+
+            if (borderY || localX == 0 || localX == resolution - 1)
+            {
+                heightValue -= skirtDepth;
+            }
+
+            vertices[outIndex].position =
+                glm::vec3(static_cast<float>(worldX) * invXzFactor, heightValue, static_cast<float>(worldZ) * invXzFactor);
+
+            vertices[outIndex].texture =
+                glm::vec2(static_cast<float>(worldX) * invTexWidth, static_cast<float>(worldZ) * invTexHeight);
+        }
+    }
+
+    return vertices;
+}
+
+std::vector<float> makeHeights(unsigned int width, unsigned int height)
+{
+    std::vector<float> heights(static_cast<std::size_t>(width) * height);
+    for (unsigned int z = 0; z < height; ++z)
+        for (unsigned int x = 0; x < width; ++x)
+            heights[z * width + x] = std::sin(0.37f * x) * std::cos(0.21f * z) + 0.01f * (x + 3 * z);
+    return heights;
+}
+
+void expectSameVertices(const PatchPlacement &placement, float xzFactor, unsigned int width, unsigned int height)
+{
+    std::vector<float> heights = makeHeights(width, height);
+
+    Patch patch;
+    patch.setPatch(placement.patchX, placement.patchZ, xzFactor, 1, 1, nullptr);
+    patch.setWorldOrigin(placement.originX, placement.originZ, placement.textureExtent);
+    patch.generateLodVertices(heights, width, height);
+
+    const int steps[5] = {1, 2, 4, 8, 16};
+    for (int lod = 0; lod < 5; ++lod)
+    {
+        const std::vector<Vertex> expected =
+            referenceLodVertices(placement, steps[lod], xzFactor, heights, width, height);
+        const std::vector<Vertex> &actual = patch.getLodVertices(lod);
+
+        ASSERT_EQ(actual.size(), expected.size()) << "LOD " << lod;
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            // Mêmes opérations dans le même ordre : égalité exacte
+            ASSERT_EQ(actual[i].position.x, expected[i].position.x) << "LOD " << lod << ", sommet " << i;
+            ASSERT_EQ(actual[i].position.y, expected[i].position.y) << "LOD " << lod << ", sommet " << i;
+            ASSERT_EQ(actual[i].position.z, expected[i].position.z) << "LOD " << lod << ", sommet " << i;
+            ASSERT_EQ(actual[i].texture.x, expected[i].texture.x) << "LOD " << lod << ", sommet " << i;
+            ASSERT_EQ(actual[i].texture.y, expected[i].texture.y) << "LOD " << lod << ", sommet " << i;
+        }
+    }
+}
+} // namespace
+
+TEST(PatchTest, VerticesMatchPreviousEmitter) {
+    // 97 x 70 cellules : 3 x 2 patches, comme Terrain::createPatches()
+    for (unsigned int patchX = 0; patchX < 3; ++patchX)
+    {
+        for (unsigned int patchZ = 0; patchZ < 2; ++patchZ)
+        {
+            SCOPED_TRACE(testing::Message() << "patch " << patchX << ", " << patchZ);
+            expectSameVertices({patchX, patchZ, 0, 0, 0.0f}, 2.0f, 97, 70);
+        }
+    }
+}
+
+TEST(PatchTest, VerticesMatchPreviousEmitterAtGridEdges) {
+    // Patch débordant de la grille : échantillons bornés sur la dernière cellule
+    expectSameVertices({1, 1, 0, 0, 0.0f}, 1.0f, 40, 45);
+
+    // Bloc de StreamingTerrain : origine monde, négative ou non, étendue de texture fixe
+    expectSameVertices({0, 0, -96, 160, 256.0f}, 3.0f, 33, 33);
+    expectSameVertices({0, 0, 4128, -4096, 256.0f}, 0.5f, 33, 33);
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "Profiler.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace
+{
+const Profiler::PhaseStats *findPhase(const std::string &name)
+{
+    for (const Profiler::PhaseStats &phase : Profiler::getPhases())
+    {
+        if (phase.name == name && !phase.gpu)
+            return &phase;
+    }
+
+    return nullptr;
+}
+} // namespace
+
+TEST(ProfilerTest, FrameSumsEventsOfAllThreads) {
+    Profiler::reset();
+
+    // 2 ms sur le thread principal, 3 ms sur un second thread
+    Profiler::record("phase", 1000000, 3000000);
+    std::thread worker([] { Profiler::record("phase", 5000000, 8000000); });
+    worker.join();
+    Profiler::recordGpu("phase", 0.5);
+
+    Profiler::endFrame();
+
+    const Profiler::PhaseStats *phase = findPhase("phase");
+    ASSERT_NE(phase, nullptr);
+    EXPECT_NEAR(phase->lastMs, 5.0, 1e-9);
+
+    // La phase GPU de même nom est comptée à part
+    ASSERT_EQ(Profiler::getPhases().size(), 2u);
+
+    // Image suivante sans événement : 0 ms, moyenne sur les deux images
+    Profiler::endFrame();
+    EXPECT_DOUBLE_EQ(phase->lastMs, 0.0);
+    EXPECT_NEAR(phase->avgMs, 2.5, 1e-9);
+    EXPECT_NEAR(phase->maxMs, 5.0, 1e-9);
+}
+
+TEST(ProfilerTest, ChromeTraceKeepsLastEventsOfRing) {
+    Profiler::reset();
+
+    const std::size_t extra = 100;
+    for (std::size_t i = 0; i < Profiler::RING_CAPACITY + extra; ++i)
+    {
+        Profiler::ScopedTimer scope("scope");
+    }
+
+    const std::string path = "test_profiler_trace.json";
+    ASSERT_TRUE(Profiler::exportChromeTrace(path));
+
+    std::ifstream in(path);
+    const std::string trace((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::remove(path.c_str());
+
+    std::size_t events = 0;
+    for (std::size_t pos = trace.find("\"ph\":\"X\""); pos != std::string::npos; pos = trace.find("\"ph\":\"X\"", pos + 1))
+        ++events;
+
+    EXPECT_EQ(events, Profiler::RING_CAPACITY);
+    EXPECT_EQ(trace.compare(0, 2, "{\""), 0);
+}
+
+TEST(ProfilerTest, FinishedThreadsHandTheirRingOver) {
+    Profiler::reset();
+
+    // Threads successifs : chacun reprend le tampon laissé par le précédent
+    const int threads = 20;
+    for (int t = 0; t < threads; ++t)
+    {
+        std::thread worker([] { Profiler::record("worker", 1000000, 2000000); });
+        worker.join();
+    }
+
+    const std::string path = "test_profiler_threads.json";
+    ASSERT_TRUE(Profiler::exportChromeTrace(path));
+
+    std::ifstream in(path);
+    const std::string trace((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::remove(path.c_str());
+
+    std::set<std::string> tids;
+    int events = 0;
+    for (std::size_t pos = trace.find("\"tid\":"); pos != std::string::npos; pos = trace.find("\"tid\":", pos + 1))
+    {
+        tids.insert(trace.substr(pos + 6, trace.find(',', pos) - pos - 6));
+        ++events;
+    }
+
+    EXPECT_EQ(events, threads);
+    EXPECT_EQ(tids.size(), 1u);
+
+    Profiler::endFrame();
+    const Profiler::PhaseStats *phase = findPhase("worker");
+    ASSERT_NE(phase, nullptr);
+    EXPECT_NEAR(phase->lastMs, threads * 1.0, 1e-9);
+}
+
+TEST(ProfilerTest, ConcurrentDrainNeverMixesEvents) {
+    Profiler::reset();
+
+    // Chaque événement dure exactement 1 ms : un événement lu pendant sa
+    // réécriture (début de l'un, fin de l'autre) casserait le compte entier
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> produced{0};
+    std::thread producer([&stop, &produced] {
+        for (uint64_t i = 0; !stop.load(std::memory_order_relaxed); ++i)
+        {
+            const uint64_t start = 1 + i * 7919;
+            Profiler::record("stress", start, start + 1000000);
+            produced.store(i + 1, std::memory_order_relaxed);
+        }
+    });
+
+    // Le tampon a fait au moins un tour avant la première lecture
+    while (produced.load(std::memory_order_relaxed) < Profiler::RING_CAPACITY)
+        std::this_thread::yield();
+
+    double total = 0.0;
+    for (int frame = 0; frame < 200; ++frame)
+    {
+        Profiler::endFrame();
+        std::this_thread::yield();
+
+        const Profiler::PhaseStats *phase = findPhase("stress");
+        if (!phase)
+            continue;
+
+        EXPECT_NEAR(phase->lastMs, std::round(phase->lastMs), 1e-6) << "image " << frame;
+        total += phase->lastMs;
+    }
+
+    stop.store(true, std::memory_order_relaxed);
+    producer.join();
+
+    EXPECT_GT(total, 0.0);
+}
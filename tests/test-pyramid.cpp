@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include "HeightPyramid.hpp"
+#include "test-heightfields.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+std::vector<float> makeHills(int width, int height)
+{
+    testdata::Waves hills{20.0f, 8.0f, 0.31f, 0.27f};
+    hills.tilt = 0.05f;
+    return testdata::makeWaves(width, height, hills);
+}
+
+float bilinear(const std::vector<float>& data, int width, int height, float x, float z)
+{
+    x = std::clamp(x, 0.0f, static_cast<float>(width - 1));
+    z = std::clamp(z, 0.0f, static_cast<float>(height - 1));
+    const int x0 = std::min(static_cast<int>(x), width - 2);
+    const int z0 = std::min(static_cast<int>(z), height - 2);
+    const float u = x - x0;
+    const float v = z - z0;
+    const float* row = &data[z0 * width + x0];
+    return (row[0] * (1 - u) + row[1] * u) * (1 - v) + (row[width] * (1 - u) + row[width + 1] * u) * v;
+}
+
+// Référence dense : pas fin puis dichotomie sur le premier passage sous la surface
+bool bruteForce(const std::vector<float>& data, int width, int height, const float o[3], const float d[3], float& tHit)
+{
+    const float step = 1e-3f;
+    float previous = -1.0f;
+    for (float t = 0.0f; t < 400.0f; t += step)
+    {
+        const float x = o[0] + d[0] * t;
+        const float z = o[2] + d[2] * t;
+        if (x < 0.0f || z < 0.0f || x > width - 1 || z > height - 1)
+        {
+            if (previous >= 0.0f)
+                return false;
+            continue;
+        }
+
+        if (o[1] + d[1] * t <= bilinear(data, width, height, x, z))
+        {
+            // Arrivée sous la surface : pas d'impact
+            if (previous < 0.0f)
+                return false;
+
+            float lo = previous, hi = t;
+            for (int i = 0; i < 30; ++i)
+            {
+                const float mid = 0.5f * (lo + hi);
+                const float y = bilinear(data, width, height, o[0] + d[0] * mid, o[2] + d[2] * mid);
+                (o[1] + d[1] * mid <= y ? hi : lo) = mid;
+            }
+            tHit = hi;
+            return true;
+        }
+        previous = t;
+    }
+    return false;
+}
+} // namespace
+
+TEST(HeightPyramidTest, RaycastMatchesDenseMarch) {
+    const int width = 53;
+    const int height = 38;
+    const std::vector<float> data = makeHills(width, height);
+
+    HeightPyramid pyramid;
+    pyramid.build(data.data(), width, height);
+    ASSERT_TRUE(pyramid.matches(width, height));
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    int hits = 0;
+    for (int ray = 0; ray < 200; ++ray)
+    {
+        // Origine au-dessus ou à côté de la grille, rayon descendant
+        const float o[3] = {-10.0f + 73.0f * unit(rng), 35.0f + 10.0f * unit(rng), -10.0f + 58.0f * unit(rng)};
+        const float d[3] = {unit(rng) - 0.5f, -0.2f - unit(rng), unit(rng) - 0.5f};
+
+        float expected = 0.0f;
+        float actual = 0.0f;
+        const bool expectedHit = bruteForce(data, width, height, o, d, expected);
+        const bool actualHit = pyramid.raycast(data.data(), o, d, actual);
+
+        ASSERT_EQ(actualHit, expectedHit) << "rayon " << ray;
+        if (expectedHit)
+        {
+            ++hits;
+            EXPECT_NEAR(actual, expected, 2e-3f) << "rayon " << ray;
+        }
+    }
+    EXPECT_GT(hits, 50);
+}
+
+TEST(HeightPyramidTest, HorizontalAndVerticalRays) {
+    const int width = 40;
+    const int height = 40;
+    std::vector<float> data(width * height, 5.0f);
+    data[20 * width + 30] = 15.0f;
+
+    HeightPyramid pyramid;
+    pyramid.build(data.data(), width, height);
+
+    float t = 0.0f;
+    const float down[3] = {0.0f, -1.0f, 0.0f};
+    const float above[3] = {12.5f, 50.0f, 7.25f};
+    ASSERT_TRUE(pyramid.raycast(data.data(), above, down, t));
+    EXPECT_NEAR(t, 45.0f, 1e-4f);
+
+    // À hauteur 10, seul le pic en (30, 20) dépasse
+    const float along[3] = {1.0f, 0.0f, 0.0f};
+    const float low[3] = {0.0f, 10.0f, 20.0f};
+    ASSERT_TRUE(pyramid.raycast(data.data(), low, along, t));
+    EXPECT_NEAR(t, 29.5f, 1e-4f);
+
+    const float high[3] = {0.0f, 16.0f, 20.0f};
+    EXPECT_FALSE(pyramid.raycast(data.data(), high, along, t));
+
+    const float up[3] = {0.0f, 1.0f, 0.0f};
+    EXPECT_FALSE(pyramid.raycast(data.data(), above, up, t));
+}
+
+TEST(HeightPyramidTest, TileUpdateMatchesRebuild) {
+    const int width = 97;
+    const int height = 70;
+    const int tileSize = 32;
+    const int tilesZ = height / tileSize;
+    std::vector<float> data = makeHills(width, height);
+
+    HeightPyramid pyramid;
+    pyramid.build(data.data(), width, height);
+
+    // Creuse un cratère dans la tuile (1, 1) et monte un pic sur le bord gauche de la tuile (2, 0)
+    for (int z = 40; z < 50; ++z)
+        for (int x = 40; x < 50; ++x)
+            data[z * width + x] -= 30.0f;
+    data[16 * width + 64] += 50.0f;
+
+    pyramid.updateTiles(data.data(), {1 * tilesZ + 1, 2 * tilesZ + 0}, tileSize, tilesZ);
+
+    HeightPyramid rebuilt;
+    rebuilt.build(data.data(), width, height);
+
+    EXPECT_FLOAT_EQ(pyramid.rootBounds().lo, rebuilt.rootBounds().lo);
+    EXPECT_FLOAT_EQ(pyramid.rootBounds().hi, rebuilt.rootBounds().hi);
+
+    // Rayon horizontal qui aborde le pic par le quad voisin, hors de la tuile mise à jour
+    const float side[3] = {0.0f, 40.0f, 16.0f};
+    const float along[3] = {1.0f, 0.0f, 0.0f};
+    float tSide = 0.0f;
+    float tSideRebuilt = 0.0f;
+    ASSERT_TRUE(rebuilt.raycast(data.data(), side, along, tSideRebuilt));
+    ASSERT_TRUE(pyramid.raycast(data.data(), side, along, tSide));
+    EXPECT_EQ(tSide, tSideRebuilt);
+    EXPECT_LT(tSide, 64.0f);
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int ray = 0; ray < 200; ++ray)
+    {
+        const float o[3] = {97.0f * unit(rng), 90.0f, 70.0f * unit(rng)};
+        const float d[3] = {unit(rng) - 0.5f, -1.0f, unit(rng) - 0.5f};
+
+        float tUpdated = 0.0f;
+        float tRebuilt = 0.0f;
+        const bool hitUpdated = pyramid.raycast(data.data(), o, d, tUpdated);
+        ASSERT_EQ(hitUpdated, rebuilt.raycast(data.data(), o, d, tRebuilt)) << "rayon " << ray;
+        if (hitUpdated) {
+            EXPECT_EQ(tUpdated, tRebuilt) << "rayon " << ray;
+        }
+    }
+}
+
+TEST(HeightPyramidTest, TileUpdateOnGridShorterThanATile) {
+    // Moins de 32 lignes : Terrain passe mHeight / PATCH_SIZE = 0 tuile en z
+    const int width = 70;
+    const int height = 20;
+    std::vector<float> data = makeHills(width, height);
+
+    HeightPyramid pyramid;
+    pyramid.build(data.data(), width, height);
+
+    data[10 * width + 50] += 100.0f;
+    pyramid.updateTiles(data.data(), {1}, 32, height / 32);
+
+    HeightPyramid rebuilt;
+    rebuilt.build(data.data(), width, height);
+    EXPECT_FLOAT_EQ(pyramid.rootBounds().hi, rebuilt.rootBounds().hi);
+
+    // Le pic n'est visible que si la tuile (1, 0) a été recalculée
+    const float side[3] = {0.0f, 60.0f, 10.0f};
+    const float along[3] = {1.0f, 0.0f, 0.0f};
+    float t = 0.0f;
+    ASSERT_TRUE(pyramid.raycast(data.data(), side, along, t));
+    EXPECT_GT(t, 49.0f);
+    EXPECT_LT(t, 50.0f);
+}
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include "CounterRng.hpp"
+
+#include <vector>
+
+TEST(CounterRngTest, SameKeyGivesSameValue) {
+    const uint64_t stream = CounterRng::stream(CounterRng::MidpointOffsets, 64);
+
+    EXPECT_EQ(CounterRng::next(42, stream, 1000), CounterRng::next(42, stream, 1000));
+    EXPECT_NE(CounterRng::next(42, stream, 1000), CounterRng::next(43, stream, 1000));
+    EXPECT_NE(CounterRng::next(42, stream, 1000), CounterRng::next(42, stream + 1, 1000));
+    EXPECT_NE(CounterRng::next(42, stream, 1000), CounterRng::next(42, stream, 1001));
+}
+
+TEST(CounterRngTest, UniformValuesStayInRange) {
+    const uint64_t stream = CounterRng::stream(CounterRng::FaultLines, 3);
+    double sum = 0.0;
+    const int n = 100000;
+
+    for (int i = 0; i < n; ++i) {
+        const float u = CounterRng::uniform(7, stream, i);
+        ASSERT_GE(u, 0.0f);
+        ASSERT_LT(u, 1.0f);
+        sum += u;
+
+        const uint32_t k = CounterRng::below(7, stream, i, 13);
+        ASSERT_LT(k, 13u);
+    }
+
+    EXPECT_NEAR(sum / n, 0.5, 0.01);
+}
+
+TEST(CounterRngTest, ParallelFillMatchesSerialFill) {
+    const uint64_t stream = CounterRng::stream(CounterRng::MidpointOffsets, 2);
+    const int n = 1 << 16;
+    std::vector<float> serial(n);
+    std::vector<float> parallel(n);
+
+    for (int i = 0; i < n; ++i)
+        serial[i] = CounterRng::uniform(1, stream, i, -1.0f, 1.0f);
+
+    #pragma omp parallel for schedule(dynamic, 97)
+    for (int i = n - 1; i >= 0; --i)
+        parallel[i] = CounterRng::uniform(1, stream, i, -1.0f, 1.0f);
+
+    EXPECT_EQ(serial, parallel);
+}
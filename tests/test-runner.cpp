@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
 
+// Implémentation de stb_image pour les sources du terrain liées aux tests
+// (TiledHeightField::convertFromPng, Terrain::loadTerrain)
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.hpp"
+
 /**
  * @brief Main function for the GoogleTest framework.
  */
@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include "ErosionCheckpointer.hpp"
+#include "LzCompressor.hpp"
+#include "TerrainSnapshot.hpp"
+#include "test-heightfields.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<float> makeRamp(int width, int height)
+{
+    return testdata::makeWaves(width, height, {100.0f, 50.0f, 0.05f, 0.03f});
+}
+} // namespace
+
+TEST(LzCompressorTest, RoundTripRestoresInput) {
+    std::vector<uint8_t> input(100000);
+    for (std::size_t i = 0; i < input.size(); ++i)
+        input[i] = static_cast<uint8_t>((i / 7) % 13);
+
+    std::vector<uint8_t> compressed(LzCompressor::maxCompressedSize(input.size()));
+    const std::size_t size = LzCompressor::compress(input.data(), input.size(), compressed.data());
+    EXPECT_LT(size, input.size());
+
+    std::vector<uint8_t> output(input.size());
+    ASSERT_TRUE(LzCompressor::decompress(compressed.data(), size, output.data(), output.size()));
+    EXPECT_EQ(input, output);
+}
+
+TEST(LzCompressorTest, RejectsTruncatedInput) {
+    std::vector<uint8_t> input(4096, 42);
+    std::vector<uint8_t> compressed(LzCompressor::maxCompressedSize(input.size()));
+    const std::size_t size = LzCompressor::compress(input.data(), input.size(), compressed.data());
+
+    std::vector<uint8_t> output(input.size());
+    EXPECT_FALSE(LzCompressor::decompress(compressed.data(), size / 2, output.data(), output.size()));
+}
+
+TEST(TerrainSnapshotTest, HalfConversionIsExactOnRepresentableValues) {
+    const float values[] = {0.0f, 1.0f, -2.5f, 255.0f, 0.125f, 65504.0f};
+    for (float v : values)
+        EXPECT_EQ(TerrainSnapshot::halfToFloat(TerrainSnapshot::floatToHalf(v)), v);
+}
+
+TEST(TerrainSnapshotTest, FloatSnapshotRoundTripIsBitExact) {
+    const int width = 700, height = 500;
+    const std::vector<float> data = makeRamp(width, height);
+    const std::string path = "test_snapshot_float.ersnap";
+
+    SnapshotMetadata meta;
+    meta.generator = 3;
+    meta.params[0] = 0.005f;
+    meta.erosionSteps = 1234;
+
+    for (bool compress : {false, true}) {
+        SnapshotOptions options;
+        options.compress = compress;
+        ASSERT_TRUE(TerrainSnapshot::save(path, data.data(), width, height, meta, options));
+
+        std::vector<float> restored;
+        int w = 0, h = 0;
+        SnapshotMetadata readMeta;
+        ASSERT_TRUE(TerrainSnapshot::load(path, restored, w, h, &readMeta));
+
+        EXPECT_EQ(w, width);
+        EXPECT_EQ(h, height);
+        EXPECT_EQ(restored, data);
+        EXPECT_EQ(readMeta.generator, 3u);
+        EXPECT_EQ(readMeta.erosionSteps, 1234u);
+        EXPECT_FLOAT_EQ(readMeta.params[0], 0.005f);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(TerrainSnapshotTest, SingleThreadSaveWritesSameFile) {
+    const int width = 700, height = 500;
+    const std::vector<float> data = makeRamp(width, height);
+    const std::string path = "test_snapshot_threads.ersnap";
+
+    auto saveAndRead = [&](int threads) {
+        SnapshotOptions options;
+        options.compress = true;
+        options.threads = threads;
+        EXPECT_TRUE(TerrainSnapshot::save(path, data.data(), width, height, SnapshotMetadata{}, options));
+
+        std::ifstream in(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+
+    // Chemin du thread d'écriture des checkpoints : même fichier, sans équipe OpenMP
+    EXPECT_EQ(saveAndRead(1), saveAndRead(0));
+
+    std::remove(path.c_str());
+}
+
+TEST(TerrainSnapshotTest, RejectsSnapshotMissingBlocks) {
+    const int width = 700, height = 500;
+    const std::vector<float> data = makeRamp(width, height);
+    const std::string path = "test_snapshot_blocks.ersnap";
+
+    ASSERT_TRUE(TerrainSnapshot::save(path, data.data(), width, height, SnapshotMetadata{}));
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    // 350 000 cellules : deux blocs. L'en-tête n'en annonce plus qu'un
+    // (blockCount, octet 40 de l'en-tête) : la fin de la grille manquerait.
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        const uint64_t blockCount = 1;
+        file.seekp(40);
+        file.write(reinterpret_cast<const char*>(&blockCount), sizeof(blockCount));
+    }
+
+    std::vector<float> restored;
+    int w = 0, h = 0;
+    EXPECT_FALSE(TerrainSnapshot::load(path, restored, w, h));
+
+    std::remove(path.c_str());
+}
+
+TEST(TerrainSnapshotTest, RejectsUnknownEncodingOrCompression) {
+    const int width = 64, height = 64;
+    const std::vector<float> data = makeRamp(width, height);
+    const std::string path = "test_snapshot_header.ersnap";
+
+    // encoding et compression : octets 12 et 16 de l'en-tête
+    for (std::streamoff field : {12, 16}) {
+        ASSERT_TRUE(TerrainSnapshot::save(path, data.data(), width, height, SnapshotMetadata{}));
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            const uint32_t unknown = 7;
+            file.seekp(field);
+            file.write(reinterpret_cast<const char*>(&unknown), sizeof(unknown));
+        }
+
+        SnapshotView view;
+        EXPECT_FALSE(view.open(path)) << "octet " << field;
+
+        std::vector<float> restored;
+        int w = 0, h = 0;
+        EXPECT_FALSE(TerrainSnapshot::load(path, restored, w, h)) << "octet " << field;
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(TerrainSnapshotTest, HalfSnapshotStaysWithinHalfPrecision) {
+    const int width = 256, height = 256;
+    const std::vector<float> data = makeRamp(width, height);
+    const std::string path = "test_snapshot_half.ersnap";
+
+    SnapshotOptions options;
+    options.encoding = SnapshotEncoding::Half;
+    options.compress = true;
+    ASSERT_TRUE(TerrainSnapshot::save(path, data.data(), width, height, SnapshotMetadata{}, options));
+
+    std::vector<float> restored;
+    int w = 0, h = 0;
+    ASSERT_TRUE(TerrainSnapshot::load(path, restored, w, h));
+
+    for (std::size_t i = 0; i < data.size(); ++i)
+        EXPECT_NEAR(restored[i], data[i], 0.125f);
+
+    std::remove(path.c_str());
+}
+
+TEST(ErosionCheckpointerTest, ResumesFromLatestCheckpointAndPrunesOlderOnes) {
+    const std::string dir = "test_checkpoints.tmp";
+    std::filesystem::remove_all(dir);
+
+    const int width = 97;
+    const int height = 61;
+    std::vector<float> data = makeRamp(width, height);
+
+    {
+        ErosionCheckpointer checkpointer(dir, 10, 2);
+        for (uint64_t step = 10; step <= 40; step += 10)
+        {
+            data[0] = static_cast<float>(step);
+
+            SnapshotMetadata metadata;
+            metadata.erosionSteps = step;
+            metadata.talusAngle = 25.f;
+
+            checkpointer.finish();
+            EXPECT_TRUE(checkpointer.checkpoint(data.data(), width, height, metadata));
+        }
+        checkpointer.finish();
+        EXPECT_EQ(checkpointer.getWritten(), 4);
+    }
+
+    std::size_t files = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(dir))
+    {
+        (void)entry;
+        ++files;
+    }
+    EXPECT_EQ(files, 2u);
+
+    ErosionCheckpointer checkpointer(dir, 10, 2);
+    std::vector<float> restored;
+    SnapshotMetadata metadata;
+    ASSERT_TRUE(checkpointer.resume(restored, width, height, metadata));
+    EXPECT_EQ(metadata.erosionSteps, 40u);
+    EXPECT_EQ(metadata.talusAngle, 25.f);
+    EXPECT_EQ(restored, data);
+    EXPECT_FALSE(checkpointer.isDue(45));
+    EXPECT_TRUE(checkpointer.isDue(50));
+
+    std::filesystem::remove_all(dir);
+}
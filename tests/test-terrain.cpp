@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "FaultFormationTerrain.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+// 97 x 70 cellules : 3 x 2 patches, les dernières lignes et colonnes hors patch
+void makeTerrain(FaultFormationTerrain &terrain)
+{
+    terrain.setSeed(3);
+    terrain.CreateFaultFormation(97, 70, 60, 20.0f, 120.0f);
+}
+
+bool insideDisk(const BrushStroke &stroke, int x, int z)
+{
+    const float dx = x - stroke.centerX;
+    const float dz = z - stroke.centerZ;
+    return dx * dx + dz * dz <= stroke.radius * stroke.radius;
+}
+
+bool insideRect(const CellRect &rect, int x, int z)
+{
+    return x >= rect.xMin && x <= rect.xMax && z >= rect.zMin && z <= rect.zMax;
+}
+
+std::vector<int> sorted(std::vector<int> values)
+{
+    std::sort(values.begin(), values.end());
+    return values;
+}
+} // namespace
+
+TEST(TerrainBrushTest, EachModeChangesOnlyItsFootprint) {
+    const BrushMode modes[] = {BrushMode::Raise, BrushMode::Lower, BrushMode::Smooth, BrushMode::Flatten};
+
+    for (BrushMode mode : modes) {
+        FaultFormationTerrain terrain;
+        makeTerrain(terrain);
+        const std::vector<float> before = *terrain.getData();
+
+        BrushStroke stroke;
+        stroke.mode = mode;
+        stroke.centerX = 40.3f;
+        stroke.centerZ = 30.7f;
+        stroke.radius = 9.0f;
+        stroke.strength = (mode == BrushMode::Raise || mode == BrushMode::Lower) ? 5.0f : 0.8f;
+        stroke.targetHeight = 70.0f;
+
+        const CellRect rect = terrain.applyBrush(stroke);
+        EXPECT_EQ(rect.xMin, 32);
+        EXPECT_EQ(rect.xMax, 49);
+        EXPECT_EQ(rect.zMin, 22);
+        EXPECT_EQ(rect.zMax, 39);
+
+        const std::vector<float> &after = *terrain.getData();
+        int changed = 0;
+
+        for (int z = 0; z < 70; ++z) {
+            for (int x = 0; x < 97; ++x) {
+                const float h0 = before[z * 97 + x];
+                const float h1 = after[z * 97 + x];
+
+                if (!insideDisk(stroke, x, z) || !insideRect(rect, x, z)) {
+                    ASSERT_EQ(h1, h0) << "mode " << static_cast<int>(mode) << ", cellule " << x << "," << z;
+                    continue;
+                }
+
+                changed += (h1 != h0);
+                switch (mode) {
+                case BrushMode::Raise:
+                    ASSERT_GE(h1, h0);
+                    break;
+                case BrushMode::Lower:
+                    ASSERT_LE(h1, h0);
+                    break;
+                case BrushMode::Smooth:
+                    ASSERT_GE(h1, std::min(h0, 20.0f));
+                    ASSERT_LE(h1, std::max(h0, 120.0f));
+                    break;
+                case BrushMode::Flatten:
+                    ASSERT_LE(std::abs(h1 - stroke.targetHeight), std::abs(h0 - stroke.targetHeight) + 1e-4f);
+                    break;
+                }
+            }
+        }
+
+        EXPECT_GT(changed, 0) << "mode " << static_cast<int>(mode);
+    }
+}
+
+TEST(TerrainBrushTest, LowerStopsAtMinimumHeight) {
+    FaultFormationTerrain terrain;
+    makeTerrain(terrain);
+
+    BrushStroke stroke;
+    stroke.mode = BrushMode::Lower;
+    stroke.centerX = 1.0f;
+    stroke.centerZ = 68.0f;
+    stroke.radius = 6.0f;
+    stroke.falloff = 0.0f;
+    stroke.strength = 1000.0f;
+
+    // Disque coupé par les bords du terrain
+    const CellRect rect = terrain.applyBrush(stroke);
+    EXPECT_EQ(rect.xMin, 0);
+    EXPECT_EQ(rect.zMax, 69);
+
+    const std::vector<float> &data = *terrain.getData();
+    for (int z = rect.zMin; z <= rect.zMax; ++z) {
+        for (int x = rect.xMin; x <= rect.xMax; ++x) {
+            // Sans atténuation, le poids vaut 1 partout sauf sur le cercle
+            const float dx = x - stroke.centerX;
+            const float dz = z - stroke.centerZ;
+            if (dx * dx + dz * dz < stroke.radius * stroke.radius) {
+                ASSERT_EQ(data[z * 97 + x], terrain.getMinHeight()) << "cellule " << x << "," << z;
+            }
+        }
+    }
+
+    EXPECT_GE(*std::min_element(data.begin(), data.end()), terrain.getMinHeight());
+}
+
+TEST(TerrainPatchesTest, PatchesInRectAtGridEdges) {
+    FaultFormationTerrain terrain;
+    makeTerrain(terrain);
+    ASSERT_EQ(terrain.getPatches().size(), 6u);
+
+    // Indice px * nbPatchZ + pz, le patch p lit les cellules [32p, 32p + 32]
+    EXPECT_EQ(sorted(terrain.patchesInRect({0, 0, 0, 0})), (std::vector<int>{0}));
+    EXPECT_EQ(sorted(terrain.patchesInRect({32, 32, 5, 5})), (std::vector<int>{0, 2}));
+    EXPECT_EQ(sorted(terrain.patchesInRect({31, 31, 32, 32})), (std::vector<int>{0, 1}));
+    EXPECT_EQ(sorted(terrain.patchesInRect({64, 96, 64, 69})), (std::vector<int>{3, 5}));
+    EXPECT_EQ(sorted(terrain.patchesInRect({0, 96, 0, 69})), (std::vector<int>{0, 1, 2, 3, 4, 5}));
+
+    // La dernière colonne (96) est lue par le dernier patch, les lignes 65 à
+    // 69 ne sont lues par aucun
+    EXPECT_EQ(sorted(terrain.patchesInRect({65, 96, 0, 0})), (std::vector<int>{4}));
+    EXPECT_TRUE(terrain.patchesInRect({0, 10, 65, 69}).empty());
+    EXPECT_TRUE(terrain.patchesInRect(CellRect{5, 4, 0, 0}).empty());
+}
@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+#include "DirtyTileSet.hpp"
+#include "MassReduction.hpp"
+#include "ThermalErosion.hpp"
+#include "test-heightfields.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+std::vector<float> makeSlopedTerrain(int width, int height)
+{
+    return testdata::makeWaves(width, height, {100.0f, 50.0f, 0.23f, 0.19f});
+}
+
+void configure(ThermalErosion& erosion, std::vector<float>& data, int width, int height)
+{
+    erosion.loadGrid(&data, width, height);
+    erosion.useEightNeighbors();
+    erosion.setTalusAngle(25.f);
+    erosion.setTransferRate(0.1f);
+}
+} // namespace
+
+TEST(ThermalErosionChunkTest, ChunkedIterationMatchesFullStep) {
+    const int width = 131;
+    const int height = 77;
+    std::vector<float> reference = makeSlopedTerrain(width, height);
+    std::vector<float> chunked = reference;
+
+    ThermalErosion full;
+    configure(full, reference, width, height);
+    ASSERT_GT(full.step(), 0);
+
+    ThermalErosion erosion;
+    configure(erosion, chunked, width, height);
+    while (!erosion.isIterationFinished())
+        erosion.stepChunk(1000);
+
+    // Les tranches changent l'ordre des dépôts, donc les arrondis
+    ASSERT_EQ(chunked.size(), reference.size());
+    for (std::size_t i = 0; i < reference.size(); ++i)
+        ASSERT_NEAR(chunked[i], reference[i], 1e-4f) << "cellule " << i;
+}
+
+TEST(ThermalErosionChunkTest, PartialCommitsKeepMass) {
+    const int width = 131;
+    const int height = 77;
+    std::vector<float> data = makeSlopedTerrain(width, height);
+    const double massBefore = MassReduction::sum(data);
+
+    ThermalErosion erosion;
+    configure(erosion, data, width, height);
+
+    // Deux itérations, avec une recopie partielle après chaque tranche : une
+    // ligne de halo oubliée perdrait la matière déposée hors de la tranche
+    for (int iteration = 0; iteration < 2; ++iteration)
+    {
+        do {
+            erosion.stepChunk(700);
+            erosion.commitWorkingData();
+        } while (!erosion.isIterationFinished());
+    }
+
+    EXPECT_NEAR(MassReduction::sum(data), massBefore, 1e-6 * massBefore);
+}
+
+TEST(DirtyTileSetTest, ParallelMarksAreCollectedOnce) {
+    DirtyTileSet tiles;
+    tiles.resize(300, 200, 32);
+    ASSERT_EQ(tiles.tileCount(), 9 * 6);
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < 200; ++i)
+        if (i % 64 == 1)
+            tiles.markCells(i, i, 0, 299);
+
+    std::vector<int> dirty;
+    tiles.collect(dirty);
+    EXPECT_EQ(dirty.size(), 9u * 4u);
+
+    // Déjà rendues : un second collect n'ajoute que les nouvelles tuiles
+    tiles.markTile(1);
+    tiles.collect(dirty);
+    EXPECT_EQ(dirty.size(), 9u * 4u + 1u);
+
+    tiles.clear();
+    dirty.clear();
+    tiles.collect(dirty);
+    EXPECT_TRUE(dirty.empty());
+}
+
+TEST(DirtyTileSetTest, SharedEdgeMarksBothTiles) {
+    DirtyTileSet tiles;
+    tiles.resize(96, 96, 32);
+
+    // Ligne 32 : dernier échantillon des tuiles z = 0 et premier des tuiles z = 1
+    tiles.markCells(32, 32, 40, 40);
+    std::vector<int> dirty;
+    tiles.collect(dirty);
+    EXPECT_EQ(dirty, (std::vector<int>{1 * 3 + 0, 1 * 3 + 1}));
+
+    // Coin (64, 64) : quatre tuiles
+    tiles.clear();
+    dirty.clear();
+    tiles.markCells(64, 64, 64, 64);
+    tiles.collect(dirty);
+    EXPECT_EQ(dirty, (std::vector<int>{1 * 3 + 1, 1 * 3 + 2, 2 * 3 + 1, 2 * 3 + 2}));
+
+    // La ligne 0 n'a pas de tuile précédente
+    tiles.clear();
+    dirty.clear();
+    tiles.markCells(0, 0, 0, 0);
+    tiles.collect(dirty);
+    EXPECT_EQ(dirty, (std::vector<int>{0}));
+}
+
+TEST(ThermalErosionChunkTest, DirtyPatchesCoverChangedCells) {
+    const int width = 131;
+    const int height = 77;
+    const std::vector<float> initial = makeSlopedTerrain(width, height);
+
+    using Step = int (ThermalErosion::*)();
+    const Step steps[] = {&ThermalErosion::step,
+                          &ThermalErosion::stepPureTwoPhase,
+                          &ThermalErosion::stepBlockedPureTwoPhase,
+                          &ThermalErosion::stepBlockedParallelPureTwoPhase,
+                          &ThermalErosion::stepBlockedCheckerboardPureTwoPhase,
+                          &ThermalErosion::stepCheckerboardInPlaceParallel};
+
+    for (Step stepFn : steps)
+    {
+        std::vector<float> data = initial;
+        ThermalErosion erosion;
+        configure(erosion, data, width, height);
+        erosion.useFourNeighbors();
+
+        ASSERT_GT((erosion.*stepFn)(), 0);
+
+        const std::vector<int>& dirty = erosion.getDirtyPatchIndices();
+        // Découpage de Terrain : les dernières cellules comptent dans le dernier patch
+        const int patchesX = width / PATCH_SIZE;
+        const int patchesZ = height / PATCH_SIZE;
+        std::vector<bool> listed(static_cast<std::size_t>(patchesX * patchesZ), false);
+        for (int patch : dirty) {
+            EXPECT_FALSE(listed[patch]) << "patch " << patch << " listé deux fois";
+            listed[patch] = true;
+        }
+
+        for (int i = 0; i < height; ++i)
+        {
+            for (int j = 0; j < width; ++j)
+            {
+                if (data[i * width + j] == initial[i * width + j])
+                    continue;
+
+                // Une cellule sur un bord de patch est lue par les deux patches
+                const int pz = std::min(i / PATCH_SIZE, patchesZ - 1);
+                const int px = std::min(j / PATCH_SIZE, patchesX - 1);
+                ASSERT_TRUE(listed[px * patchesZ + pz]) << "cellule " << i << "," << j;
+                if (i % PATCH_SIZE == 0 && i > 0) {
+                    ASSERT_TRUE(listed[px * patchesZ + pz - 1]) << "cellule " << i << "," << j;
+                }
+                if (j % PATCH_SIZE == 0 && j > 0) {
+                    ASSERT_TRUE(listed[(px - 1) * patchesZ + pz]) << "cellule " << i << "," << j;
+                }
+            }
+        }
+    }
+}
+
+TEST(ThermalErosionChunkTest, RelaxRegionStaysLocalAndKeepsMass) {
+    const int width = 131;
+    const int height = 77;
+    const std::vector<float> initial = makeSlopedTerrain(width, height);
+    std::vector<float> data = initial;
+    const double massBefore = MassReduction::sum(data);
+
+    ThermalErosion erosion;
+    configure(erosion, data, width, height);
+
+    const int rowMin = 20, rowMax = 40, colMin = 50, colMax = 90;
+    ASSERT_GT(erosion.relaxRegion(rowMin, rowMax, colMin, colMax, 4), 0);
+
+    // Les dépôts ne dépassent pas la zone d'une cellule
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            if (i < rowMin - 1 || i > rowMax + 1 || j < colMin - 1 || j > colMax + 1) {
+                ASSERT_EQ(data[i * width + j], initial[i * width + j]) << "cellule " << i << "," << j;
+            }
+        }
+    }
+
+    EXPECT_NEAR(MassReduction::sum(data), massBefore, 1e-6 * massBefore);
+}
+
+TEST(ThermalErosionChunkTest, EditDuringChunkedIterationIsKept) {
+    const int width = 131;
+    const int height = 77;
+    std::vector<float> data = makeSlopedTerrain(width, height);
+
+    ThermalErosion erosion;
+    configure(erosion, data, width, height);
+
+    erosion.stepChunk(2000);
+    erosion.commitWorkingData();
+
+    // Édition externe au milieu de l'itération, dans des lignes pas encore traitées
+    const int row = 60;
+    for (int j = 0; j < width; ++j)
+        data[row * width + j] += 1000.0f;
+    erosion.relaxRegion(row, row, 0, width - 1, 0);
+
+    while (!erosion.isIterationFinished())
+        erosion.stepChunk(2000);
+
+    // Sans la recopie dans l'itération, la fin du pas écraserait l'édition
+    EXPECT_GT(data[row * width + 3], 900.0f);
+}
@@ -0,0 +1,300 @@
+#include <gtest/gtest.h>
+#include "StreamingTerrain.hpp"
+#include "ThermalErosion.hpp"
+#include "TiledHeightField.hpp"
+#include "TiledThermalErosion.hpp"
+#include "test-heightfields.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Copie une grille width x height dans les tuiles du fichier (cellules hors terrain à 0)
+void writeGrid(TiledHeightField& field, const std::vector<float>& data)
+{
+    const int T = field.getTileSize();
+    std::vector<float> tile(static_cast<std::size_t>(T) * T);
+
+    for (int tz = 0; tz < field.getNbTileZ(); ++tz)
+        for (int tx = 0; tx < field.getNbTileX(); ++tx)
+        {
+            for (int z = 0; z < T; ++z)
+                for (int x = 0; x < T; ++x)
+                {
+                    const int gz = tz * T + z;
+                    const int gx = tx * T + x;
+                    tile[z * T + x] = (gz < field.getHeight() && gx < field.getWidth())
+                                    ? data[gz * field.getWidth() + gx] : 0.0f;
+                }
+            field.writeTile(tx, tz, tile.data());
+        }
+}
+
+std::vector<float> readGrid(const TiledHeightField& field)
+{
+    const int T = field.getTileSize();
+    std::vector<float> data(static_cast<std::size_t>(field.getWidth()) * field.getHeight());
+    std::vector<float> tile(static_cast<std::size_t>(T) * T);
+
+    for (int tz = 0; tz < field.getNbTileZ(); ++tz)
+        for (int tx = 0; tx < field.getNbTileX(); ++tx)
+        {
+            field.readTile(tx, tz, tile.data());
+            for (int z = 0; z < T && tz * T + z < field.getHeight(); ++z)
+                for (int x = 0; x < T && tx * T + x < field.getWidth(); ++x)
+                    data[(tz * T + z) * field.getWidth() + tx * T + x] = tile[z * T + x];
+        }
+
+    return data;
+}
+} // namespace
+
+TEST(TiledHeightFieldTest, TilesRoundTrip) {
+    const std::string path = "test_tiled_roundtrip.tiles";
+    const int width = 70;
+    const int height = 45;
+    const std::vector<float> data = testdata::makeWaves(width, height, {100.0f, 50.0f, 0.05f, 0.03f});
+
+    {
+        TiledHeightField field;
+        ASSERT_TRUE(field.create(path, width, height, 16, TileFormat::Float32, 0.0f, 200.0f));
+        EXPECT_EQ(field.getNbTileX(), 5);
+        EXPECT_EQ(field.getNbTileZ(), 3);
+        writeGrid(field, data);
+    }
+
+    TiledHeightField field;
+    ASSERT_TRUE(field.open(path, false));
+    EXPECT_EQ(field.getWidth(), width);
+    EXPECT_EQ(field.getHeight(), height);
+    EXPECT_EQ(field.getFormat(), TileFormat::Float32);
+    EXPECT_EQ(readGrid(field), data);
+
+    field.close();
+    std::remove(path.c_str());
+}
+
+TEST(TiledHeightFieldTest, QuantizedTilesStayWithinOneStep) {
+    const std::string path = "test_tiled_uint16.tiles";
+    const int width = 40;
+    const int height = 33;
+    const std::vector<float> data = testdata::makeWaves(width, height, {100.0f, 50.0f, 0.05f, 0.03f});
+
+    TiledHeightField field;
+    ASSERT_TRUE(field.create(path, width, height, 16, TileFormat::UInt16, 0.0f, 200.0f));
+    writeGrid(field, data);
+
+    const std::vector<float> restored = readGrid(field);
+    for (std::size_t i = 0; i < data.size(); ++i)
+        ASSERT_NEAR(restored[i], data[i], 200.0f / 65535.0f) << "cellule " << i;
+
+    field.close();
+    std::remove(path.c_str());
+}
+
+TEST(TiledHeightFieldTest, RejectsTruncatedFile) {
+    const std::string path = "test_tiled_truncated.tiles";
+
+    {
+        TiledHeightField field;
+        ASSERT_TRUE(field.create(path, 64, 64, 32, TileFormat::Float32, 0.0f, 1.0f));
+    }
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+    TiledHeightField field;
+    EXPECT_FALSE(field.open(path));
+    EXPECT_FALSE(field.isOpen());
+
+    std::remove(path.c_str());
+}
+
+TEST(TileCacheTest, EvictsLeastRecentlyUsedAndWritesBack) {
+    const std::string path = "test_tiled_cache.tiles";
+
+    TiledHeightField field;
+    ASSERT_TRUE(field.create(path, 64, 16, 16, TileFormat::Float32, 0.0f, 1.0f));
+
+    {
+        TileCache cache(field, 2);
+
+        float* tile = cache.acquire(0, 0);
+        ASSERT_NE(tile, nullptr);
+        tile[5] = 42.0f;
+        cache.release(0, 0, true);
+
+        ASSERT_NE(cache.acquire(1, 0), nullptr);
+        cache.release(1, 0);
+
+        // (0, 0) redevient la plus récente : (1, 0) est évincée par (2, 0)
+        ASSERT_NE(cache.acquire(0, 0), nullptr);
+        cache.release(0, 0);
+        ASSERT_NE(cache.acquire(2, 0), nullptr);
+        cache.release(2, 0);
+        EXPECT_EQ(cache.getHits(), 1);
+        EXPECT_EQ(cache.getMisses(), 3);
+
+        ASSERT_NE(cache.acquire(0, 0), nullptr);
+        cache.release(0, 0);
+        EXPECT_EQ(cache.getHits(), 2);
+
+        // (2, 0) puis (0, 0) évincées : la tuile modifiée est réécrite
+        ASSERT_NE(cache.acquire(1, 0), nullptr);
+        ASSERT_NE(cache.acquire(3, 0), nullptr);
+
+        std::vector<float> stored(16 * 16);
+        field.readTile(0, 0, stored.data());
+        EXPECT_EQ(stored[5], 42.0f);
+
+        // Les deux emplacements sont épinglés
+        EXPECT_EQ(cache.acquire(0, 0), nullptr);
+
+        cache.release(1, 0);
+        cache.release(3, 0);
+    }
+
+    field.close();
+    std::remove(path.c_str());
+}
+
+TEST(TileCacheTest, ReadRegionClampsToTerrainEdges) {
+    const std::string path = "test_tiled_region.tiles";
+    const int width = 70;
+    const int height = 45;
+    const std::vector<float> data = testdata::makeWaves(width, height, {100.0f, 50.0f, 0.05f, 0.03f});
+
+    TiledHeightField field;
+    ASSERT_TRUE(field.create(path, width, height, 16, TileFormat::Float32, 0.0f, 200.0f));
+    writeGrid(field, data);
+
+    // Un seul emplacement : chaque tuile est relâchée avant la suivante
+    TileCache cache(field, 1);
+
+    struct Region { int x0, z0, w, h; };
+    const Region regions[] = {{0, 0, width, height}, {13, 7, 33, 33}, {-20, -9, 49, 49}, {50, 30, 49, 40}};
+
+    for (const Region &r : regions) {
+        std::vector<float> out(static_cast<std::size_t>(r.w) * r.h, -1.0f);
+        ASSERT_TRUE(cache.readRegion(r.x0, r.z0, r.w, r.h, out.data()));
+
+        for (int z = 0; z < r.h; ++z)
+            for (int x = 0; x < r.w; ++x) {
+                const int cellX = std::clamp(r.x0 + x, 0, width - 1);
+                const int cellZ = std::clamp(r.z0 + z, 0, height - 1);
+                ASSERT_EQ(out[z * r.w + x], data[cellZ * width + cellX])
+                    << "region (" << r.x0 << ", " << r.z0 << "), cellule " << x << ", " << z;
+            }
+    }
+
+    field.close();
+    std::remove(path.c_str());
+}
+
+TEST(TileCacheTest, RejectsWriteBackToReadOnlyFile) {
+    const std::string path = "test_tiled_readonly.tiles";
+
+    {
+        TiledHeightField field;
+        ASSERT_TRUE(field.create(path, 32, 16, 16, TileFormat::Float32, 0.0f, 1.0f));
+    }
+
+    TiledHeightField field;
+    ASSERT_TRUE(field.open(path, false));
+    EXPECT_FALSE(field.isWritable());
+
+    {
+        TileCache cache(field, 1);
+
+        float* tile = cache.acquire(0, 0);
+        ASSERT_NE(tile, nullptr);
+        tile[5] = 42.0f;
+        cache.release(0, 0, true);
+
+        // Pages projetées en lecture seule : refusé au lieu d'un SIGSEGV
+        EXPECT_FALSE(cache.flush());
+
+        TiledThermalErosion erosion(field, cache);
+        EXPECT_EQ(erosion.step(), -1);
+    }
+
+    std::vector<float> stored(16 * 16);
+    field.readTile(0, 0, stored.data());
+    EXPECT_EQ(stored[5], 0.0f);
+
+    field.close();
+    std::remove(path.c_str());
+}
+
+TEST(TiledThermalErosionTest, MatchesInMemoryErosion) {
+    const std::string path = "test_tiled_erosion.tiles";
+    const int width = 70;
+    const int height = 45;
+    std::vector<float> reference = testdata::makeWaves(width, height, {100.0f, 50.0f, 0.23f, 0.19f});
+
+    TiledHeightField field;
+    ASSERT_TRUE(field.create(path, width, height, 16, TileFormat::Float32, 0.0f, 200.0f));
+    writeGrid(field, reference);
+
+    ThermalErosion erosion;
+    erosion.loadGrid(&reference, width, height);
+    erosion.setTalusAngle(25.f);
+    erosion.setTransferRate(0.1f);
+
+    // Cache plus petit qu'une rangée de tuiles : évictions à chaque pas
+    TileCache cache(field, 3);
+    TiledThermalErosion tiled(field, cache);
+    tiled.setTalusAngle(25.f);
+    tiled.setTransferRate(0.1f);
+
+    for (int step = 0; step < 3; ++step) {
+        const int expectedChanges = erosion.stepPureTwoPhase();
+        ASSERT_GT(expectedChanges, 0);
+        EXPECT_EQ(tiled.step(), expectedChanges) << "pas " << step;
+    }
+
+    // Même noyau, même ordre de dépôts : résultats identiques au bit près
+    EXPECT_EQ(readGrid(field), reference);
+
+    field.close();
+    std::remove(path.c_str());
+}
+
+TEST(StreamingTerrainTest, NeighbouringTilesShareEdges) {
+    // Source pure sur le plan entier, coordonnées négatives comprises
+    const StreamingTerrain::TileGenerator generator = [](int x0, int z0, int width, int height, float* out) {
+        for (int z = 0; z < height; ++z)
+            for (int x = 0; x < width; ++x)
+                out[z * width + x] = 100.0f + 50.0f * std::sin(0.23f * (x0 + x)) * std::cos(0.19f * (z0 + z));
+    };
+
+    const int N = StreamingTerrain::TILE_SAMPLES;
+    const float talus = std::tan(30.0f * 3.14159265f / 180.0f);
+
+    auto tile = [&](int tx, int tz, int steps) {
+        std::vector<float> heights;
+        StreamingTerrain::generateTile(generator, tx, tz, steps, talus, 0.5f, heights);
+        EXPECT_EQ(heights.size(), static_cast<std::size_t>(N) * N);
+        return heights;
+    };
+
+    const std::vector<float> center = tile(0, 0, 4);
+    const std::vector<float> left = tile(-1, 0, 4);
+    const std::vector<float> right = tile(1, 0, 4);
+    const std::vector<float> below = tile(0, 1, 4);
+    const std::vector<float> above = tile(0, -1, 4);
+
+    // L'érosion a bien modifié la tuile
+    EXPECT_NE(center, tile(0, 0, 0));
+
+    for (int k = 0; k < N; ++k) {
+        EXPECT_EQ(center[k * N + N - 1], right[k * N]) << "bord droit, ligne " << k;
+        EXPECT_EQ(left[k * N + N - 1], center[k * N]) << "bord gauche, ligne " << k;
+        EXPECT_EQ(center[(N - 1) * N + k], below[k]) << "bord bas, colonne " << k;
+        EXPECT_EQ(above[(N - 1) * N + k], center[k]) << "bord haut, colonne " << k;
+    }
+}
@@ -40,7 +40,8 @@ mkdir -p "$RESULT_DIR"
         echo
         echo ">>> Running: erosion test $terrain $s"
 
-        ./build/erosion test "$terrain" "$s"
+        RUN_LOG="$RESULT_DIR/run_${s}.log"
+        ./build/erosion test "$terrain" "$s" | tee "$RUN_LOG"
 
         ERROR_FILE="$RESULT_DIR/errorTimeStep${s}.csv"
 
@@ -53,6 +54,14 @@ mkdir -p "$RESULT_DIR"
         echo "$s,$error_value" >> "$ERROR_FINAL"
 
         last_step=$s
+
+        # Toutes les variantes ont convergé : les steps suivants sont identiques
+        if grep -q "Convergence atteinte" "$RUN_LOG"; then
+            rm -f "$RUN_LOG"
+            echo "Convergence atteinte au step $s, arrêt de la validation."
+            break
+        fi
+        rm -f "$RUN_LOG"
     done
     
     echo
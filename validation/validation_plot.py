@@ -8,9 +8,57 @@ from matplotlib.ticker import MultipleLocator
 from matplotlib.patches import Rectangle
 
 
+def plot_scaling(terrain):
+    """Accélération et efficacité des CSV de `terrain_app scaling`"""
+    base = f"resultat/{terrain}/scaling"
+
+    fig, axes = plt.subplots(2, 2, figsize=(14, 10))
+
+    for row, mode in enumerate(["strong", "weak"]):
+        path = f"{base}/{mode}.csv"
+        ax_speedup, ax_eff = axes[row]
+
+        if not os.path.exists(path):
+            ax_speedup.set_title(f"{mode} : {path} absent")
+            ax_eff.set_visible(False)
+            continue
+
+        df = pd.read_csv(path)
+        max_threads = df["threads"].max()
+
+        for (variant, neighborhood), group in df.groupby(["variant", "neighborhood"]):
+            label = f"{variant} ({neighborhood})"
+            ax_speedup.plot(group["threads"], group["speedup"], marker="o", linewidth=2, label=label)
+            ax_eff.plot(group["threads"], group["efficiency"], marker="o", linewidth=2, label=label)
+
+        ax_speedup.plot([1, max_threads], [1, max_threads], "k--", linewidth=1, label="idéal")
+        ax_eff.axhline(1.0, color="k", linestyle="--", linewidth=1)
+
+        pinning = f"OMP_PROC_BIND={df['proc_bind'].iloc[0]}, OMP_PLACES={df['places'].iloc[0]}"
+        for ax in (ax_speedup, ax_eff):
+            ax.set_xscale("log", base=2)
+            ax.set_xlabel("Threads")
+            ax.grid(True)
+            ax.legend()
+
+        ax_speedup.set_title(f"Passage à l'échelle {'fort' if mode == 'strong' else 'faible'} - {pinning}")
+        ax_speedup.set_ylabel("Accélération (débit / débit à 1 thread)")
+        ax_eff.set_title(f"Efficacité - {df['numa_nodes'].iloc[0]} noeud(s) NUMA")
+        ax_eff.set_ylabel("Efficacité (accélération / threads)")
+        ax_eff.set_ylim(0, 1.1)
+
+    fig.tight_layout()
+    fig.savefig(f"{base}/plot_scaling.png")
+
+
 args = sys.argv
+if len(args) == 3 and args[1] == "scaling":
+    plot_scaling(args[2])
+    sys.exit(0)
+
 if len(args) != 2:
     print(f"Usage: {args[0]} fin")
+    print(f"Usage: {args[0]} scaling <terrain>")
     sys.exit(1)
 
 fin = int(args[1])